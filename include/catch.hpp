@@ -25,12 +25,22 @@
 #include "internal/catch_test_registry.hpp"
 #include "internal/catch_capture.hpp"
 #include "internal/catch_section.hpp"
+#include "internal/catch_allocation_scope.hpp"
+#include "internal/catch_eventually.hpp"
 #include "internal/catch_generators.hpp"
+#include "internal/catch_property.hpp"
+#include "internal/catch_shared_fixture.hpp"
+#include "internal/catch_interleaving.hpp"
+#include "internal/catch_stress.hpp"
+#include "internal/catch_async.hpp"
 #include "internal/catch_interfaces_exception.h"
 #include "internal/catch_approx.hpp"
 
 #if defined( CATCH_CONFIG_MAIN ) || defined( CATCH_CONFIG_RUNNER )
 #include "catch_runner.hpp"
+#ifdef CATCH_CONFIG_COUNT_ALLOCATIONS
+#include "internal/catch_allocation_hooks.hpp"
+#endif
 #endif
 
 #ifdef CATCH_CONFIG_MAIN
@@ -57,6 +67,12 @@
 #define CHECK_THROWS_AS( expr, exceptionType ) INTERNAL_CATCH_THROWS_AS( expr, exceptionType, false, "CHECK_THROWS_AS" )
 #define CHECK_NOTHROW( expr ) INTERNAL_CATCH_NO_THROW( expr, false, "CHECK_NOTHROW" )
 
+// Evaluated until they pass, or until seconds (or, for the EVENTUALLY forms, 5 seconds) have passed
+#define REQUIRE_EVENTUALLY( expr ) INTERNAL_CATCH_EVENTUALLY( expr, 5, true, "REQUIRE_EVENTUALLY" )
+#define REQUIRE_WITHIN( expr, seconds ) INTERNAL_CATCH_EVENTUALLY( expr, seconds, true, "REQUIRE_WITHIN" )
+#define CHECK_EVENTUALLY( expr ) INTERNAL_CATCH_EVENTUALLY( expr, 5, false, "CHECK_EVENTUALLY" )
+#define CHECK_WITHIN( expr, seconds ) INTERNAL_CATCH_EVENTUALLY( expr, seconds, false, "CHECK_WITHIN" )
+
 #define INFO( msg ) INTERNAL_CATCH_MSG( msg, Catch::ResultWas::Info, false, "INFO" )
 #define WARN( msg ) INTERNAL_CATCH_MSG( msg, Catch::ResultWas::Warning, false, "WARN" )
 #define FAIL( msg ) INTERNAL_CATCH_MSG( msg, Catch::ResultWas::ExplicitFailure, true, "FAIL" )
@@ -65,8 +81,14 @@
 
 #define SECTION( name, description ) INTERNAL_CATCH_SECTION( name, description )
 
+#define REQUIRE_ALLOCATIONS( op, count ) INTERNAL_CATCH_ALLOCATIONS( op, count, true, "REQUIRE_ALLOCATIONS" )
+#define REQUIRE_NO_ALLOC INTERNAL_CATCH_ALLOCATIONS( ==, 0, true, "REQUIRE_NO_ALLOC" )
+#define CHECK_ALLOCATIONS( op, count ) INTERNAL_CATCH_ALLOCATIONS( op, count, false, "CHECK_ALLOCATIONS" )
+#define CHECK_NO_ALLOC INTERNAL_CATCH_ALLOCATIONS( ==, 0, false, "CHECK_NO_ALLOC" )
+
 #define TEST_CASE( name, description ) INTERNAL_CATCH_TESTCASE( name, description )
 #define TEST_CASE_NORETURN( name, description ) INTERNAL_CATCH_TESTCASE_NORETURN( name, description )
+#define TEST_CASE_TIMEOUT( name, description, seconds ) INTERNAL_CATCH_TESTCASE_TIMEOUT( name, description, seconds )
 #define ANON_TEST_CASE() INTERNAL_CATCH_TESTCASE( "", "Anonymous test case" )
 #define METHOD_AS_TEST_CASE( method, name, description ) CATCH_METHOD_AS_TEST_CASE( method, name, description )
 
@@ -74,6 +96,12 @@
 #define CATCH_TRANSLATE_EXCEPTION( signature ) INTERNAL_CATCH_TRANSLATE_EXCEPTION( signature )
 
 #define GENERATE( expr) INTERNAL_CATCH_GENERATE( expr )
+#define PROPERTY( name, description, Type, arg ) INTERNAL_CATCH_PROPERTY( name, description, Type, arg )
+#define STRESS_TEST_CASE( name, description, threads, iterations ) INTERNAL_CATCH_STRESS_TESTCASE( name, description, threads, iterations )
+#define STRESS_TEST_CASE_FOR( name, description, threads, seconds ) INTERNAL_CATCH_STRESS_TESTCASE_FOR( name, description, threads, seconds )
+#define INTERLEAVING_TEST_CASE( name, description, schedules ) INTERNAL_CATCH_INTERLEAVING_TESTCASE( name, description, schedules )
+#define CATCH_YIELD() Catch::Interleaving::yield()
+#define ASYNC_TEST_CASE( name, description, test ) INTERNAL_CATCH_ASYNC_TESTCASE( name, description, test )
 
 ///////////////
 // Still to be implemented
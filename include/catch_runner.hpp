@@ -15,11 +15,17 @@
 
 #include "internal/catch_hub_impl.hpp"
 
+#include "internal/catch_binary_log.hpp"
 #include "internal/catch_commandline.hpp"
 #include "internal/catch_list.hpp"
 #include "reporters/catch_reporter_basic.hpp"
 #include "reporters/catch_reporter_xml.hpp"
 #include "reporters/catch_reporter_junit.hpp"
+#include "reporters/catch_reporter_junit_streaming.hpp"
+#include "reporters/catch_reporter_async.hpp"
+#include "reporters/catch_reporter_binary.hpp"
+#include "reporters/catch_reporter_jsonl.hpp"
+#include "reporters/catch_reporter_trace.hpp"
 
 #include <fstream>
 #include <stdlib.h>
@@ -50,14 +56,25 @@ namespace Catch
             config.setStreamBuf( ofs.rdbuf() );
         }
 
+        if( config.reportAsynchronously() )
+            config.setReporter( new AsyncReporter( config, config.releaseReporter() ) );
+
+        if( !config.getLogToConvert().empty() )
+            return Convert( config );
+
         Runner runner( config );
 
         // Run test specs specified on the command line - or default to all
-        if( !config.testsSpecified() )
+        if( config.isRepeating() )
+        {
+            runner.runRepeatedly();
+        }
+        else if( !config.testsSpecified() )
         {
             config.getReporter()->StartGroup( "" );
             runner.runAll();
             config.getReporter()->EndGroup( "", runner.getSuccessCount(), runner.getFailureCount() );
+            SharedFixtures::endScope( FixtureScope::Group );
         }
         else
         {
@@ -65,7 +82,7 @@ namespace Catch
             // then just run them
             std::vector<std::string>::const_iterator it = config.getTestSpecs().begin();
             std::vector<std::string>::const_iterator itEnd = config.getTestSpecs().end();
-            for(; it != itEnd; ++it )
+            for(; it != itEnd && !runner.stopping(); ++it )
             {
                 size_t prevSuccess = runner.getSuccessCount();
                 size_t prevFail = runner.getFailureCount();
@@ -76,8 +93,11 @@ namespace Catch
 //                    std::cerr << "\n[Unable to match any test cases with: " << *it << "]" << std::endl;
                 }
                 config.getReporter()->EndGroup( *it, runner.getSuccessCount()-prevSuccess, runner.getFailureCount()-prevFail );
+                SharedFixtures::endScope( FixtureScope::Group );
             }
         }
+        // Run and worker scoped fixtures alike - this process is the first worker
+        SharedFixtures::endAll();
         return static_cast<int>( runner.getFailureCount() );
     }
 
@@ -96,11 +116,27 @@ namespace Catch
         std::cout   << exeName << " is a CATCH host application. Options are as follows:\n\n"
         << "\t-l, --list <tests | reporters> [xml]\n"
         << "\t-t, --test <testspec> [<testspec>...]\n"
-        << "\t-r, --reporter <reporter name>\n"
+        << "\t-r, --reporter <reporter name>[::out=<file name>|<%stream name>]\n"
         << "\t-o, --out <file name>|<%stream name>\n"
         << "\t-s, --success\n"
         << "\t-b, --break\n"
-        << "\t-n, --name <name>\n\n"
+        << "\t-n, --name <name>\n"
+        << "\t-j, --workers <number of worker processes>\n"
+        << "\t--order <decl | rand>\n"
+        << "\t--rng-seed <number | time>\n"
+        << "\t--async\n"
+        << "\t--capture <streams | fd>\n"
+        << "\t--output-limit <number of bytes>\n"
+        << "\t--allocations\n"
+        << "\t--resources\n"
+        << "\t--timeout <number of seconds>\n"
+        << "\t-a, --abort\n"
+        << "\t-x, --abortx <number of failures>\n"
+        << "\t--repeat <number of runs>\n"
+        << "\t--until-fail\n"
+        << "\t--schedule <seed>\n"
+        << "\t--property-seed <seed>\n"
+        << "\t--convert <binary log file name>\n\n"
         << "For more detail usage please see: https://github.com/philsquared/Catch/wiki/Command-line" << std::endl;    
     }
     
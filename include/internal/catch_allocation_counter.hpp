@@ -0,0 +1,323 @@
+/*
+ *  catch_allocation_counter.hpp
+ *  Catch
+ *
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * Counts the heap allocations made by tests. The counting is done by the
+ * global operator new and operator delete in catch_allocation_hooks.hpp,
+ * which are only compiled in if CATCH_CONFIG_COUNT_ALLOCATIONS is defined
+ * where CATCH_CONFIG_MAIN (or CATCH_CONFIG_RUNNER) is
+ */
+
+#ifndef TWOBLUECUBES_CATCH_ALLOCATION_COUNTER_HPP_INCLUDED
+#define TWOBLUECUBES_CATCH_ALLOCATION_COUNTER_HPP_INCLUDED
+
+#include "catch_resource_usage.hpp"
+#include "catch_threading.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace Catch
+{
+    // Allocations are counted into a stack of scopes - the test case, then
+    // any sections within it. Nothing here may allocate, as it is called
+    // from operator new. Only one thread's allocations are counted: the one
+    // that started the outermost scope, unless a CountingThread says
+    // otherwise. A counted block's free is counted whichever thread makes
+    // it, so the counts are kept under a spin lock
+    class AllocationCounter
+    {
+        enum { MaxDepth = 64 };
+
+        // Goes in front of every block, so operator delete knows its size
+        // and which scope counted its allocation (zero if none did)
+        union BlockHeader
+        {
+            struct Info
+            {
+                std::size_t size;
+                std::size_t serial;
+            } info;
+            long double alignLongDouble;
+            void* alignPointer;
+        };
+
+        struct Scope
+        {
+            std::size_t serial;
+            std::size_t allocations;
+            std::size_t deallocations;
+            std::size_t bytesAllocated;
+            std::size_t bytesFreed;
+            std::size_t startBytes;
+            std::size_t peakBytes;
+        };
+
+        struct State
+        {
+            bool hooksInstalled;
+            SpinLock lock;
+            std::size_t depth;
+            int paused;
+            std::size_t lastSerial;
+            ThreadId thread;
+            std::size_t allocations;
+            std::size_t deallocations;
+            std::size_t bytesAllocated;
+            std::size_t bytesFreed;
+            std::size_t liveBytes;
+            Scope scopes[MaxDepth];
+        };
+
+    public:
+        ///////////////////////////////////////////////////////////////////////
+        // Stops allocations being counted while the framework itself (rather
+        // than the test) is running
+        class Pause : NonCopyable
+        {
+        public:
+            ///////////////////////////////////////////////////////////////////
+            Pause
+            ()
+            {
+                ++state().paused;
+            }
+
+            ///////////////////////////////////////////////////////////////////
+            ~Pause
+            ()
+            {
+                --state().paused;
+            }
+        };
+
+        ///////////////////////////////////////////////////////////////////////
+        // Lets allocations be counted again, such as while a test's own code
+        // runs
+        class Resume : NonCopyable
+        {
+        public:
+            ///////////////////////////////////////////////////////////////////
+            Resume
+            ()
+            :   m_paused( state().paused )
+            {
+                state().paused = 0;
+            }
+
+            ///////////////////////////////////////////////////////////////////
+            ~Resume
+            ()
+            {
+                state().paused = m_paused;
+            }
+
+        private:
+            int m_paused;
+        };
+
+        ///////////////////////////////////////////////////////////////////////
+        // Counts the calling thread's allocations instead, while it exists -
+        // for when a test runs on a thread of its own
+        class CountingThread : NonCopyable
+        {
+        public:
+            ///////////////////////////////////////////////////////////////////
+            CountingThread
+            ()
+            :   m_previous( state().thread )
+            {
+                state().thread = getCurrentThreadId();
+            }
+
+            ///////////////////////////////////////////////////////////////////
+            ~CountingThread
+            ()
+            {
+                state().thread = m_previous;
+            }
+
+        private:
+            ThreadId m_previous;
+        };
+
+        ///////////////////////////////////////////////////////////////////////
+        static bool setHooksInstalled
+        ()
+        {
+            state().hooksInstalled = true;
+            return true;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        static bool areHooksInstalled
+        ()
+        {
+            return state().hooksInstalled;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        static void startScope
+        ()
+        {
+            State& s = state();
+            ScopedSpinLock lock( s.lock );
+            if( s.depth == 0 )
+                s.thread = getCurrentThreadId();
+            if( s.depth < MaxDepth )
+            {
+                Scope& scope = s.scopes[s.depth];
+                scope.serial = ++s.lastSerial;
+                scope.allocations = s.allocations;
+                scope.deallocations = s.deallocations;
+                scope.bytesAllocated = s.bytesAllocated;
+                scope.bytesFreed = s.bytesFreed;
+                scope.startBytes = s.liveBytes;
+                scope.peakBytes = s.liveBytes;
+            }
+            ++s.depth;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        static void endScope
+        (
+            ResourceUsage& usage
+        )
+        {
+            State& s = state();
+            ScopedSpinLock lock( s.lock );
+            if( s.depth == 0 )
+                return;
+            if( --s.depth >= MaxDepth )
+                return;
+            const Scope& scope = s.scopes[s.depth];
+            usage.allocationsCounted = true;
+            usage.allocations = s.allocations - scope.allocations;
+            usage.deallocations = s.deallocations - scope.deallocations;
+            usage.bytesAllocated = s.bytesAllocated - scope.bytesAllocated;
+            usage.bytesFreed = s.bytesFreed - scope.bytesFreed;
+            usage.peakBytes = scope.peakBytes - scope.startBytes;
+            if( s.depth > 0 )
+            {
+                Scope& parent = s.scopes[s.depth-1];
+                parent.peakBytes = (std::max)( parent.peakBytes, scope.peakBytes );
+            }
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // Counts allocations that were made elsewhere (by a worker process)
+        // as if they had been made in the current scope
+        static void add
+        (
+            const ResourceUsage& usage
+        )
+        {
+            State& s = state();
+            ScopedSpinLock lock( s.lock );
+            if( s.depth == 0 || !usage.allocationsCounted )
+                return;
+            s.allocations += usage.allocations;
+            s.deallocations += usage.deallocations;
+            s.bytesAllocated += usage.bytesAllocated;
+            s.bytesFreed += usage.bytesFreed;
+            Scope& scope = currentScope( s );
+            scope.peakBytes = (std::max)( scope.peakBytes, s.liveBytes + usage.peakBytes );
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // Returns NULL if out of memory
+        static void* allocate
+        (
+            std::size_t size
+        )
+        {
+            BlockHeader* header = static_cast<BlockHeader*>( std::malloc( sizeof( BlockHeader ) + size ) );
+            if( !header )
+                return NULL;
+
+            State& s = state();
+            header->info.size = size;
+            header->info.serial = 0;
+            if( s.paused == 0 && isSameThread( s.thread, getCurrentThreadId() ) )
+            {
+                ScopedSpinLock lock( s.lock );
+                if( s.depth == 0 )
+                    return header + 1;
+                header->info.serial = currentScope( s ).serial;
+                ++s.allocations;
+                s.bytesAllocated += size;
+                s.liveBytes += size;
+                Scope& scope = currentScope( s );
+                if( s.liveBytes > scope.peakBytes )
+                    scope.peakBytes = s.liveBytes;
+            }
+            return header + 1;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // A free is only counted by the scopes that counted the allocation -
+        // those that were open then and still are. Serials only increase,
+        // so they're the open scopes whose serial is no later than that of
+        // the scope the block was allocated in. The scopes opened since have
+        // their starting counts moved on, as if the block had gone before
+        // they started. A free while paused, or on a thread other than the
+        // counting one, is still counted, since the allocation was
+        static void deallocate
+        (
+            void* block
+        )
+        {
+            if( !block )
+                return;
+            BlockHeader* header = static_cast<BlockHeader*>( block ) - 1;
+            std::size_t serial = header->info.serial;
+            std::size_t size = header->info.size;
+            if( serial != 0 )
+            {
+                State& s = state();
+                ScopedSpinLock lock( s.lock );
+                ++s.deallocations;
+                s.bytesFreed += size;
+                s.liveBytes -= size;
+                std::size_t depth = (std::min)( s.depth, static_cast<std::size_t>( MaxDepth ) );
+                for( std::size_t i = 0; i < depth; ++i )
+                {
+                    Scope& scope = s.scopes[i];
+                    if( scope.serial <= serial )
+                        continue;
+                    ++scope.deallocations;
+                    scope.bytesFreed += size;
+                    scope.startBytes -= size;
+                    scope.peakBytes -= size;
+                }
+            }
+            std::free( header );
+        }
+
+    private:
+        ///////////////////////////////////////////////////////////////////////
+        // Zero initialised before anything runs, so safe to use from the
+        // allocation hooks however early they are called
+        static State& state
+        ()
+        {
+            static State s;
+            return s;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        static Scope& currentScope
+        (
+            State& s
+        )
+        {
+            return s.scopes[(std::min)( s.depth, static_cast<std::size_t>( MaxDepth ) ) - 1];
+        }
+    };
+
+} // end namespace Catch
+
+#endif // TWOBLUECUBES_CATCH_ALLOCATION_COUNTER_HPP_INCLUDED
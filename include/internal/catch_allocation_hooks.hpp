@@ -0,0 +1,141 @@
+/*
+ *  catch_allocation_hooks.hpp
+ *  Catch
+ *
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * Replaces the global operator new and operator delete, so AllocationCounter
+ * sees every allocation. Only included once - where CATCH_CONFIG_MAIN (or
+ * CATCH_CONFIG_RUNNER) and CATCH_CONFIG_COUNT_ALLOCATIONS are defined
+ */
+
+#ifndef TWOBLUECUBES_CATCH_ALLOCATION_HOOKS_HPP_INCLUDED
+#define TWOBLUECUBES_CATCH_ALLOCATION_HOOKS_HPP_INCLUDED
+
+#include "catch_allocation_counter.hpp"
+
+#include <new>
+
+#if __cplusplus >= 201103L
+    #define INTERNAL_CATCH_THROWS_BAD_ALLOC
+    #define INTERNAL_CATCH_NOTHROW noexcept
+#else
+    #define INTERNAL_CATCH_THROWS_BAD_ALLOC throw( std::bad_alloc )
+    #define INTERNAL_CATCH_NOTHROW throw()
+#endif
+
+namespace Catch
+{
+    namespace Detail
+    {
+        static const bool allocationHooksInstalled = AllocationCounter::setHooksInstalled();
+
+        ///////////////////////////////////////////////////////////////////////
+        // Does what the standard operator new does when out of memory
+        inline void* allocateOrThrow
+        (
+            std::size_t size
+        )
+        {
+            for(;;)
+            {
+                if( void* block = AllocationCounter::allocate( size ) )
+                    return block;
+                std::new_handler handler = std::set_new_handler( 0 );
+                std::set_new_handler( handler );
+                if( !handler )
+                    throw std::bad_alloc();
+                handler();
+            }
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        inline void* allocateOrNull
+        (
+            std::size_t size
+        )
+        {
+            try
+            {
+                return allocateOrThrow( size );
+            }
+            catch( std::bad_alloc& )
+            {
+                return NULL;
+            }
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void* operator new( std::size_t size ) INTERNAL_CATCH_THROWS_BAD_ALLOC
+{
+    return Catch::Detail::allocateOrThrow( size );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void* operator new[]( std::size_t size ) INTERNAL_CATCH_THROWS_BAD_ALLOC
+{
+    return Catch::Detail::allocateOrThrow( size );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void* operator new( std::size_t size, const std::nothrow_t& ) INTERNAL_CATCH_NOTHROW
+{
+    return Catch::Detail::allocateOrNull( size );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void* operator new[]( std::size_t size, const std::nothrow_t& ) INTERNAL_CATCH_NOTHROW
+{
+    return Catch::Detail::allocateOrNull( size );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void operator delete( void* block ) INTERNAL_CATCH_NOTHROW
+{
+    Catch::AllocationCounter::deallocate( block );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void operator delete[]( void* block ) INTERNAL_CATCH_NOTHROW
+{
+    Catch::AllocationCounter::deallocate( block );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void operator delete( void* block, const std::nothrow_t& ) INTERNAL_CATCH_NOTHROW
+{
+    Catch::AllocationCounter::deallocate( block );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void operator delete[]( void* block, const std::nothrow_t& ) INTERNAL_CATCH_NOTHROW
+{
+    Catch::AllocationCounter::deallocate( block );
+}
+
+#if defined( __cpp_sized_deallocation ) || ( defined( _MSC_VER ) && _MSC_VER >= 1900 )
+
+///////////////////////////////////////////////////////////////////////////////
+// The sized forms are what a C++14 compiler calls when it knows the size.
+// The standard ones are only required to forward to the unsized ones, so
+// these make sure of it
+void operator delete( void* block, std::size_t ) INTERNAL_CATCH_NOTHROW
+{
+    ::operator delete( block );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void operator delete[]( void* block, std::size_t ) INTERNAL_CATCH_NOTHROW
+{
+    ::operator delete[]( block );
+}
+
+#endif
+
+#undef INTERNAL_CATCH_THROWS_BAD_ALLOC
+#undef INTERNAL_CATCH_NOTHROW
+
+#endif // TWOBLUECUBES_CATCH_ALLOCATION_HOOKS_HPP_INCLUDED
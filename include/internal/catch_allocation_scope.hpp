@@ -0,0 +1,111 @@
+/*
+ *  catch_allocation_scope.hpp
+ *  Catch
+ *
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * Assertions on the number of heap allocations a block of code makes
+ */
+
+#ifndef TWOBLUECUBES_CATCH_ALLOCATION_SCOPE_HPP_INCLUDED
+#define TWOBLUECUBES_CATCH_ALLOCATION_SCOPE_HPP_INCLUDED
+
+#include "catch_allocation_counter.hpp"
+#include "catch_capture.hpp"
+
+namespace Catch
+{
+    // Counts the allocations made while the block following one of the
+    // allocation assertion macros runs. The macro is a for loop that runs
+    // the block once, then stops the count and checks it, so a REQUIRE form
+    // can throw from outside of any destructor. Everything the block does is
+    // counted - including any assertions within it - so it should hold just
+    // the code under test
+    class AllocationScope : NonCopyable
+    {
+    public:
+        ///////////////////////////////////////////////////////////////////////
+        AllocationScope
+        ()
+        :   m_isRunning( true )
+        {
+            AllocationCounter::startScope();
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // Only still running if the block threw
+        ~AllocationScope
+        ()
+        {
+            if( m_isRunning )
+                stop();
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        bool isRunning
+        ()
+        const
+        {
+            return m_isRunning;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        void stop
+        ()
+        {
+            AllocationCounter::endScope( m_usage );
+            m_isRunning = false;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        std::size_t getAllocations
+        ()
+        const
+        {
+            return m_usage.allocations;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        void accept
+        (
+            MutableResultInfo& result,
+            bool stopOnFailure
+        )
+        const
+        {
+            if( !AllocationCounter::areHooksInstalled() )
+            {
+                result.setResultType( ResultWas::ExplicitFailure );
+                result.setMessage( "allocations can't be counted unless CATCH_CONFIG_COUNT_ALLOCATIONS is defined where CATCH_CONFIG_MAIN (or CATCH_CONFIG_RUNNER) is" );
+            }
+            else if( !result.ok() )
+            {
+                std::ostringstream oss;
+                oss << m_usage.bytesAllocated << " byte(s) allocated";
+                result.setMessage( oss.str() );
+            }
+
+            ResultAction::Value action = Hub::getResultCapture().acceptExpression( result );
+            if( ResultAction::shouldDebugBreak( action ) )
+                BreakIntoDebugger();
+            if( ( action != ResultAction::None && stopOnFailure ) || ResultAction::shouldAbort( action ) )
+                throw TestFailureException();
+        }
+
+    private:
+        bool m_isRunning;
+        ResourceUsage m_usage;
+    };
+
+} // end namespace Catch
+
+///////////////////////////////////////////////////////////////////////////////
+#define INTERNAL_CATCH_ALLOCATIONS( op, count, stopOnFailure, macroName ) \
+    for( Catch::AllocationScope INTERNAL_CATCH_UNIQUE_NAME( catch_internal_AllocationScope ); \
+         INTERNAL_CATCH_UNIQUE_NAME( catch_internal_AllocationScope ).isRunning(); \
+         INTERNAL_CATCH_UNIQUE_NAME( catch_internal_AllocationScope ).stop(), \
+         INTERNAL_CATCH_UNIQUE_NAME( catch_internal_AllocationScope ).accept( Catch::ResultBuilder( __FILE__, __LINE__, macroName, "allocations " #op " " #count ) \
+            ->* INTERNAL_CATCH_UNIQUE_NAME( catch_internal_AllocationScope ).getAllocations() op count, stopOnFailure ) )
+
+#endif // TWOBLUECUBES_CATCH_ALLOCATION_SCOPE_HPP_INCLUDED
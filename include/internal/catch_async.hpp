@@ -0,0 +1,655 @@
+/*
+ *  catch_async.hpp
+ *  Catch
+ *
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * Asynchronous test cases, made of callbacks that run on an event loop they
+ * share, so that many can be waiting on timers at once
+ */
+
+#ifndef TWOBLUECUBES_CATCH_ASYNC_HPP_INCLUDED
+#define TWOBLUECUBES_CATCH_ASYNC_HPP_INCLUDED
+
+#include "catch_capture.hpp"
+#include "catch_hub.h"
+#include "catch_interfaces_exception.h"
+#include "catch_test_registry.hpp"
+#include "catch_threading.hpp"
+#include "catch_timer.hpp"
+#include "catch_watchdog.hpp"
+
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace Catch
+{
+    class AsyncTest;
+
+namespace Detail
+{
+    struct IAsyncTask
+    {
+        virtual ~IAsyncTask
+        ()
+        {}
+
+        virtual void run
+            () = 0;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Anything that can be called with no arguments: a function, a functor,
+    // or (from C++11) a lambda
+    template<typename F>
+    class AsyncTask : public IAsyncTask
+    {
+    public:
+        ///////////////////////////////////////////////////////////////////////
+        explicit AsyncTask
+        (
+            const F& f
+        )
+        :   m_f( f )
+        {
+        }
+
+    private:
+        ///////////////////////////////////////////////////////////////////////
+        virtual void run
+        ()
+        {
+            m_f();
+        }
+
+        F m_f;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Stands in for the runner while one of an asynchronous test's callbacks
+    // runs. The results are kept until the runner invokes the test, and are
+    // passed on then - so each is reported with the test it came from,
+    // whichever test the runner happened to be waiting on when it came
+    class AsyncResultCapture : public IResultCapture
+    {
+    public:
+        ///////////////////////////////////////////////////////////////////////
+        AsyncResultCapture
+        (
+            const std::string& testName,
+            const std::string& filename,
+            std::size_t line
+        )
+        :   m_testName( testName ),
+            m_filename( filename ),
+            m_line( line )
+        {
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // Stops at the first result that aborts the run, which is reported
+        // to have failed
+        bool replay
+        (
+            IResultCapture& capture
+        )
+        const
+        {
+            for( std::size_t i = 0; i < m_results.size(); ++i )
+                if( ResultAction::shouldAbort( capture.acceptExpression( m_results[i] ) ) )
+                    return false;
+            return true;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        void record
+        (
+            const std::string& message,
+            ResultWas::OfType result
+        )
+        {
+            acceptMessage( message );
+            acceptResult( result );
+        }
+
+    private: // IResultCapture
+
+        ///////////////////////////////////////////////////////////////////////
+        virtual void testEnded
+        (
+            const ResultInfo&
+        )
+        {
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // A callback can't be run again for each of its sections, so they
+        // all run
+        virtual bool sectionStarted
+        (
+            const std::string&,
+            const std::string&,
+            const std::string&,
+            std::size_t,
+            std::size_t&,
+            std::size_t&
+        )
+        {
+            return true;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        virtual void sectionEnded
+        (
+            const std::string&,
+            std::size_t,
+            std::size_t
+        )
+        {
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // The runner's stack of scoped info belongs to the test it is
+        // running, which needn't be this one
+        virtual void pushScopedInfo
+        (
+            ScopedInfo*
+        )
+        {
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        virtual void popScopedInfo
+        (
+            ScopedInfo*
+        )
+        {
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        virtual bool shouldDebugBreak
+        ()
+        const
+        {
+            return false;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        virtual ResultAction::Value acceptResult
+        (
+            bool result
+        )
+        {
+            return acceptResult( result ? ResultWas::Ok : ResultWas::ExpressionFailed );
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // Results that don't come from an assertion (such as what a callback
+        // threw) are put down to the test case itself
+        virtual ResultAction::Value acceptResult
+        (
+            ResultWas::OfType result
+        )
+        {
+            MutableResultInfo resultInfo;
+            resultInfo.setFileAndLine( m_filename, m_line );
+            resultInfo.setMessage( m_message );
+            resultInfo.setResultType( result );
+            m_message.clear();
+            return acceptExpression( resultInfo );
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        virtual ResultAction::Value acceptExpression
+        (
+            const MutableResultInfo& resultInfo
+        )
+        {
+            m_results.push_back( resultInfo );
+            return resultInfo.ok() ? ResultAction::None : ResultAction::Failed;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        virtual void acceptMessage
+        (
+            const std::string& msg
+        )
+        {
+            m_message = msg;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        virtual std::string getCurrentTestName
+        ()
+        const
+        {
+            return m_testName;
+        }
+
+    private:
+        std::string m_testName;
+        std::string m_filename;
+        std::size_t m_line;
+        std::string m_message;
+        std::vector<MutableResultInfo> m_results;
+    };
+
+} // end namespace Detail
+
+    ///////////////////////////////////////////////////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // The one event loop in each process, which runs the callbacks of every
+    // asynchronous test that has started, in the order they're due (and, when
+    // due together, the order they were scheduled). It only runs while the
+    // runner is waiting on one of those tests to finish
+    class EventLoop
+    {
+        struct Entry
+        {
+            AsyncTest* test;
+            Detail::IAsyncTask* task;
+        };
+
+        // When the entry is due, and the order it was scheduled in
+        typedef std::pair<uint64_t, std::size_t> Key;
+        typedef std::map<Key, Entry> Entries;
+
+        struct State
+        {
+            ///////////////////////////////////////////////////////////////////
+            State
+            ()
+            :   scheduled( 0 )
+            {
+            }
+
+            Entries entries;
+            std::size_t scheduled;
+        };
+
+    public:
+        ///////////////////////////////////////////////////////////////////////
+        static void schedule
+        (
+            AsyncTest& test,
+            unsigned int delayMilliseconds,
+            Detail::IAsyncTask* task
+        )
+        {
+            State& s = state();
+            Entry entry = { &test, task };
+            uint64_t due = getCurrentMicroseconds() + static_cast<uint64_t>( delayMilliseconds ) * 1000;
+            s.entries.insert( std::make_pair( Key( due, s.scheduled++ ), entry ) );
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // Drops whatever the test still has scheduled
+        static void cancel
+        (
+            AsyncTest& test
+        )
+        {
+            Entries& entries = state().entries;
+            for( Entries::iterator it = entries.begin(); it != entries.end(); )
+            {
+                if( it->second.test == &test )
+                {
+                    delete it->second.task;
+                    entries.erase( it++ );
+                }
+                else
+                {
+                    ++it;
+                }
+            }
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // Runs callbacks - of this test, and any others that have started -
+        // until this test has nothing left scheduled. False if the timeout
+        // (in milliseconds, 0 for none) runs out first
+        static bool runUntilFinished
+        (
+            const AsyncTest& test,
+            unsigned int timeout
+        );
+
+    private:
+        ///////////////////////////////////////////////////////////////////////
+        static bool isScheduled
+        (
+            const AsyncTest& test
+        )
+        {
+            const Entries& entries = state().entries;
+            for( Entries::const_iterator it = entries.begin(); it != entries.end(); ++it )
+                if( it->second.test == &test )
+                    return true;
+            return false;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        static State& state
+        ()
+        {
+            static State s;
+            return s;
+        }
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // What an ASYNC_TEST_CASE is given, to schedule its callbacks with. The
+    // test has finished once it has no callbacks left to run, or when one of
+    // them fails a REQUIRE or throws
+    class AsyncTest : NonCopyable
+    {
+    public:
+        typedef void (*Function)( AsyncTest& );
+
+        ///////////////////////////////////////////////////////////////////////
+        ~AsyncTest
+        ()
+        {
+            EventLoop::cancel( *this );
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        template<typename F>
+        void post
+        (
+            const F& f
+        )
+        {
+            after( 0, f );
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        template<typename F>
+        void after
+        (
+            unsigned int milliseconds,
+            const F& f
+        )
+        {
+            if( !m_hasFailed )
+                EventLoop::schedule( *this, milliseconds, new Detail::AsyncTask<F>( f ) );
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        const std::string& getName
+        ()
+        const
+        {
+            return m_name;
+        }
+
+    private:
+        friend class EventLoop;
+        friend class AsyncTestCase;
+
+        ///////////////////////////////////////////////////////////////////////
+        class Start
+        {
+        public:
+            ///////////////////////////////////////////////////////////////////
+            Start
+            (
+                Function function,
+                AsyncTest& test
+            )
+            :   m_function( function ),
+                m_test( &test )
+            {
+            }
+
+            ///////////////////////////////////////////////////////////////////
+            void operator()
+            ()
+            const
+            {
+                m_function( *m_test );
+            }
+
+        private:
+            Function m_function;
+            AsyncTest* m_test;
+        };
+
+        ///////////////////////////////////////////////////////////////////////
+        // Starts by running the test function itself, as its first callback
+        AsyncTest
+        (
+            const std::string& name,
+            const std::string& filename,
+            std::size_t line,
+            Function function
+        )
+        :   m_name( name ),
+            m_capture( name, filename, line ),
+            m_hasFailed( false )
+        {
+            post( Start( function, *this ) );
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // Called by the event loop, which has already taken the task off its
+        // schedule
+        void run
+        (
+            Detail::IAsyncTask& task
+        )
+        {
+            IResultCapture* prevResultCapture = &Hub::getResultCapture();
+            Hub::setResultCapture( &m_capture );
+            try
+            {
+                task.run();
+            }
+            catch( TestFailureException& )
+            {
+                // A REQUIRE failed, so the test ends here
+                fail();
+            }
+            catch( std::exception& ex )
+            {
+                m_capture.record( ex.what(), ResultWas::ThrewException );
+                fail();
+            }
+            catch( std::string& msg )
+            {
+                m_capture.record( msg, ResultWas::ThrewException );
+                fail();
+            }
+            catch( const char* msg )
+            {
+                m_capture.record( msg, ResultWas::ThrewException );
+                fail();
+            }
+            catch(...)
+            {
+                m_capture.record( Hub::getExceptionTranslatorRegistry().translateActiveException(), ResultWas::ThrewException );
+                fail();
+            }
+            Hub::setResultCapture( prevResultCapture );
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        void fail
+        ()
+        {
+            m_hasFailed = true;
+            EventLoop::cancel( *this );
+        }
+
+        std::string m_name;
+        Detail::AsyncResultCapture m_capture;
+        bool m_hasFailed;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    inline bool EventLoop::runUntilFinished
+    (
+        const AsyncTest& test,
+        unsigned int timeout
+    )
+    {
+        Entries& entries = state().entries;
+        Timer timer;
+        while( isScheduled( test ) )
+        {
+            uint64_t now = getCurrentMicroseconds();
+            Entries::iterator next = entries.begin();
+            if( next->first.first > now )
+            {
+                uint64_t wait = ( next->first.first - now + 999 ) / 1000;
+                if( timeout != 0 )
+                {
+                    if( timer.getElapsedMilliseconds() >= timeout )
+                        return false;
+                    unsigned int remaining = timeout - timer.getElapsedMilliseconds();
+                    if( wait > remaining )
+                        wait = remaining;
+                }
+                sleepFor( static_cast<unsigned int>( wait ) );
+                continue;
+            }
+            if( timeout != 0 && timer.getElapsedMilliseconds() >= timeout )
+                return false;
+
+            // Off the schedule before it runs, so it can cancel its test
+            Entry entry = next->second;
+            entries.erase( next );
+            std::auto_ptr<Detail::IAsyncTask> task( entry.task );
+            entry.test->run( *task );
+        }
+        return true;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // The runner starts the asynchronous test cases it's about to run before
+    // it runs any of them, so they share the event loop for as long as the
+    // runner is waiting on any one of them. Each is reported when the runner
+    // gets to it, and times how long the runner waited on it - which may be
+    // less than it took, if it made progress while an earlier test was
+    // waited on
+    class AsyncTestCase : public ITestCase
+    {
+    public:
+        ///////////////////////////////////////////////////////////////////////
+        AsyncTestCase
+        (
+            const std::string& name,
+            const std::string& filename,
+            std::size_t line,
+            AsyncTest::Function function
+        )
+        :   m_name( name ),
+            m_filename( filename ),
+            m_line( line ),
+            m_function( function ),
+            m_test( NULL )
+        {
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        ~AsyncTestCase
+        ()
+        {
+            delete m_test;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        virtual void start
+        ()
+        const
+        {
+            delete m_test;
+            m_test = new AsyncTest( m_name, m_filename, m_line, m_function );
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        virtual void invoke
+        ()
+        const
+        {
+            if( m_test == NULL )
+                start();
+            std::auto_ptr<AsyncTest> test( m_test );
+            m_test = NULL;
+
+            unsigned int timeout = Watchdog::getTimeout();
+            bool finished = EventLoop::runUntilFinished( *test, timeout );
+            if( !test->m_capture.replay( Hub::getResultCapture() ) )
+                throw TestFailureException();
+            if( !finished )
+                throw TestTimedOut( timeout, true, "" );
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        virtual ITestCase* clone
+        ()
+        const
+        {
+            return new AsyncTestCase( m_name, m_filename, m_line, m_function );
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        virtual bool operator ==
+        (
+            const ITestCase& other
+        )
+        const
+        {
+            const AsyncTestCase* atOther = dynamic_cast<const AsyncTestCase*>( &other );
+            return atOther && m_function == atOther->m_function;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        virtual bool operator <
+        (
+            const ITestCase& other
+        )
+        const
+        {
+            const AsyncTestCase* atOther = dynamic_cast<const AsyncTestCase*>( &other );
+            return atOther && m_function < atOther->m_function;
+        }
+
+    private:
+        ///////////////////////////////////////////////////////////////////////
+        AsyncTestCase
+        (
+            const AsyncTestCase&
+        );
+
+        ///////////////////////////////////////////////////////////////////////
+        void operator =
+        (
+            const AsyncTestCase&
+        );
+
+        std::string m_name;
+        std::string m_filename;
+        std::size_t m_line;
+        AsyncTest::Function m_function;
+        mutable AsyncTest* m_test;
+    };
+
+} // end namespace Catch
+
+///////////////////////////////////////////////////////////////////////////////
+#define INTERNAL_CATCH_ASYNC_TESTCASE( Name, Desc, arg ) \
+    static void INTERNAL_CATCH_UNIQUE_NAME( catch_internal_AsyncTestFunction )( Catch::AsyncTest& arg ); \
+    namespace{ Catch::AutoReg INTERNAL_CATCH_UNIQUE_NAME( autoRegistrar )( new Catch::AsyncTestCase( Name, __FILE__, __LINE__, &INTERNAL_CATCH_UNIQUE_NAME( catch_internal_AsyncTestFunction ) ), Name, Desc, __FILE__, __LINE__ ); }\
+    static void INTERNAL_CATCH_UNIQUE_NAME( catch_internal_AsyncTestFunction )( Catch::AsyncTest& arg )
+
+#endif // TWOBLUECUBES_CATCH_ASYNC_HPP_INCLUDED
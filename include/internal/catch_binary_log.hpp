@@ -0,0 +1,612 @@
+/*
+ *  catch_binary_log.hpp
+ *  Catch
+ *
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * The binary log written by the binary reporter, and --convert, which renders
+ * it with any other reporter
+ */
+
+#ifndef TWOBLUECUBES_CATCH_BINARY_LOG_HPP_INCLUDED
+#define TWOBLUECUBES_CATCH_BINARY_LOG_HPP_INCLUDED
+
+#include "catch_config.hpp"
+#include "catch_debugger.hpp"
+#include "catch_interfaces_reporter.h"
+#include "catch_resultinfo.hpp"
+#include "catch_test_case_info.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#ifndef CATCH_PLATFORM_WINDOWS
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace Catch
+{
+    // A log is a Header followed by Records. Every record has the same layout:
+    // a type, ten 32-bit fields and the time since testing started. Strings
+    // are interned - a String record (fields: id, length, followed by the
+    // bytes padded to a multiple of four) appears before the first record that
+    // refers to the id. Id 0 is the empty string. Other records use the fields:
+    //
+    //  StartGroup:     name
+    //  EndGroup:       name, succeeded, failed
+    //  StartSection:   name, description
+    //  EndSection:     name, succeeded, failed, stdout, stderr
+    //  EndGeneratorCombination: combination, succeeded, failed, worker
+    //  StartTestCase:  name, description, filename, line
+    //  EndTestCase:    name, succeeded, failed, stdout, stderr
+    //  Result:         macro name, filename, line, expression, lhs, rhs,
+    //                  operator, message, result type, is not
+    //  EndTesting:     succeeded, failed
+    //  Usage:          allocations, deallocations, bytes allocated (low,
+    //                  high), bytes freed (low, high), peak bytes (low, high)
+    //  ProcessUsage:   peak RSS growth (low, high), minor faults, major
+    //                  faults, voluntary context switches, involuntary
+    //                  context switches, file descriptors leaked
+    //  TestCaseRepeated: name, runs, min microseconds (low, high), median
+    //                  microseconds (low, high), max microseconds (low, high)
+    //  FailedRepetition: repetition, rng seed
+    //
+    // A Usage record is written just before the EndSection,
+    // EndGeneratorCombination or EndTestCase it belongs to, if allocations
+    // were counted, and a ProcessUsage record
+    // just before the EndTestCase, if process usage was recorded. A
+    // FailedRepetition record is written, for each repetition a test case
+    // failed in, just before its TestCaseRepeated.
+    //
+    // The first word of each record is written last, so a log cut short (by a
+    // crash) ends in a zero word, or the end of the file
+    struct BinaryLog
+    {
+        enum RecordType
+        {
+            EndOfLog = 0,
+            String,
+            StartTesting,
+            EndTesting,
+            StartGroup,
+            EndGroup,
+            StartSection,
+            EndSection,
+            StartTestCase,
+            EndTestCase,
+            Result,
+            Usage,
+            ProcessUsage,
+            EndGeneratorCombination,
+            TestCaseRepeated,
+            FailedRepetition
+        };
+
+        enum
+        {
+            Version = 1,
+            ByteOrderMark = 0x01020304,
+            FieldCount = 10
+        };
+
+        struct Header
+        {
+            char magic[8];
+            uint32_t version;
+            uint32_t byteOrderMark;
+            uint32_t rngSeed;
+            uint32_t reserved;
+        };
+
+        struct Record
+        {
+            uint32_t type;
+            uint32_t fields[FieldCount];
+            uint32_t microsecondsLow;
+            uint32_t microsecondsHigh;
+        };
+
+        ///////////////////////////////////////////////////////////////////////
+        static const char* getMagic
+        ()
+        {
+            return "CATCHLOG";
+        }
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // A file that is appended to through a shared memory mapping, so anything
+    // appended is in the OS's hands straight away and survives the process
+    // crashing. Not (yet) implemented on Windows, where open() fails
+    class MappedFile : NonCopyable
+    {
+        enum { InitialCapacity = 1024 * 1024 };
+
+    public:
+        ///////////////////////////////////////////////////////////////////////
+        MappedFile
+        ()
+        :   m_fd( -1 ),
+            m_data( NULL ),
+            m_size( 0 ),
+            m_capacity( 0 )
+        {
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        ~MappedFile
+        ()
+        {
+            close();
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        bool open
+        (
+            const std::string& filename
+        )
+        {
+            close();
+#ifdef CATCH_PLATFORM_WINDOWS
+            (void)filename;
+            return false;
+#else
+            m_fd = ::open( filename.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644 );
+            if( m_fd == -1 )
+                return false;
+            if( !reserve( InitialCapacity ) )
+            {
+                close();
+                return false;
+            }
+            return true;
+#endif
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        bool isOpen
+        ()
+        const
+        {
+            return m_data != NULL;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // The first word of data is copied last (see BinaryLog)
+        void append
+        (
+            const char* data,
+            std::size_t size
+        )
+        {
+            if( !isOpen() || ( m_size + size > m_capacity && !reserve( m_size + size ) ) )
+                return;
+            std::memcpy( m_data + m_size + sizeof( uint32_t ), data + sizeof( uint32_t ), size - sizeof( uint32_t ) );
+            std::memcpy( m_data + m_size, data, sizeof( uint32_t ) );
+            m_size += size;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // Trims the file to what was appended
+        void close
+        ()
+        {
+#ifndef CATCH_PLATFORM_WINDOWS
+            if( m_data )
+                munmap( m_data, m_capacity );
+            if( m_fd != -1 )
+            {
+                // If this fails readers still stop at the zeros after the end
+                int result = ftruncate( m_fd, static_cast<off_t>( m_size ) );
+                (void)result;
+                ::close( m_fd );
+            }
+#endif
+            m_fd = -1;
+            m_data = NULL;
+            m_size = 0;
+            m_capacity = 0;
+        }
+
+    private:
+        ///////////////////////////////////////////////////////////////////////
+        bool reserve
+        (
+            std::size_t required
+        )
+        {
+#ifdef CATCH_PLATFORM_WINDOWS
+            (void)required;
+            return false;
+#else
+            std::size_t capacity = m_capacity == 0 ? static_cast<std::size_t>( InitialCapacity ) : m_capacity;
+            while( capacity < required )
+                capacity *= 2;
+            if( m_data )
+                munmap( m_data, m_capacity );
+            m_data = NULL;
+            if( ftruncate( m_fd, static_cast<off_t>( capacity ) ) != 0 )
+                return false;
+            void* data = mmap( NULL, capacity, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0 );
+            if( data == MAP_FAILED )
+                return false;
+            m_data = static_cast<char*>( data );
+            m_capacity = capacity;
+            return true;
+#endif
+        }
+
+        int m_fd;
+        char* m_data;
+        std::size_t m_size;
+        std::size_t m_capacity;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Raises the events in a log on a reporter. If the log was cut short, the
+    // test case that was running is failed and everything still open is ended,
+    // so the report is complete
+    class BinaryLogReader
+    {
+        struct Scope
+        {
+            BinaryLog::RecordType type;
+            std::string name;
+            std::size_t succeeded;
+            std::size_t failed;
+        };
+
+    public:
+        ///////////////////////////////////////////////////////////////////////
+        explicit BinaryLogReader
+        (
+            const std::string& data
+        )
+        :   m_data( data ),
+            m_pos( sizeof( BinaryLog::Header ) ),
+            m_succeeded( 0 ),
+            m_failed( 0 ),
+            m_isComplete( false )
+        {
+            std::memset( &m_header, 0, sizeof( m_header ) );
+            if( m_data.size() >= sizeof( m_header ) )
+                std::memcpy( &m_header, m_data.data(), sizeof( m_header ) );
+            m_strings.push_back( "" );
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        std::string getError
+        ()
+        const
+        {
+            if( std::memcmp( m_header.magic, BinaryLog::getMagic(), sizeof( m_header.magic ) ) != 0 )
+                return "Not a binary log";
+            if( m_header.version != BinaryLog::Version )
+                return "Unsupported binary log version";
+            if( m_header.byteOrderMark != BinaryLog::ByteOrderMark )
+                return "Binary log was written on a machine with a different byte order";
+            return "";
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        unsigned int getRngSeed
+        ()
+        const
+        {
+            return m_header.rngSeed;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        bool isComplete
+        ()
+        const
+        {
+            return m_isComplete;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // Returns the number of failures
+        std::size_t replay
+        (
+            IReporter& reporter
+        )
+        {
+            BinaryLog::Record record;
+            while( readRecord( record ) )
+                raise( reporter, record );
+            if( !m_isComplete )
+                endEverything( reporter );
+            return m_failed;
+        }
+
+    private:
+        ///////////////////////////////////////////////////////////////////////
+        bool readRecord
+        (
+            BinaryLog::Record& record
+        )
+        {
+            if( m_isComplete || m_data.size() - m_pos < sizeof( record ) )
+                return false;
+            std::memcpy( &record, m_data.data() + m_pos, sizeof( record ) );
+            m_pos += sizeof( record );
+            if( record.type != BinaryLog::String )
+                return record.type != BinaryLog::EndOfLog;
+
+            std::size_t length = record.fields[1];
+            std::size_t paddedLength = ( length + 3 ) & ~static_cast<std::size_t>( 3 );
+            if( record.fields[0] != m_strings.size() || m_data.size() - m_pos < paddedLength )
+                return false;
+            m_strings.push_back( m_data.substr( m_pos, length ) );
+            m_pos += paddedLength;
+            return true;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        void raise
+        (
+            IReporter& reporter,
+            const BinaryLog::Record& record
+        )
+        {
+            const uint32_t* fields = record.fields;
+            switch( record.type )
+            {
+                case BinaryLog::StartTesting:
+                    reporter.StartTesting();
+                    openScope( record, "" );
+                    break;
+                case BinaryLog::EndTesting:
+                    closeScope();
+                    reporter.EndTesting( fields[0], fields[1] );
+                    m_succeeded = fields[0];
+                    m_failed = fields[1];
+                    m_isComplete = true;
+                    break;
+                case BinaryLog::StartGroup:
+                    reporter.StartGroup( getString( fields[0] ) );
+                    openScope( record, getString( fields[0] ) );
+                    break;
+                case BinaryLog::EndGroup:
+                    closeScope();
+                    reporter.EndGroup( getString( fields[0] ), fields[1], fields[2] );
+                    break;
+                case BinaryLog::StartSection:
+                    reporter.StartSection( getString( fields[0] ), getString( fields[1] ) );
+                    openScope( record, getString( fields[0] ) );
+                    break;
+                case BinaryLog::EndSection:
+                    closeScope();
+                    reporter.EndSection( getString( fields[0] ), fields[1], fields[2], getString( fields[3] ), getString( fields[4] ), m_usage );
+                    m_usage = ResourceUsage();
+                    break;
+                case BinaryLog::EndGeneratorCombination:
+                    m_usage.worker = fields[3];
+                    reporter.EndGeneratorCombination( fields[0], fields[1], fields[2], m_usage );
+                    m_usage = ResourceUsage();
+                    break;
+                case BinaryLog::StartTestCase:
+                    m_testInfo = TestCaseInfo( NULL,
+                                               getString( fields[0] ).c_str(),
+                                               getString( fields[1] ).c_str(),
+                                               getString( fields[2] ).c_str(),
+                                               fields[3] );
+                    reporter.StartTestCase( m_testInfo );
+                    openScope( record, getString( fields[0] ) );
+                    break;
+                case BinaryLog::EndTestCase:
+                    closeScope();
+                    reporter.EndTestCase( m_testInfo, fields[1], fields[2], getString( fields[3] ), getString( fields[4] ), m_usage );
+                    m_usage = ResourceUsage();
+                    break;
+                case BinaryLog::Usage:
+                    m_usage.allocationsCounted = true;
+                    m_usage.allocations = fields[0];
+                    m_usage.deallocations = fields[1];
+                    m_usage.bytesAllocated = toSize( fields[2], fields[3] );
+                    m_usage.bytesFreed = toSize( fields[4], fields[5] );
+                    m_usage.peakBytes = toSize( fields[6], fields[7] );
+                    break;
+                case BinaryLog::ProcessUsage:
+                    m_usage.processUsageRecorded = true;
+                    m_usage.peakRssGrowth = toSize( fields[0], fields[1] );
+                    m_usage.minorFaults = fields[2];
+                    m_usage.majorFaults = fields[3];
+                    m_usage.voluntarySwitches = fields[4];
+                    m_usage.involuntarySwitches = fields[5];
+                    m_usage.descriptorsLeaked = fields[6];
+                    break;
+                case BinaryLog::FailedRepetition:
+                    m_repeatStats.addFailure( fields[0], fields[1] );
+                    break;
+                case BinaryLog::TestCaseRepeated:
+                    m_repeatStats.name = getString( fields[0] );
+                    m_repeatStats.runs = fields[1];
+                    m_repeatStats.minMicroseconds = toSize( fields[2], fields[3] );
+                    m_repeatStats.medianMicroseconds = toSize( fields[4], fields[5] );
+                    m_repeatStats.maxMicroseconds = toSize( fields[6], fields[7] );
+                    reporter.TestCaseRepeated( m_repeatStats );
+                    m_repeatStats = RepeatStats();
+                    break;
+                case BinaryLog::Result:
+                    {
+                        ResultInfo result;
+                        result.m_macroName = getString( fields[0] );
+                        result.m_filename = getString( fields[1] );
+                        result.m_line = fields[2];
+                        result.m_expr = getString( fields[3] );
+                        result.m_lhs = getString( fields[4] );
+                        result.m_rhs = getString( fields[5] );
+                        result.m_op = getString( fields[6] );
+                        result.m_message = getString( fields[7] );
+                        result.m_result = static_cast<ResultWas::OfType>( fields[8] );
+                        result.m_isNot = fields[9] != 0;
+                        countResult( result );
+                        reporter.Result( result );
+                    }
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        void endEverything
+        (
+            IReporter& reporter
+        )
+        {
+            if( m_scopes.empty() )
+                reporter.StartTesting();
+
+            for( std::size_t i = 0; i < m_scopes.size(); ++i )
+            {
+                if( m_scopes[i].type == BinaryLog::StartTestCase )
+                {
+                    ResultInfo result( "", ResultWas::ExplicitFailure, false,
+                                       m_testInfo.getFilename().c_str(), m_testInfo.getLine(), "",
+                                       "The log ends here - the run stopped (or crashed) during this test case" );
+                    countResult( result );
+                    reporter.Result( result );
+                    break;
+                }
+            }
+
+            while( !m_scopes.empty() )
+            {
+                Scope scope = m_scopes.back();
+                closeScope();
+                std::size_t succeeded = m_succeeded - scope.succeeded;
+                std::size_t failed = m_failed - scope.failed;
+                switch( scope.type )
+                {
+                    case BinaryLog::StartGroup:
+                        reporter.EndGroup( scope.name, succeeded, failed );
+                        break;
+                    case BinaryLog::StartSection:
+                        reporter.EndSection( scope.name, succeeded, failed, "", "", ResourceUsage() );
+                        break;
+                    case BinaryLog::StartTestCase:
+                        reporter.EndTestCase( m_testInfo, succeeded, failed, "", "", ResourceUsage() );
+                        break;
+                    default:
+                        break;
+                }
+            }
+            reporter.EndTesting( m_succeeded, m_failed );
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        void openScope
+        (
+            const BinaryLog::Record& record,
+            const std::string& name
+        )
+        {
+            Scope scope;
+            scope.type = static_cast<BinaryLog::RecordType>( record.type );
+            scope.name = name;
+            scope.succeeded = m_succeeded;
+            scope.failed = m_failed;
+            m_scopes.push_back( scope );
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        void closeScope
+        ()
+        {
+            if( !m_scopes.empty() )
+                m_scopes.pop_back();
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        void countResult
+        (
+            const ResultInfo& result
+        )
+        {
+            if( result.getResultType() == ResultWas::Ok )
+                m_succeeded++;
+            else if( !result.ok() )
+                m_failed++;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        const std::string& getString
+        (
+            uint32_t id
+        )
+        const
+        {
+            return id < m_strings.size() ? m_strings[id] : m_strings[0];
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        static std::size_t toSize
+        (
+            uint32_t low,
+            uint32_t high
+        )
+        {
+            return static_cast<std::size_t>( ( static_cast<uint64_t>( high ) << 32 ) | low );
+        }
+
+        const std::string& m_data;
+        std::size_t m_pos;
+        BinaryLog::Header m_header;
+        std::vector<std::string> m_strings;
+        std::vector<Scope> m_scopes;
+        TestCaseInfo m_testInfo;
+        ResourceUsage m_usage;
+        RepeatStats m_repeatStats;
+        std::size_t m_succeeded;
+        std::size_t m_failed;
+        bool m_isComplete;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    inline int Convert
+    (
+        Config& config
+    )
+    {
+        std::ifstream ifs( config.getLogToConvert().c_str(), std::ios_base::in | std::ios_base::binary );
+        if( ifs.fail() )
+        {
+            std::cerr << "Unable to open file: '" << config.getLogToConvert() << "'" << std::endl;
+            return (std::numeric_limits<int>::max)();
+        }
+        std::string data( ( std::istreambuf_iterator<char>( ifs ) ), std::istreambuf_iterator<char>() );
+
+        BinaryLogReader reader( data );
+        if( !reader.getError().empty() )
+        {
+            std::cerr << reader.getError() << ": '" << config.getLogToConvert() << "'" << std::endl;
+            return (std::numeric_limits<int>::max)();
+        }
+        // So the report shows how the run can be reproduced
+        if( reader.getRngSeed() != 0 )
+        {
+            config.setOrder( Config::Order::Randomised );
+            config.setRngSeed( reader.getRngSeed() );
+        }
+        return static_cast<int>( reader.replay( *config.getReporter() ) );
+    }
+
+} // end namespace Catch
+
+#endif // TWOBLUECUBES_CATCH_BINARY_LOG_HPP_INCLUDED
@@ -19,6 +19,7 @@
 #include "catch_evaluate.hpp"
 #include "catch_hub.h"
 #include "catch_common.h"
+#include "catch_allocation_counter.hpp"
 #include <sstream>
 
 namespace Catch
@@ -266,6 +267,7 @@ public:
     ///////////////////////////////////////////////////////////////////////////
     MutableResultInfo
     ()
+    :   m_isRetrying( false )
     {}
     
     ///////////////////////////////////////////////////////////////////////////
@@ -278,7 +280,8 @@ public:
         const char* macroName,
         const char* message = ""
     )
-    : ResultInfo( expr, ResultWas::Unknown, isNot, filename, line, macroName, message )
+    : ResultInfo( expr, ResultWas::Unknown, isNot, filename, line, macroName, message ),
+      m_isRetrying( false )
     {
     }
 
@@ -306,6 +309,17 @@ public:
         m_message = message;
     }
     
+    ///////////////////////////////////////////////////////////////////////////
+    // A failure that's going to be retried (and so isn't reported) isn't
+    // worth stringifying
+    void setRetrying
+    (
+        bool isRetrying
+    )
+    {
+        m_isRetrying = isRetrying;
+    }
+
     ///////////////////////////////////////////////////////////////////////////
     void setFileAndLine
     (
@@ -358,12 +372,15 @@ private:
     )
     {
         setResultType( Internal::compare<Op>( lhs, rhs ) ? ResultWas::Ok : ResultWas::ExpressionFailed );
+        if( m_isRetrying && !ok() )
+            return *this;
         m_lhs = Catch::toString( lhs );
         m_rhs = Catch::toString( rhs );
         m_op = Internal::OperatorTraits<Op>::getName();
         return *this;
     }
-    
+
+    bool m_isRetrying;
 };
 
 template<typename T>
@@ -537,6 +554,10 @@ private:
     const LhsT* m_lhs;
 };
     
+// Allocation counting is paused for as long as the builder exists, so the
+// strings it builds while capturing an assertion (and the result's trip
+// through the reporters) aren't counted against the test - nor is anything
+// allocated by the assertion's expression itself
 class ResultBuilder
 {
 public:
@@ -611,6 +632,16 @@ public:
         return *this;
     }
     
+    ///////////////////////////////////////////////////////////////////////////
+    ResultBuilder& setRetrying
+    (
+        bool isRetrying
+    )
+    {
+        m_result.setRetrying( isRetrying );
+        return *this;
+    }
+
     ///////////////////////////////////////////////////////////////////////////
     ResultBuilder& setResultType
     (
@@ -630,6 +661,7 @@ public:
     }
     
 private:
+    AllocationCounter::Pause m_pause;
     MutableResultInfo m_result;
     std::ostringstream m_messageStream;
     
@@ -690,8 +722,8 @@ inline bool isTrue
 #define INTERNAL_CATCH_ACCEPT_EXPR( expr, stopOnFailure ) \
     if( Catch::ResultAction::Value internal_catch_action = Catch::Hub::getResultCapture().acceptExpression( expr )  ) \
     { \
-        if( internal_catch_action == Catch::ResultAction::DebugFailed ) BreakIntoDebugger(); \
-        if( Catch::isTrue( stopOnFailure ) ) throw Catch::TestFailureException(); \
+        if( Catch::ResultAction::shouldDebugBreak( internal_catch_action ) ) BreakIntoDebugger(); \
+        if( Catch::isTrue( stopOnFailure ) || Catch::ResultAction::shouldAbort( internal_catch_action ) ) throw Catch::TestFailureException(); \
     }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,358 @@
+/*
+ *  catch_captured_output.hpp
+ *  Catch
+ *
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * Holds the output captured from tests, within a size limit
+ */
+
+#ifndef TWOBLUECUBES_CATCH_CAPTURED_OUTPUT_HPP_INCLUDED
+#define TWOBLUECUBES_CATCH_CAPTURED_OUTPUT_HPP_INCLUDED
+
+#include "catch_allocation_counter.hpp"
+#include "catch_common.h"
+
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+namespace Catch
+{
+    // Keeps the first half of the limit's worth of output, and the last half
+    // in a ring buffer, so the start and the end of chatty output survive and
+    // memory use is bounded. A limit of 0 keeps everything
+    class CapturedOutput
+    {
+    public:
+        ///////////////////////////////////////////////////////////////////////
+        explicit CapturedOutput
+        (
+            std::size_t limit = 0
+        )
+        :   m_limit( limit ),
+            m_tailStart( 0 ),
+            m_omitted( 0 )
+        {
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        void append
+        (
+            const char* data,
+            std::size_t size
+        )
+        {
+            if( m_limit == 0 )
+            {
+                m_head.append( data, size );
+                return;
+            }
+            std::size_t headSize = (std::min)( size, m_limit / 2 - m_head.size() );
+            m_head.append( data, headSize );
+            if( headSize < size )
+                appendToTail( data + headSize, size - headSize );
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        void append
+        (
+            const std::string& str
+        )
+        {
+            append( str.data(), str.size() );
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        void addNote
+        (
+            const std::string& note
+        )
+        {
+            m_notes += "\n[" + note + "]";
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        bool empty
+        ()
+        const
+        {
+            return m_head.empty() && m_notes.empty();
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        std::string str
+        ()
+        const
+        {
+            if( m_omitted == 0 && m_tailStart == 0 )
+                return m_head + m_tail + m_notes;
+
+            std::ostringstream oss;
+            oss << m_head;
+            if( m_omitted > 0 )
+                oss << "\n[... " << m_omitted << " bytes of output omitted ...]\n";
+            oss << m_tail.substr( m_tailStart ) << m_tail.substr( 0, m_tailStart ) << m_notes;
+            return oss.str();
+        }
+
+    private:
+        ///////////////////////////////////////////////////////////////////////
+        void appendToTail
+        (
+            const char* data,
+            std::size_t size
+        )
+        {
+            std::size_t capacity = m_limit - m_limit / 2;
+            if( size >= capacity )
+            {
+                m_omitted += m_tail.size() + size - capacity;
+                m_tail.assign( data + size - capacity, capacity );
+                m_tailStart = 0;
+                return;
+            }
+            if( m_tail.size() < capacity )
+            {
+                std::size_t count = (std::min)( size, capacity - m_tail.size() );
+                m_tail.append( data, count );
+                data += count;
+                size -= count;
+            }
+            // The ring is full, so the oldest bytes make way
+            m_omitted += size;
+            while( size > 0 )
+            {
+                std::size_t count = (std::min)( size, capacity - m_tailStart );
+                m_tail.replace( m_tailStart, count, data, count );
+                m_tailStart = ( m_tailStart + count ) % capacity;
+                data += count;
+                size -= count;
+            }
+        }
+
+        std::size_t m_limit;
+        std::string m_head;
+        std::string m_tail;
+        std::size_t m_tailStart;
+        std::size_t m_omitted;
+        std::string m_notes;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Collects a test case's output. Output is added to the test case and to
+    // each section that is running, so sections have their own output and the
+    // test case has all of it, from every time it is run
+    class OutputCollector : NonCopyable
+    {
+        struct Scope
+        {
+            ///////////////////////////////////////////////////////////////////
+            explicit Scope
+            (
+                std::size_t limit
+            )
+            :   stdOut( limit ),
+                stdErr( limit )
+            {
+            }
+
+            CapturedOutput stdOut;
+            CapturedOutput stdErr;
+        };
+
+    public:
+        enum Stream
+        {
+            StdOut,
+            StdErr
+        };
+
+        ///////////////////////////////////////////////////////////////////////
+        explicit OutputCollector
+        (
+            std::size_t limit = 0
+        )
+        :   m_limit( limit )
+        {
+            startTestCase();
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        std::size_t getLimit
+        ()
+        const
+        {
+            return m_limit;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        void startTestCase
+        ()
+        {
+            m_scopes.clear();
+            m_scopes.push_back( Scope( m_limit ) );
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        void startSection
+        ()
+        {
+            m_scopes.push_back( Scope( m_limit ) );
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        void endSection
+        (
+            std::string& stdOut,
+            std::string& stdErr
+        )
+        {
+            if( m_scopes.size() < 2 )
+                return;
+            stdOut = m_scopes.back().stdOut.str();
+            stdErr = m_scopes.back().stdErr.str();
+            m_scopes.pop_back();
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        void getTestCaseOutput
+        (
+            std::string& stdOut,
+            std::string& stdErr
+        )
+        const
+        {
+            stdOut = m_scopes.front().stdOut.str();
+            stdErr = m_scopes.front().stdErr.str();
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // Often called while a test is writing, but the memory is ours
+        void append
+        (
+            Stream stream,
+            const char* data,
+            std::size_t size
+        )
+        {
+            AllocationCounter::Pause pause;
+            for( std::size_t i = 0; i < m_scopes.size(); ++i )
+                get( m_scopes[i], stream ).append( data, size );
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        void append
+        (
+            Stream stream,
+            const std::string& str
+        )
+        {
+            append( stream, str.data(), str.size() );
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        void addTestCaseNote
+        (
+            Stream stream,
+            const std::string& note
+        )
+        {
+            get( m_scopes.front(), stream ).addNote( note );
+        }
+
+    private:
+        ///////////////////////////////////////////////////////////////////////
+        static CapturedOutput& get
+        (
+            Scope& scope,
+            Stream stream
+        )
+        {
+            return stream == StdOut ? scope.stdOut : scope.stdErr;
+        }
+
+        std::size_t m_limit;
+        std::vector<Scope> m_scopes;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Passes whatever is written to an OutputCollector
+    class CaptureStreamBuf : public std::streambuf
+    {
+    public:
+        ///////////////////////////////////////////////////////////////////////
+        CaptureStreamBuf
+        (
+            OutputCollector& collector,
+            OutputCollector::Stream stream
+        )
+        :   m_collector( collector ),
+            m_stream( stream )
+        {
+            setp( m_data, m_data + sizeof( m_data ) );
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        ~CaptureStreamBuf
+        ()
+        {
+            sync();
+        }
+
+    private:
+        ///////////////////////////////////////////////////////////////////////
+        virtual int overflow
+        (
+            int c
+        )
+        {
+            sync();
+            if( c != EOF )
+                sputc( static_cast<char>( c ) );
+            return 0;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        virtual std::streamsize xsputn
+        (
+            const char* data,
+            std::streamsize size
+        )
+        {
+            // Big writes needn't go through the buffer
+            if( size > static_cast<std::streamsize>( sizeof( m_data ) ) )
+            {
+                sync();
+                m_collector.append( m_stream, data, static_cast<std::size_t>( size ) );
+                return size;
+            }
+            return std::streambuf::xsputn( data, size );
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        virtual int sync
+        ()
+        {
+            if( pptr() != pbase() )
+            {
+                m_collector.append( m_stream, pbase(), static_cast<std::size_t>( pptr() - pbase() ) );
+                setp( pbase(), epptr() );
+            }
+            return 0;
+        }
+
+        char m_data[4096];
+        OutputCollector& m_collector;
+        OutputCollector::Stream m_stream;
+    };
+
+} // end namespace Catch
+
+#endif // TWOBLUECUBES_CATCH_CAPTURED_OUTPUT_HPP_INCLUDED
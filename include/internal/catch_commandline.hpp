@@ -26,11 +26,27 @@ namespace Catch
     // -l, --list reporters [xml] lists available reports (optionally in xml)
     // -l, --list all [xml] lists available tests and reports (optionally in xml)
     // -t, --test "testspec" ["testspec", ...]
-    // -r, --reporter <type>
+    // -r, --reporter <type>[::out=<file>] (may be given more than once)
     // -o, --out filename to write to
     // -s, --success report successful cases too
     // -b, --break breaks into debugger on test failure
     // -n, --name specifies an optional name for the test run
+    // -j, --workers <n> splits the generator combinations of each test across n worker processes
+    // --order <decl|rand> runs test cases in declaration (the default) or a random order
+    // --rng-seed <n|time> seeds the random order (implied, unless --order says otherwise), so a run can be reproduced
+    // --async formats and writes the report on a separate thread
+    // --capture <streams|fd> captures test output from std::cout/std::cerr (the default) or from the stdout/stderr file descriptors
+    // --output-limit <bytes> keeps the first and last bytes of each test case's and section's output, up to this many (0 keeps everything)
+    // --allocations counts the heap allocations made by each test case and section, and fails test cases that leak
+    // --resources reports the peak RSS growth, page faults, context switches and leaked file descriptors of each test case, and fails test cases that leak descriptors
+    // --timeout <seconds> fails test cases that run for longer than this (unless they have a timeout of their own), and carries on
+    // -a, --abort stops the run at the first failure
+    // -x, --abortx <n> stops the run once n assertions have failed
+    // --repeat <n> runs the selected tests n times over, and reports how each test case fared across the runs
+    // --until-fail repeats the selected tests until one fails (or for --repeat times, if given)
+    // --schedule <seed> replays the thread schedule a failed INTERLEAVING_TEST_CASE reported, instead of exploring
+    // --property-seed <seed> replays the values a failed PROPERTY reported, by generating them from its seed
+    // --convert <file> reports the results in a log written by the binary reporter, instead of running tests
 	class ArgParser : NonCopyable
     {
         enum Mode
@@ -43,6 +59,22 @@ namespace Catch
             modeSuccess,
             modeBreak,
             modeName,
+            modeWorkers,
+            modeOrder,
+            modeRngSeed,
+            modeAsync,
+            modeConvert,
+            modeCapture,
+            modeOutputLimit,
+            modeAllocations,
+            modeResources,
+            modeTimeout,
+            modeAbort,
+            modeAbortX,
+            modeRepeat,
+            modeUntilFail,
+            modeSchedule,
+            modePropertySeed,
             modeHelp,
 
             modeError
@@ -57,6 +89,7 @@ namespace Catch
             Config& config
         )
         :   m_mode( modeNone ),
+            m_isOrderGiven( false ),
             m_config( config )
         {
             for( int i=1; i < argc; ++i )
@@ -78,6 +111,38 @@ namespace Catch
                         changeMode( cmd, modeBreak );
                     else if( cmd == "-n" || cmd == "--name" )
                         changeMode( cmd, modeName );
+                    else if( cmd == "-j" || cmd == "--workers" )
+                        changeMode( cmd, modeWorkers );
+                    else if( cmd == "--order" )
+                        changeMode( cmd, modeOrder );
+                    else if( cmd == "--rng-seed" )
+                        changeMode( cmd, modeRngSeed );
+                    else if( cmd == "--async" )
+                        changeMode( cmd, modeAsync );
+                    else if( cmd == "--convert" )
+                        changeMode( cmd, modeConvert );
+                    else if( cmd == "--capture" )
+                        changeMode( cmd, modeCapture );
+                    else if( cmd == "--output-limit" )
+                        changeMode( cmd, modeOutputLimit );
+                    else if( cmd == "--allocations" )
+                        changeMode( cmd, modeAllocations );
+                    else if( cmd == "--resources" )
+                        changeMode( cmd, modeResources );
+                    else if( cmd == "--timeout" )
+                        changeMode( cmd, modeTimeout );
+                    else if( cmd == "-a" || cmd == "--abort" )
+                        changeMode( cmd, modeAbort );
+                    else if( cmd == "-x" || cmd == "--abortx" )
+                        changeMode( cmd, modeAbortX );
+                    else if( cmd == "--repeat" )
+                        changeMode( cmd, modeRepeat );
+                    else if( cmd == "--until-fail" )
+                        changeMode( cmd, modeUntilFail );
+                    else if( cmd == "--schedule" )
+                        changeMode( cmd, modeSchedule );
+                    else if( cmd == "--property-seed" )
+                        changeMode( cmd, modePropertySeed );
                     else if( cmd == "-h" || cmd == "-?" || cmd == "--help" )
                         changeMode( cmd, modeHelp );
                 }
@@ -189,6 +254,134 @@ namespace Catch
                         return setErrorMode( m_command + " requires exactly one argument (a name)" );
                     m_config.setName( m_args[0] );
                     break;
+                case modeWorkers:
+                    {
+                        std::size_t workerCount = 0;
+                        if( m_args.size() != 1 || !parseCount( m_args[0], workerCount ) || workerCount == 0 )
+                            return setErrorMode( m_command + " requires exactly one argument (a positive number of workers)" );
+                        m_config.setWorkerCount( workerCount );
+                    }
+                    break;
+                case modeOrder:
+                    if( m_args.size() != 1 )
+                        return setErrorMode( m_command + " requires exactly one argument (decl or rand)" );
+                    if( m_args[0] == "decl" )
+                        m_config.setOrder( Config::Order::Declared );
+                    else if( m_args[0] == "rand" )
+                        m_config.setOrder( Config::Order::Randomised );
+                    else
+                        return setErrorMode( m_command + " expected [decl] or [rand] but recieved: [" + m_args[0] + "]" );
+                    m_isOrderGiven = true;
+                    break;
+                case modeRngSeed:
+                    {
+                        std::size_t seed = 0;
+                        if( m_args.size() != 1 )
+                            return setErrorMode( m_command + " requires exactly one argument (a number or 'time')" );
+                        if( m_args[0] == "time" )
+                            m_config.setRngSeed( 0 );
+                        else if( parseCount( m_args[0], seed ) && seed > 0 && seed <= 0xffffffffU )
+                            m_config.setRngSeed( static_cast<unsigned int>( seed ) );
+                        else
+                            return setErrorMode( m_command + " expected a positive number or [time] but recieved: [" + m_args[0] + "]" );
+                        // A seed is only useful with a random order, so it
+                        // implies one - unless --order says otherwise
+                        if( !m_isOrderGiven )
+                            m_config.setOrder( Config::Order::Randomised );
+                    }
+                    break;
+                case modeAsync:
+                    if( m_args.size() != 0 )
+                        return setErrorMode( m_command + " does not accept arguments" );
+                    m_config.setReportAsynchronously( true );
+                    break;
+                case modeConvert:
+                    if( m_args.size() != 1 )
+                        return setErrorMode( m_command + " requires exactly one argument (a binary log file)" );
+                    m_config.setLogToConvert( m_args[0] );
+                    break;
+                case modeCapture:
+                    if( m_args.size() != 1 )
+                        return setErrorMode( m_command + " requires exactly one argument (streams or fd)" );
+                    if( m_args[0] == "streams" )
+                        m_config.setCapture( Config::Capture::Streams );
+                    else if( m_args[0] == "fd" )
+                        m_config.setCapture( Config::Capture::Descriptors );
+                    else
+                        return setErrorMode( m_command + " expected [streams] or [fd] but recieved: [" + m_args[0] + "]" );
+                    break;
+                case modeOutputLimit:
+                    {
+                        std::size_t outputLimit = 0;
+                        if( m_args.size() != 1 || !parseCount( m_args[0], outputLimit ) )
+                            return setErrorMode( m_command + " requires exactly one argument (a number of bytes, or 0 for no limit)" );
+                        m_config.setOutputLimit( outputLimit );
+                    }
+                    break;
+                case modeAllocations:
+                    if( m_args.size() != 0 )
+                        return setErrorMode( m_command + " does not accept arguments" );
+                    if( !AllocationCounter::areHooksInstalled() )
+                        return setErrorMode( m_command + " needs the tests to be built with CATCH_CONFIG_COUNT_ALLOCATIONS defined" );
+                    m_config.setCountAllocations( true );
+                    break;
+                case modeResources:
+                    if( m_args.size() != 0 )
+                        return setErrorMode( m_command + " does not accept arguments" );
+                    if( !ProcessUsage::canRecord() )
+                        return setErrorMode( m_command + " is not supported on this platform" );
+                    m_config.setRecordProcessUsage( true );
+                    break;
+                case modeTimeout:
+                    {
+                        unsigned int timeout = 0;
+                        if( m_args.size() != 1 || !parseSeconds( m_args[0], timeout ) )
+                            return setErrorMode( m_command + " requires exactly one argument (a number of seconds, or 0 for no timeout)" );
+                        m_config.setTimeout( timeout );
+                    }
+                    break;
+                case modeAbort:
+                    if( m_args.size() != 0 )
+                        return setErrorMode( m_command + " does not accept arguments" );
+                    m_config.setAbortAfter( 1 );
+                    break;
+                case modeAbortX:
+                    {
+                        std::size_t abortAfter = 0;
+                        if( m_args.size() != 1 || !parseCount( m_args[0], abortAfter ) || abortAfter == 0 )
+                            return setErrorMode( m_command + " requires exactly one argument (a positive number of failures)" );
+                        m_config.setAbortAfter( abortAfter );
+                    }
+                    break;
+                case modeRepeat:
+                    {
+                        std::size_t repeat = 0;
+                        if( m_args.size() != 1 || !parseCount( m_args[0], repeat ) || repeat == 0 )
+                            return setErrorMode( m_command + " requires exactly one argument (a positive number of runs)" );
+                        m_config.setRepeat( repeat );
+                    }
+                    break;
+                case modeUntilFail:
+                    if( m_args.size() != 0 )
+                        return setErrorMode( m_command + " does not accept arguments" );
+                    m_config.setRepeatUntilFail( true );
+                    break;
+                case modeSchedule:
+                    {
+                        std::size_t seed = 0;
+                        if( m_args.size() != 1 || !parseCount( m_args[0], seed ) || seed == 0 || seed > 0xffffffffU )
+                            return setErrorMode( m_command + " requires exactly one argument (the seed of a schedule to replay)" );
+                        m_config.setScheduleSeed( static_cast<unsigned int>( seed ) );
+                    }
+                    break;
+                case modePropertySeed:
+                    {
+                        std::size_t seed = 0;
+                        if( m_args.size() != 1 || !parseCount( m_args[0], seed ) || seed == 0 || seed > 0xffffffffU )
+                            return setErrorMode( m_command + " requires exactly one argument (the seed of a property to replay)" );
+                        m_config.setPropertySeed( static_cast<unsigned int>( seed ) );
+                    }
+                    break;
                 case modeHelp:
                     if( m_args.size() != 0 )
                         return setErrorMode( m_command + " does not accept arguments" );
@@ -201,6 +394,33 @@ namespace Catch
             m_mode = mode;
         }
         
+        ///////////////////////////////////////////////////////////////////////
+        static bool parseCount
+        (
+            const std::string& arg,
+            std::size_t& count
+        )
+        {
+            std::istringstream iss( arg );
+            return ( iss >> count ) && iss.eof() && arg.find( '-' ) == std::string::npos;
+        }
+        
+        ///////////////////////////////////////////////////////////////////////
+        // Fractions of a second are allowed. The result is in milliseconds
+        static bool parseSeconds
+        (
+            const std::string& arg,
+            unsigned int& milliseconds
+        )
+        {
+            std::istringstream iss( arg );
+            double seconds = 0;
+            if( !( iss >> seconds ) || !iss.eof() || seconds < 0 || seconds > 4000000 )
+                return false;
+            milliseconds = static_cast<unsigned int>( seconds * 1000 + 0.5 );
+            return seconds == 0 || milliseconds > 0;
+        }
+        
         ///////////////////////////////////////////////////////////////////////
         void setErrorMode
         (
@@ -215,6 +435,7 @@ namespace Catch
     private:
         
         Mode m_mode;
+        bool m_isOrderGiven;
         std::string m_command;
         std::vector<std::string> m_args;
         Config& m_config;
@@ -15,7 +15,9 @@
 
 #include "catch_interfaces_reporter.h"
 #include "catch_hub.h"
+#include "catch_reporter_multi.hpp"
 
+#include <ctime>
 #include <memory>
 #include <vector>
 #include <string>
@@ -52,17 +54,44 @@ namespace Catch
             
             AsMask = 0xf0
         }; };
+
+        struct Order { enum What
+        {
+            Declared,
+            Randomised
+        }; };
+
+        struct Capture { enum What
+        {
+            Streams,
+            Descriptors
+        }; };
         
         
         ///////////////////////////////////////////////////////////////////////////
         Config()
         :   m_reporter( NULL ),
+            m_multiReporter( NULL ),
             m_listSpec( List::None ),
             m_shouldDebugBreak( false ),
             m_showHelp( false ),
             m_streambuf( NULL ),
             m_os( std::cout.rdbuf() ),
-            m_includeWhat( Include::FailedOnly )
+            m_includeWhat( Include::FailedOnly ),
+            m_workerCount( 1 ),
+            m_order( Order::Declared ),
+            m_rngSeed( 0 ),
+            m_reportAsynchronously( false ),
+            m_capture( Capture::Streams ),
+            m_outputLimit( 1024 * 1024 ),
+            m_countAllocations( false ),
+            m_recordProcessUsage( false ),
+            m_timeout( 0 ),
+            m_abortAfter( 0 ),
+            m_repeat( 0 ),
+            m_repeatUntilFail( false ),
+            m_scheduleSeed( 0 ),
+            m_propertySeed( 0 )
         {}
         
         ///////////////////////////////////////////////////////////////////////////
@@ -73,11 +102,20 @@ namespace Catch
         }
         
         ///////////////////////////////////////////////////////////////////////////
-        void setReporter( const std::string& reporterName )
+        // May be called more than once, to report to several places at once.
+        // See MultiReporter for the format of reporterSpec
+        void setReporter( const std::string& reporterSpec )
         {
-            if( m_reporter.get() )
-                return setError( "Only one reporter may be specified" );
-            setReporter( Hub::getReporterRegistry().create( reporterName, *this ) );
+            if( m_reporter.get() && !m_multiReporter )
+                return setError( "A reporter has already been set" );
+            if( !m_multiReporter )
+            {
+                m_multiReporter = new MultiReporter( *this );
+                m_reporter = std::auto_ptr<IReporter>( m_multiReporter );
+            }
+            std::string error = m_multiReporter->addReporter( reporterSpec );
+            if( !error.empty() )
+                setError( error );
         }
         
         ///////////////////////////////////////////////////////////////////////////
@@ -117,7 +155,7 @@ namespace Catch
         }
         
         ///////////////////////////////////////////////////////////////////////////
-        const std::string& getFilename() const
+        virtual const std::string& getFilename() const
         {
             return m_filename;
         }
@@ -138,6 +176,7 @@ namespace Catch
         void setReporter( IReporter* reporter )
         {
             m_reporter = std::auto_ptr<IReporter>( reporter );
+            m_multiReporter = NULL;
         }
         
         ///////////////////////////////////////////////////////////////////////////
@@ -148,6 +187,15 @@ namespace Catch
             return m_reporter.get();
         }
                 
+        ///////////////////////////////////////////////////////////////////////////
+        // Ownership passes to the caller (e.g. to wrap it in another reporter)
+        IReporter* releaseReporter()
+        {
+            getReporter();
+            m_multiReporter = NULL;
+            return m_reporter.release();
+        }
+                
         ///////////////////////////////////////////////////////////////////////////
         List::What listWhat() const
         {
@@ -229,8 +277,227 @@ namespace Catch
             return m_includeWhat == Include::SuccessfulResults;
         }
         
+        ///////////////////////////////////////////////////////////////////////////
+        void setWorkerCount( std::size_t workerCount )
+        {
+            m_workerCount = workerCount;
+        }
+        
+        ///////////////////////////////////////////////////////////////////////////
+        std::size_t getWorkerCount() const
+        {
+            return m_workerCount;
+        }
+        
+        ///////////////////////////////////////////////////////////////////////////
+        void setOrder( Order::What order )
+        {
+            m_order = order;
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        Order::What getOrder() const
+        {
+            return m_order;
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        void setRngSeed( unsigned int rngSeed )
+        {
+            m_rngSeed = rngSeed;
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        // 0 unless running in a random order. If no seed was given one is
+        // taken from the clock, the first time it is asked for, so that it
+        // can be reported and the run reproduced with --rng-seed
+        virtual unsigned int getRngSeed() const
+        {
+            if( m_order != Order::Randomised )
+                return 0;
+            if( m_rngSeed == 0 )
+                m_rngSeed = ( static_cast<unsigned int>( std::time( NULL ) ) & 0x7fffffffU ) | 1;
+            return m_rngSeed;
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        void setReportAsynchronously( bool reportAsynchronously )
+        {
+            m_reportAsynchronously = reportAsynchronously;
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        bool reportAsynchronously() const
+        {
+            return m_reportAsynchronously;
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        void setCapture( Capture::What capture )
+        {
+            m_capture = capture;
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        // Streams swaps std::cout's and std::cerr's buffers. Descriptors
+        // redirects stdout and stderr themselves, so catches everything
+        Capture::What getCapture() const
+        {
+            return m_capture;
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        // The most output kept for each of stdout and stderr, per test case
+        // and per section: the first half and the last half of it. 0 keeps
+        // everything
+        void setOutputLimit( std::size_t outputLimit )
+        {
+            m_outputLimit = outputLimit;
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        std::size_t getOutputLimit() const
+        {
+            return m_outputLimit;
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        // Reports the heap allocations each test case and section makes, and
+        // fails test cases that leak. Needs CATCH_CONFIG_COUNT_ALLOCATIONS
+        void setCountAllocations( bool countAllocations )
+        {
+            m_countAllocations = countAllocations;
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        bool countAllocations() const
+        {
+            return m_countAllocations;
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        // Reports each test case's peak RSS growth, page faults, context
+        // switches and leaked file descriptors, and fails those that leak
+        // descriptors
+        void setRecordProcessUsage( bool recordProcessUsage )
+        {
+            m_recordProcessUsage = recordProcessUsage;
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        bool recordProcessUsage() const
+        {
+            return m_recordProcessUsage;
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        // In milliseconds (0 for none). A test case still running after its
+        // timeout fails, and the rest of the tests carry on. Test cases can
+        // set their own, with TEST_CASE_TIMEOUT
+        void setTimeout( unsigned int timeout )
+        {
+            m_timeout = timeout;
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        unsigned int getTimeout() const
+        {
+            return m_timeout;
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        // Stops the run once this many assertions have failed (0 never
+        // stops). The test case that reaches it ends there, and nothing
+        // after it runs
+        void setAbortAfter( std::size_t abortAfter )
+        {
+            m_abortAfter = abortAfter;
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        std::size_t getAbortAfter() const
+        {
+            return m_abortAfter;
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        // Runs the selected tests this many times over (0 if not given)
+        void setRepeat( std::size_t repeat )
+        {
+            m_repeat = repeat;
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        std::size_t getRepeat() const
+        {
+            return m_repeat;
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        // Repeats the selected tests until a test case fails - for at most
+        // getRepeat() runs, if that was given, or else for as long as it takes
+        void setRepeatUntilFail( bool repeatUntilFail )
+        {
+            m_repeatUntilFail = repeatUntilFail;
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        bool repeatUntilFail() const
+        {
+            return m_repeatUntilFail;
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        bool isRepeating() const
+        {
+            return m_repeat > 1 || m_repeatUntilFail;
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        // Has each INTERLEAVING_TEST_CASE replay the one schedule this seed
+        // picks, rather than exploring (0 for none)
+        void setScheduleSeed( unsigned int scheduleSeed )
+        {
+            m_scheduleSeed = scheduleSeed;
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        unsigned int getScheduleSeed() const
+        {
+            return m_scheduleSeed;
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        // Has each PROPERTY generate its values from this seed, as a failed
+        // one reported, rather than from its own (0 for none)
+        void setPropertySeed( unsigned int propertySeed )
+        {
+            m_propertySeed = propertySeed;
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        unsigned int getPropertySeed() const
+        {
+            return m_propertySeed;
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        // A log written by the binary reporter, to be reported instead of
+        // running any tests
+        void setLogToConvert( const std::string& filename )
+        {
+            m_logToConvert = filename;
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        const std::string& getLogToConvert() const
+        {
+            return m_logToConvert;
+        }
+
     private:
         std::auto_ptr<IReporter> m_reporter;
+        MultiReporter* m_multiReporter;
         std::string m_filename;
         std::string m_message;
         List::What m_listSpec;
@@ -241,6 +508,21 @@ namespace Catch
         mutable std::ostream m_os;
         Include::What m_includeWhat;
         std::string m_name;
+        std::size_t m_workerCount;
+        Order::What m_order;
+        mutable unsigned int m_rngSeed;
+        bool m_reportAsynchronously;
+        std::string m_logToConvert;
+        Capture::What m_capture;
+        std::size_t m_outputLimit;
+        bool m_countAllocations;
+        bool m_recordProcessUsage;
+        unsigned int m_timeout;
+        std::size_t m_abortAfter;
+        std::size_t m_repeat;
+        bool m_repeatUntilFail;
+        unsigned int m_scheduleSeed;
+        unsigned int m_propertySeed;
         
     };
     
@@ -0,0 +1,476 @@
+/*
+ *  catch_event_stream.hpp
+ *  Catch
+ *
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * Flattens reporter events into a byte stream, so they can be raised again
+ * somewhere else (e.g. in another process)
+ */
+
+#ifndef TWOBLUECUBES_CATCH_EVENT_STREAM_HPP_INCLUDED
+#define TWOBLUECUBES_CATCH_EVENT_STREAM_HPP_INCLUDED
+
+#include "catch_interfaces_reporter.h"
+#include "catch_resultinfo.hpp"
+#include "catch_test_case_info.hpp"
+
+#include <ostream>
+#include <sstream>
+#include <stdint.h>
+#include <string>
+
+namespace Catch
+{
+    struct Event
+    {
+        enum Type
+        {
+            None = 0,
+            GroupStarted = 'g',
+            GroupEnded = 'e',
+            TestCaseStarted = 'T',
+            TestCaseEnded = 't',
+            SectionStarted = 'S',
+            SectionEnded = 'E',
+            GeneratorCombinationEnded = 'G',
+            Result = 'R',
+            StdOut = 'O',
+            StdErr = 'X',
+            Usage = 'U'
+        };
+
+        ///////////////////////////////////////////////////////////////////////
+        Event
+        ()
+        :   type( None ),
+            succeeded( 0 ),
+            failed( 0 ),
+            combination( 0 )
+        {
+        }
+
+        Type type;
+        std::string name;
+        std::string text;
+        std::string stdErr;
+        std::size_t succeeded;
+        std::size_t failed;
+        std::size_t combination;
+        ResourceUsage usage;
+        ResultInfo result;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Records are a type character followed by its fields. Strings are
+    // written as <length>:<bytes> and numbers as <digits>;
+    class EventWriter : public IReporter
+    {
+    public:
+        ///////////////////////////////////////////////////////////////////////
+        explicit EventWriter
+        (
+            std::ostream& os
+        )
+        :   m_os( os )
+        {
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        void writeOutput
+        (
+            Event::Type type,
+            const std::string& text
+        )
+        {
+            if( !text.empty() )
+            {
+                m_os << static_cast<char>( type );
+                writeString( text );
+            }
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        void writeUsage
+        (
+            const ResourceUsage& usage
+        )
+        {
+            m_os << static_cast<char>( Event::Usage );
+            writeResourceUsage( usage );
+        }
+
+    private: // IReporter
+
+        // Testing, and its totals, are owned by whoever replays the events
+        virtual void StartTesting(){}
+        virtual void EndTesting( std::size_t, std::size_t ){}
+        virtual void TestCaseRepeated( const RepeatStats& ){}
+
+        ///////////////////////////////////////////////////////////////////////
+        virtual void StartGroup
+        (
+            const std::string& groupName
+        )
+        {
+            m_os << static_cast<char>( Event::GroupStarted );
+            writeString( groupName );
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        virtual void EndGroup
+        (
+            const std::string& groupName,
+            std::size_t succeeded,
+            std::size_t failed
+        )
+        {
+            m_os << static_cast<char>( Event::GroupEnded );
+            writeString( groupName );
+            writeNumber( succeeded );
+            writeNumber( failed );
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // Only the name is written - it is looked up again when replayed
+        virtual void StartTestCase
+        (
+            const TestCaseInfo& testInfo
+        )
+        {
+            m_os << static_cast<char>( Event::TestCaseStarted );
+            writeString( testInfo.getName() );
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // Flushed, so what has been reported survives the process being
+        // killed
+        virtual void EndTestCase
+        (
+            const TestCaseInfo& testInfo,
+            std::size_t succeeded,
+            std::size_t failed,
+            const std::string& stdOut,
+            const std::string& stdErr,
+            const ResourceUsage& usage
+        )
+        {
+            m_os << static_cast<char>( Event::TestCaseEnded );
+            writeString( testInfo.getName() );
+            writeNumber( succeeded );
+            writeNumber( failed );
+            writeString( stdOut );
+            writeString( stdErr );
+            writeResourceUsage( usage );
+            m_os.flush();
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        virtual void StartSection
+        (
+            const std::string& sectionName,
+            const std::string description
+        )
+        {
+            m_os << static_cast<char>( Event::SectionStarted );
+            writeString( sectionName );
+            writeString( description );
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        virtual void EndSection
+        (
+            const std::string& sectionName,
+            std::size_t succeeded,
+            std::size_t failed,
+            const std::string& stdOut,
+            const std::string& stdErr,
+            const ResourceUsage& usage
+        )
+        {
+            m_os << static_cast<char>( Event::SectionEnded );
+            writeString( sectionName );
+            writeNumber( succeeded );
+            writeNumber( failed );
+            writeString( stdOut );
+            writeString( stdErr );
+            writeResourceUsage( usage );
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        virtual void EndGeneratorCombination
+        (
+            std::size_t combination,
+            std::size_t succeeded,
+            std::size_t failed,
+            const ResourceUsage& usage
+        )
+        {
+            m_os << static_cast<char>( Event::GeneratorCombinationEnded );
+            writeNumber( combination );
+            writeNumber( succeeded );
+            writeNumber( failed );
+            writeResourceUsage( usage );
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        virtual void Result
+        (
+            const ResultInfo& result
+        )
+        {
+            m_os << static_cast<char>( Event::Result );
+            writeString( result.m_macroName );
+            writeString( result.m_filename );
+            writeNumber( result.m_line );
+            writeString( result.m_expr );
+            writeString( result.m_lhs );
+            writeString( result.m_rhs );
+            writeString( result.m_op );
+            writeString( result.m_message );
+            writeNumber( static_cast<std::size_t>( result.m_result - ResultWas::Unknown ) );
+            writeNumber( result.m_isNot ? 1 : 0 );
+        }
+
+    private:
+
+        ///////////////////////////////////////////////////////////////////////
+        void writeString
+        (
+            const std::string& str
+        )
+        {
+            m_os << str.size() << ':' << str;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        void writeNumber
+        (
+            uint64_t number
+        )
+        {
+            m_os << number << ';';
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        void writeResourceUsage
+        (
+            const ResourceUsage& usage
+        )
+        {
+            writeNumber( usage.timed ? 1 : 0 );
+            writeNumber( usage.startMicroseconds );
+            writeNumber( usage.durationMicroseconds );
+            writeNumber( usage.worker );
+            writeNumber( usage.allocationsCounted ? 1 : 0 );
+            writeNumber( usage.allocations );
+            writeNumber( usage.deallocations );
+            writeNumber( usage.bytesAllocated );
+            writeNumber( usage.bytesFreed );
+            writeNumber( usage.peakBytes );
+            writeNumber( usage.processUsageRecorded ? 1 : 0 );
+            writeNumber( usage.peakRssGrowth );
+            writeNumber( usage.minorFaults );
+            writeNumber( usage.majorFaults );
+            writeNumber( usage.voluntarySwitches );
+            writeNumber( usage.involuntarySwitches );
+            writeNumber( usage.descriptorsLeaked );
+        }
+
+        std::ostream& m_os;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    class EventReader
+    {
+    public:
+        ///////////////////////////////////////////////////////////////////////
+        // Starts at start, which must be the start of an event
+        explicit EventReader
+        (
+            const std::string& data,
+            std::size_t start = 0
+        )
+        :   m_data( data ),
+            m_pos( start ),
+            m_eventEnd( start ),
+            m_isValid( true )
+        {
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // Returns false at the end of the data, or if it has been truncated
+        bool next
+        (
+            Event& event
+        )
+        {
+            if( !m_isValid || m_pos >= m_data.size() )
+                return false;
+
+            event = Event();
+            event.type = static_cast<Event::Type>( m_data[m_pos++] );
+            switch( event.type )
+            {
+                case Event::GroupStarted:
+                case Event::TestCaseStarted:
+                    event.name = readString();
+                    break;
+                case Event::GroupEnded:
+                    event.name = readString();
+                    event.succeeded = readNumber();
+                    event.failed = readNumber();
+                    break;
+                case Event::TestCaseEnded:
+                    event.name = readString();
+                    event.succeeded = readNumber();
+                    event.failed = readNumber();
+                    event.text = readString();
+                    event.stdErr = readString();
+                    readResourceUsage( event.usage );
+                    break;
+                case Event::SectionStarted:
+                    event.name = readString();
+                    event.text = readString();
+                    break;
+                case Event::SectionEnded:
+                    event.name = readString();
+                    event.succeeded = readNumber();
+                    event.failed = readNumber();
+                    event.text = readString();
+                    event.stdErr = readString();
+                    readResourceUsage( event.usage );
+                    break;
+                case Event::GeneratorCombinationEnded:
+                    event.combination = readNumber();
+                    event.succeeded = readNumber();
+                    event.failed = readNumber();
+                    readResourceUsage( event.usage );
+                    break;
+                case Event::Usage:
+                    readResourceUsage( event.usage );
+                    break;
+                case Event::Result:
+                    readResult( event.result );
+                    break;
+                case Event::StdOut:
+                case Event::StdErr:
+                    event.text = readString();
+                    break;
+                default:
+                    m_isValid = false;
+                    break;
+            }
+            if( m_isValid )
+                m_eventEnd = m_pos;
+            return m_isValid;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        bool isValid
+        ()
+        const
+        {
+            return m_isValid;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // Where the last complete event that was read ends - so where to
+        // carry on from once more of a truncated stream has arrived
+        std::size_t getPosition
+        ()
+        const
+        {
+            return m_eventEnd;
+        }
+
+    private:
+
+        ///////////////////////////////////////////////////////////////////////
+        void readResult
+        (
+            ResultInfo& result
+        )
+        {
+            result.m_macroName = readString();
+            result.m_filename = readString();
+            result.m_line = readNumber();
+            result.m_expr = readString();
+            result.m_lhs = readString();
+            result.m_rhs = readString();
+            result.m_op = readString();
+            result.m_message = readString();
+            result.m_result = static_cast<ResultWas::OfType>( static_cast<int>( readNumber() ) + ResultWas::Unknown );
+            result.m_isNot = readNumber() != 0;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        void readResourceUsage
+        (
+            ResourceUsage& usage
+        )
+        {
+            usage.timed = readNumber() != 0;
+            usage.startMicroseconds = readNumber();
+            usage.durationMicroseconds = readNumber();
+            usage.worker = readNumber();
+            usage.allocationsCounted = readNumber() != 0;
+            usage.allocations = readNumber();
+            usage.deallocations = readNumber();
+            usage.bytesAllocated = readNumber();
+            usage.bytesFreed = readNumber();
+            usage.peakBytes = readNumber();
+            usage.processUsageRecorded = readNumber() != 0;
+            usage.peakRssGrowth = readNumber();
+            usage.minorFaults = readNumber();
+            usage.majorFaults = readNumber();
+            usage.voluntarySwitches = readNumber();
+            usage.involuntarySwitches = readNumber();
+            usage.descriptorsLeaked = readNumber();
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        uint64_t readNumber
+        (
+            char terminator = ';'
+        )
+        {
+            uint64_t number = 0;
+            std::size_t start = m_pos;
+            while( m_pos < m_data.size() && m_data[m_pos] >= '0' && m_data[m_pos] <= '9' )
+                number = number * 10 + static_cast<uint64_t>( m_data[m_pos++] - '0' );
+            if( m_pos == start || m_pos >= m_data.size() || m_data[m_pos] != terminator )
+                m_isValid = false;
+            else
+                ++m_pos;
+            return number;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        std::string readString
+        ()
+        {
+            std::size_t length = readNumber( ':' );
+            if( !m_isValid || m_data.size() - m_pos < length )
+            {
+                m_isValid = false;
+                return "";
+            }
+            m_pos += length;
+            return m_data.substr( m_pos - length, length );
+        }
+
+        const std::string& m_data;
+        std::size_t m_pos;
+        std::size_t m_eventEnd;
+        bool m_isValid;
+    };
+
+} // end namespace Catch
+
+#endif // TWOBLUECUBES_CATCH_EVENT_STREAM_HPP_INCLUDED
@@ -0,0 +1,125 @@
+/*
+ *  catch_eventually.hpp
+ *  Catch
+ *
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * Assertions that keep evaluating their expression until it passes, or time
+ * runs out
+ */
+
+#ifndef TWOBLUECUBES_CATCH_EVENTUALLY_HPP_INCLUDED
+#define TWOBLUECUBES_CATCH_EVENTUALLY_HPP_INCLUDED
+
+#include "catch_capture.hpp"
+#include "catch_threading.hpp"
+#include "catch_timer.hpp"
+
+#include <sstream>
+
+namespace Catch
+{
+    // Drives one of the polling assertion macros, which is a for loop that
+    // evaluates the expression once each time round. Between evaluations
+    // that fail, it sleeps - for a millisecond at first, doubling each time
+    // up to a tenth of a second. Once the deadline has passed, the expression
+    // is evaluated one last time. Only that evaluation, or the one that
+    // passes, is stringified and reported, with how many evaluations there
+    // were and how long they took
+    class Eventually : NonCopyable
+    {
+    public:
+        ///////////////////////////////////////////////////////////////////////
+        explicit Eventually
+        (
+            double seconds
+        )
+        :   m_timeoutMicroseconds( seconds > 0 ? static_cast<uint64_t>( seconds * 1000000.0 + 0.5 ) : 0 ),
+            m_delayMilliseconds( 1 ),
+            m_evaluations( 0 ),
+            m_isLast( seconds <= 0 ),
+            m_isDone( false )
+        {
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        bool isPending
+        ()
+        const
+        {
+            return !m_isDone;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // Whether a failure of the evaluation that's about to happen would be
+        // retried
+        bool isRetrying
+        ()
+        const
+        {
+            return !m_isLast;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        void evaluated
+        (
+            MutableResultInfo& result,
+            bool stopOnFailure
+        )
+        {
+            ++m_evaluations;
+            if( !result.ok() && !m_isLast )
+            {
+                backOff();
+                return;
+            }
+            m_isDone = true;
+
+            std::ostringstream oss;
+            oss << ( result.ok() ? "passed after " : "still failing after " )
+                << m_evaluations << " evaluation(s) in "
+                << m_timer.getElapsedMilliseconds() << " ms";
+            result.setMessage( oss.str() );
+
+            ResultAction::Value action = Hub::getResultCapture().acceptExpression( result );
+            if( ResultAction::shouldDebugBreak( action ) )
+                BreakIntoDebugger();
+            if( ( action != ResultAction::None && stopOnFailure ) || ResultAction::shouldAbort( action ) )
+                throw TestFailureException();
+        }
+
+    private:
+        ///////////////////////////////////////////////////////////////////////
+        void backOff
+        ()
+        {
+            uint64_t elapsed = m_timer.getElapsedMicroseconds();
+            if( elapsed < m_timeoutMicroseconds )
+            {
+                uint64_t remaining = ( m_timeoutMicroseconds - elapsed + 999 ) / 1000;
+                sleepFor( remaining < m_delayMilliseconds ? static_cast<unsigned int>( remaining ) : m_delayMilliseconds );
+                m_delayMilliseconds = m_delayMilliseconds * 2 > 100 ? 100 : m_delayMilliseconds * 2;
+            }
+            m_isLast = m_timer.getElapsedMicroseconds() >= m_timeoutMicroseconds;
+        }
+
+    private:
+        Timer m_timer;
+        uint64_t m_timeoutMicroseconds;
+        unsigned int m_delayMilliseconds;
+        std::size_t m_evaluations;
+        bool m_isLast;
+        bool m_isDone;
+    };
+
+} // end namespace Catch
+
+///////////////////////////////////////////////////////////////////////////////
+#define INTERNAL_CATCH_EVENTUALLY( expr, seconds, stopOnFailure, macroName ) \
+    for( Catch::Eventually INTERNAL_CATCH_UNIQUE_NAME( catch_internal_Eventually )( seconds ); \
+         INTERNAL_CATCH_UNIQUE_NAME( catch_internal_Eventually ).isPending(); ) \
+        INTERNAL_CATCH_UNIQUE_NAME( catch_internal_Eventually ).evaluated( Catch::ResultBuilder( __FILE__, __LINE__, macroName, #expr ) \
+            .setRetrying( INTERNAL_CATCH_UNIQUE_NAME( catch_internal_Eventually ).isRetrying() )->*expr, stopOnFailure )
+
+#endif // TWOBLUECUBES_CATCH_EVENTUALLY_HPP_INCLUDED
@@ -0,0 +1,219 @@
+/*
+ *  catch_fixture_pool.hpp
+ *  Catch
+ *
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * Reuses the fixtures of method based test cases, for fixture classes that
+ * can be reset more cheaply than they can be constructed
+ */
+
+#ifndef TWOBLUECUBES_CATCH_FIXTURE_POOL_HPP_INCLUDED
+#define TWOBLUECUBES_CATCH_FIXTURE_POOL_HPP_INCLUDED
+
+#include "catch_allocation_counter.hpp"
+#include "catch_common.h"
+#include "catch_shared_fixture.hpp"
+#include "catch_threading.hpp"
+
+#include <vector>
+
+namespace Catch
+{
+    // Whether C declares a void reset() of its own. Anything else called
+    // reset - a data member, a reset taking arguments or one inherited from
+    // a base (such as a smart pointer's) - has some other type, so doesn't
+    // match the template argument
+    template<typename C>
+    struct HasReset
+    {
+        template<typename T, T> struct Check;
+
+        template<typename U>
+        static YesType Deduce( Check<void (U::*)(), &U::reset>* );
+        template<typename U>
+        static NoType Deduce( ... );
+
+        enum
+        {
+            value = sizeof( Deduce<C>( NULL ) ) == sizeof( YesType )
+        };
+    };
+
+    // No reset, so each invocation gets a newly constructed fixture
+    template<typename C, bool resettable>
+    class FixturePool
+    {
+    public:
+        ///////////////////////////////////////////////////////////////////////
+        static void invoke
+        (
+            void (C::*method)()
+        )
+        {
+            C obj;
+            (obj.*method)();
+        }
+    };
+
+    // A fixture with a reset() is kept once its invocation is done, and
+    // reset just before it's used again - so a reset() that throws fails the
+    // test that was about to use it. Fixtures only ever get reused by this
+    // process: a worker process constructs its own, and tears them down as
+    // it ends. As a fixture outlives the test case that first uses it, it is
+    // built, reset and pooled with allocation counting paused
+    template<typename C>
+    class FixturePool<C, true> : public ISharedFixture, NonCopyable
+    {
+        // An invocation's hold on a fixture, which goes back in the pool
+        // however the invocation ends
+        class Lease : NonCopyable
+        {
+        public:
+            ///////////////////////////////////////////////////////////////////
+            explicit Lease
+            (
+                FixturePool& pool
+            )
+            :   m_pool( pool ),
+                m_obj( pool.acquire() )
+            {
+            }
+
+            ///////////////////////////////////////////////////////////////////
+            ~Lease
+            ()
+            {
+                m_pool.release( m_obj );
+            }
+
+            ///////////////////////////////////////////////////////////////////
+            C& get
+            ()
+            {
+                return *m_obj;
+            }
+
+        private:
+            FixturePool& m_pool;
+            C* m_obj;
+        };
+
+    public:
+        ///////////////////////////////////////////////////////////////////////
+        static void invoke
+        (
+            void (C::*method)()
+        )
+        {
+            Lease lease( instance() );
+            (lease.get().*method)();
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // Whatever wasn't torn down by the end of the run goes at exit. This
+        // doesn't touch the registry, which may already have been destroyed
+        virtual ~FixturePool
+        ()
+        {
+            deleteAll( m_idle );
+        }
+
+    private:
+        ///////////////////////////////////////////////////////////////////////
+        FixturePool
+        ()
+        :   m_isRegistered( false )
+        {
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        static FixturePool& instance
+        ()
+        {
+            static FixturePool pool;
+            return pool;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        C* acquire
+        ()
+        {
+            AllocationCounter::Pause pause;
+            C* obj = NULL;
+            {
+                ScopedLock lock( m_mutex );
+                if( m_idle.empty() )
+                    return new C;
+                obj = m_idle.back();
+                m_idle.pop_back();
+            }
+            try
+            {
+                obj->reset();
+            }
+            catch(...)
+            {
+                delete obj;
+                throw;
+            }
+            return obj;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        void release
+        (
+            C* obj
+        )
+        {
+            AllocationCounter::Pause pause;
+            bool isFirst = false;
+            {
+                ScopedLock lock( m_mutex );
+                m_idle.push_back( obj );
+                isFirst = !m_isRegistered;
+                m_isRegistered = true;
+            }
+            if( isFirst )
+                SharedFixtures::constructed( *this );
+        }
+
+    private: // ISharedFixture
+
+        ///////////////////////////////////////////////////////////////////////
+        virtual FixtureScope::What getScope
+        ()
+        const
+        {
+            return FixtureScope::Worker;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        virtual void tearDown
+        ()
+        {
+            ScopedLock lock( m_mutex );
+            deleteAll( m_idle );
+            m_idle.clear();
+            m_isRegistered = false;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        virtual void forget
+        ()
+        {
+            ScopedLock lock( m_mutex );
+            m_idle.clear();
+            m_isRegistered = false;
+        }
+
+    private:
+        Mutex m_mutex;
+        std::vector<C*> m_idle;
+        bool m_isRegistered;
+    };
+
+} // end namespace Catch
+
+#endif // TWOBLUECUBES_CATCH_FIXTURE_POOL_HPP_INCLUDED
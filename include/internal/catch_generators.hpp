@@ -14,10 +14,15 @@
 #define TWOBLUECUBES_CATCH_GENERATORS_HPP_INCLUDED
 
 #include "catch_hub.h"
+#include "catch_random.hpp"
 
+#include <cmath>
 #include <iterator>
 #include <vector>
 #include <string>
+#include <utility>
+#include <limits>
+#include <stdexcept>
 #include <stdlib.h>
 
 namespace Catch
@@ -119,8 +124,432 @@ private:
     std::vector<T> m_values;
 };
 
+namespace Detail
+{
+    template<typename T, bool isInteger>
+    struct RangeSteps
+    {
+        ///////////////////////////////////////////////////////////////////////
+        // A quotient that should be whole can come out just short of it -
+        // 0.3 / 0.1 is 2.9999999999999996 - so one within a few ulps of the
+        // next whole number is rounded up to it. Anything further short is
+        // truncated, so the last step never lands past the end of the range
+        static std::size_t count
+        (
+            T from,
+            T to,
+            T step
+        )
+        {
+            T steps = ( to - from ) / step;
+            T whole = std::floor( steps );
+            if( ( whole + 1 ) - steps <= 4 * std::numeric_limits<T>::epsilon() * ( whole + 1 ) )
+                whole += 1;
+            if( whole >= static_cast<T>( (std::numeric_limits<std::size_t>::max)() ) )
+                throw std::domain_error( "range() has more steps than can be counted" );
+            return static_cast<std::size_t>( whole );
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // Computed rather than accumulated, so the steps don't drift, and
+        // kept within the range, so rounding can't take the last value
+        // past the end of it
+        static T at
+        (
+            T from,
+            T to,
+            T step,
+            std::size_t index
+        )
+        {
+            T value = from+static_cast<T>( index )*step;
+            return ( step > T() ? value > to : value < to ) ? to : value;
+        }
+    };
+
+    template<typename T>
+    struct RangeSteps<T, true>
+    {
+        ///////////////////////////////////////////////////////////////////////
+        // In unsigned arithmetic, so a range can span more than half of
+        // what T can hold without overflowing
+        static std::size_t count
+        (
+            T from,
+            T to,
+            T step
+        )
+        {
+            unsigned long distance = step > T()
+                ? static_cast<unsigned long>( to ) - static_cast<unsigned long>( from )
+                : static_cast<unsigned long>( from ) - static_cast<unsigned long>( to );
+            unsigned long stride = step > T()
+                ? static_cast<unsigned long>( step )
+                : 0UL - static_cast<unsigned long>( step );
+            return static_cast<std::size_t>( distance / stride );
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        static T at
+        (
+            T from,
+            T,
+            T step,
+            std::size_t index
+        )
+        {
+            return static_cast<T>( static_cast<unsigned long>( from ) + static_cast<unsigned long>( index ) * static_cast<unsigned long>( step ) );
+        }
+    };
+
+} // end namespace Detail
+
 template<typename T>
-class CompositeGenerator
+class RangeGenerator : public IGenerator<T>
+{
+public:
+    ///////////////////////////////////////////////////////////////////////////
+    RangeGenerator
+    ( 
+        T from, 
+        T to,
+        T step
+    )
+    :   m_from( from ), 
+        m_to( to ),
+        m_step( step ),
+        m_size( 0 )
+    {
+        if( step == T() )
+            throw std::domain_error( "range() requires a non-zero step" );
+        if( step > T() ? from <= to : to <= from )
+            m_size = 1+Detail::RangeSteps<T, std::numeric_limits<T>::is_integer>::count( from, to, step );
+    }
+    
+    ///////////////////////////////////////////////////////////////////////////
+    virtual T getValue
+    (
+        std::size_t index
+    )
+    const
+    {
+        return Detail::RangeSteps<T, std::numeric_limits<T>::is_integer>::at( m_from, m_to, m_step, index );
+    }
+    
+    ///////////////////////////////////////////////////////////////////////////
+    virtual std::size_t size
+    ()
+    const
+    {
+        return m_size;
+    }
+    
+private:
+    
+    T m_from;
+    T m_to;
+    T m_step;
+    std::size_t m_size;
+};
+
+namespace Detail
+{
+    template<typename T, bool isInteger>
+    struct RandomValue
+    {
+        ///////////////////////////////////////////////////////////////////////
+        static T fromBits
+        (
+            unsigned long bits,
+            T from,
+            T to
+        )
+        {
+            double unit = static_cast<double>( bits & 0xffffffffUL ) / 4294967296.0;
+            return from + static_cast<T>( ( to - from ) * unit );
+        }
+    };
+    
+    template<typename T>
+    struct RandomValue<T, true>
+    {
+        ///////////////////////////////////////////////////////////////////////
+        // In unsigned arithmetic, for the same reason as RangeSteps
+        static T fromBits
+        (
+            unsigned long bits,
+            T from,
+            T to
+        )
+        {
+            unsigned long span = static_cast<unsigned long>( to ) - static_cast<unsigned long>( from ) + 1;
+            return span == 0
+                ? static_cast<T>( bits )
+                : static_cast<T>( static_cast<unsigned long>( from ) + bits % span );
+        }
+    };
+    
+} // end namespace Detail
+
+template<typename T>
+class RandomGenerator : public IGenerator<T>
+{
+public:
+    ///////////////////////////////////////////////////////////////////////////
+    RandomGenerator
+    ( 
+        T from, 
+        T to,
+        std::size_t count,
+        unsigned int seed
+    )
+    :   m_from( from ), 
+        m_to( to ),
+        m_count( count ),
+        m_seed( Detail::mixBits( seed ) )
+    {
+    }
+    
+    ///////////////////////////////////////////////////////////////////////////
+    virtual T getValue
+    (
+        std::size_t index
+    )
+    const
+    {
+        unsigned long bits = Detail::mixBits( m_seed, index );
+        if( sizeof( unsigned long ) > 4 )
+            bits = ( bits << 16 << 16 ) | Detail::mixBits( m_seed+1, index );
+        return Detail::RandomValue<T, std::numeric_limits<T>::is_integer>::fromBits( bits, m_from, m_to );
+    }
+    
+    ///////////////////////////////////////////////////////////////////////////
+    virtual std::size_t size
+    ()
+    const
+    {
+        return m_count;
+    }
+    
+private:
+    
+    T m_from;
+    T m_to;
+    std::size_t m_count;
+    unsigned int m_seed;
+};
+
+template<typename T1, typename T2>
+class ProductGenerator : public IGenerator<std::pair<T1, T2> >
+{
+public:
+    ///////////////////////////////////////////////////////////////////////////
+    ProductGenerator
+    ( 
+        const IGenerator<T1>* first, 
+        const IGenerator<T2>* second
+    )
+    :   m_first( first ), 
+        m_second( second )
+    {
+        if( first->size() != 0 && second->size() > (std::numeric_limits<std::size_t>::max)() / first->size() )
+        {
+            delete first;
+            delete second;
+            throw std::domain_error( "product() has more combinations than can be counted" );
+        }
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    ~ProductGenerator
+    ()
+    {
+        delete m_first;
+        delete m_second;
+    }
+    
+    ///////////////////////////////////////////////////////////////////////////
+    virtual std::pair<T1, T2> getValue
+    (
+        std::size_t index
+    )
+    const
+    {
+        std::size_t secondSize = m_second->size();
+        return std::make_pair(  m_first->getValue( index / secondSize ), 
+                                m_second->getValue( index % secondSize ) );
+    }
+    
+    ///////////////////////////////////////////////////////////////////////////
+    virtual std::size_t size
+    ()
+    const
+    {
+        return m_first->size() * m_second->size();
+    }
+    
+private:
+    ProductGenerator( const ProductGenerator& );
+    void operator=( const ProductGenerator& );
+    
+    const IGenerator<T1>* m_first;
+    const IGenerator<T2>* m_second;
+};
+
+template<typename T1, typename T2>
+class ZipGenerator : public IGenerator<std::pair<T1, T2> >
+{
+public:
+    ///////////////////////////////////////////////////////////////////////////
+    ZipGenerator
+    ( 
+        const IGenerator<T1>* first, 
+        const IGenerator<T2>* second
+    )
+    :   m_first( first ), 
+        m_second( second )
+    {
+    }
+    
+    ///////////////////////////////////////////////////////////////////////////
+    ~ZipGenerator
+    ()
+    {
+        delete m_first;
+        delete m_second;
+    }
+    
+    ///////////////////////////////////////////////////////////////////////////
+    virtual std::pair<T1, T2> getValue
+    (
+        std::size_t index
+    )
+    const
+    {
+        return std::make_pair( m_first->getValue( index ), m_second->getValue( index ) );
+    }
+    
+    ///////////////////////////////////////////////////////////////////////////
+    virtual std::size_t size
+    ()
+    const
+    {
+        return (std::min)( m_first->size(), m_second->size() );
+    }
+    
+private:
+    ZipGenerator( const ZipGenerator& );
+    void operator=( const ZipGenerator& );
+    
+    const IGenerator<T1>* m_first;
+    const IGenerator<T2>* m_second;
+};
+
+template<typename T, typename U, typename ArgT>
+class MapGenerator : public IGenerator<U>
+{
+public:
+    ///////////////////////////////////////////////////////////////////////////
+    MapGenerator
+    ( 
+        const IGenerator<T>* source, 
+        U (*function)( ArgT )
+    )
+    :   m_source( source ), 
+        m_function( function )
+    {
+    }
+    
+    ///////////////////////////////////////////////////////////////////////////
+    ~MapGenerator
+    ()
+    {
+        delete m_source;
+    }
+    
+    ///////////////////////////////////////////////////////////////////////////
+    virtual U getValue
+    (
+        std::size_t index
+    )
+    const
+    {
+        return m_function( m_source->getValue( index ) );
+    }
+    
+    ///////////////////////////////////////////////////////////////////////////
+    virtual std::size_t size
+    ()
+    const
+    {
+        return m_source->size();
+    }
+    
+private:
+    MapGenerator( const MapGenerator& );
+    void operator=( const MapGenerator& );
+    
+    const IGenerator<T>* m_source;
+    U (*m_function)( ArgT );
+};
+
+template<typename T, typename ArgT>
+class FilterGenerator : public IGenerator<T>
+{
+public:
+    ///////////////////////////////////////////////////////////////////////////
+    // The size of a filtered range can't be known without running the
+    // predicate, so this is the one generator that does a pass up front.
+    // Only the surviving indices are kept, not the values themselves
+    FilterGenerator
+    ( 
+        const IGenerator<T>* source, 
+        bool (*predicate)( ArgT )
+    )
+    :   m_source( source )
+    {
+        for( std::size_t i = 0; i < source->size(); ++i )
+        {
+            if( predicate( source->getValue( i ) ) )
+                m_indices.push_back( i );
+        }
+    }
+    
+    ///////////////////////////////////////////////////////////////////////////
+    ~FilterGenerator
+    ()
+    {
+        delete m_source;
+    }
+    
+    ///////////////////////////////////////////////////////////////////////////
+    virtual T getValue
+    (
+        std::size_t index
+    )
+    const
+    {
+        return m_source->getValue( m_indices[index] );
+    }
+    
+    ///////////////////////////////////////////////////////////////////////////
+    virtual std::size_t size
+    ()
+    const
+    {
+        return m_indices.size();
+    }
+    
+private:
+    FilterGenerator( const FilterGenerator& );
+    void operator=( const FilterGenerator& );
+    
+    const IGenerator<T>* m_source;
+    std::vector<std::size_t> m_indices;
+};
+
+template<typename T>
+class CompositeGenerator : public IGenerator<T>
 {
 public:
     ///////////////////////////////////////////////////////////////////////////
@@ -160,21 +589,36 @@ public:
     ()
     const
     {
-        size_t overallIndex = Hub::getGeneratorIndex( m_fileInfo, m_totalSize );
-        
-        typename std::vector<const IGenerator<T>*>::const_iterator it = m_composed.begin();
-        typename std::vector<const IGenerator<T>*>::const_iterator itEnd = m_composed.end();
-        for( size_t index = 0; it != itEnd; ++it )
+        if( m_totalSize == 0 )
+            throw std::domain_error( "Generator at " + m_fileInfo + " has no values" );
+        return getValue( Hub::getGeneratorIndex( m_fileInfo, m_totalSize ) );
+    }
+    
+    ///////////////////////////////////////////////////////////////////////////
+    virtual T getValue
+    (
+        std::size_t overallIndex
+    )
+    const
+    {
+        // m_offsets holds the (exclusive) end index of each composed generator,
+        // so the owning generator can be found by binary search
+        std::vector<std::size_t>::const_iterator it = std::upper_bound( m_offsets.begin(), m_offsets.end(), overallIndex );
+        if( it == m_offsets.end() )
         {
-            const IGenerator<T>* generator = *it;
-            if( overallIndex >= index && overallIndex < index + generator->size() )
-            {
-                return generator->getValue( overallIndex-index );
-            }
-            index += generator->size();
+            CATCH_INTERNAL_ERROR( "Indexed past end of generated range" );
         }
-        CATCH_INTERNAL_ERROR( "Indexed past end of generated range" );
-		return T(); // Suppress spurious "not all control paths return a value" warning in Visual Studio - if you know how to fix this please do so
+        std::size_t generatorIndex = static_cast<std::size_t>( it - m_offsets.begin() );
+        std::size_t start = generatorIndex == 0 ? 0 : m_offsets[generatorIndex-1];
+        return m_composed[generatorIndex]->getValue( overallIndex-start );
+    }
+    
+    ///////////////////////////////////////////////////////////////////////////
+    virtual std::size_t size
+    ()
+    const
+    {
+        return m_totalSize;
     }
     
     ///////////////////////////////////////////////////////////////////////////
@@ -185,6 +629,7 @@ public:
     {
         m_totalSize += generator->size();
         m_composed.push_back( generator );
+        m_offsets.push_back( m_totalSize );
     }
     
     ///////////////////////////////////////////////////////////////////////////
@@ -209,6 +654,19 @@ public:
         return *this;
     }
     
+    ///////////////////////////////////////////////////////////////////////////
+    // Transfers ownership of everything composed so far into a new, heap 
+    // allocated, generator - so it can itself be composed into another one
+    static const IGenerator<T>* release
+    (
+        const CompositeGenerator& other
+    )
+    {
+        // Temporaries are not const objects, so this is safe for the 
+        // generator expressions these are used in
+        return new CompositeGenerator( const_cast<CompositeGenerator&>( other ) );
+    }
+    
 private:
     
     ///////////////////////////////////////////////////////////////////////////
@@ -217,12 +675,17 @@ private:
         CompositeGenerator& other
     )
     {
-        std::copy( other.m_composed.begin(), other.m_composed.end(), std::back_inserter( m_composed ) );
-        m_totalSize += other.m_totalSize;
+        typename std::vector<const IGenerator<T>*>::const_iterator it = other.m_composed.begin();
+        typename std::vector<const IGenerator<T>*>::const_iterator itEnd = other.m_composed.end();
+        for(; it != itEnd; ++it )
+            add( *it );
         other.m_composed.clear();
+        other.m_offsets.clear();
+        other.m_totalSize = 0;
     }
     
     std::vector<const IGenerator<T>*> m_composed;
+    std::vector<std::size_t> m_offsets;
     std::string m_fileInfo;
     size_t m_totalSize;
 };
@@ -296,6 +759,89 @@ namespace Generators
         return generators;
     }
 
+    ///////////////////////////////////////////////////////////////////////////
+    template<typename T>
+    CompositeGenerator<T> range
+    (
+        T from, 
+        T to,
+        T step
+    )
+    {
+        CompositeGenerator<T> generators;
+        generators.add( new RangeGenerator<T>( from, to, step ) );
+        return generators;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    template<typename T>
+    CompositeGenerator<T> random
+    (
+        T from, 
+        T to,
+        std::size_t count,
+        unsigned int seed
+    )
+    {
+        CompositeGenerator<T> generators;
+        generators.add( new RandomGenerator<T>( from, to, count, seed ) );
+        return generators;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    template<typename T1, typename T2>
+    CompositeGenerator<std::pair<T1, T2> > product
+    (
+        const CompositeGenerator<T1>& first, 
+        const CompositeGenerator<T2>& second
+    )
+    {
+        CompositeGenerator<std::pair<T1, T2> > generators;
+        generators.add( new ProductGenerator<T1, T2>(   CompositeGenerator<T1>::release( first ), 
+                                                        CompositeGenerator<T2>::release( second ) ) );
+        return generators;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    template<typename T1, typename T2>
+    CompositeGenerator<std::pair<T1, T2> > zip
+    (
+        const CompositeGenerator<T1>& first, 
+        const CompositeGenerator<T2>& second
+    )
+    {
+        CompositeGenerator<std::pair<T1, T2> > generators;
+        generators.add( new ZipGenerator<T1, T2>(   CompositeGenerator<T1>::release( first ), 
+                                                    CompositeGenerator<T2>::release( second ) ) );
+        return generators;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    template<typename T, typename U, typename ArgT>
+    CompositeGenerator<U> map
+    (
+        const CompositeGenerator<T>& source, 
+        U (*function)( ArgT )
+    )
+    {
+        CompositeGenerator<U> generators;
+        generators.add( new MapGenerator<T, U, ArgT>( CompositeGenerator<T>::release( source ), function ) );
+        return generators;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    template<typename T, typename ArgT>
+    CompositeGenerator<T> filter
+    (
+        const CompositeGenerator<T>& source, 
+        bool (*predicate)( ArgT )
+    )
+    {
+        CompositeGenerator<T> generators;
+        generators.add( new FilterGenerator<T, ArgT>( CompositeGenerator<T>::release( source ), predicate ) );
+        return generators;
+    }
+
 } // end namespace Generators
     
 using namespace Generators;
@@ -53,6 +53,15 @@ namespace Catch
             return m_currentIndex;
         }
         
+        ///////////////////////////////////////////////////////////////////////        
+        void setCurrentIndex
+        (
+            std::size_t index
+        )
+        {
+            m_currentIndex = index;
+        }
+        
         std::size_t m_size;
         std::size_t m_currentIndex;
     };
@@ -103,6 +112,37 @@ namespace Catch
             return false;
         }
         
+        ///////////////////////////////////////////////////////////////////////        
+        // The number of distinct combinations of all the generators seen so far
+        std::size_t getCombinationCount
+        ()
+        const
+        {
+            std::size_t count = 1;
+            std::vector<GeneratorInfo*>::const_iterator it = m_generatorsInOrder.begin();
+            std::vector<GeneratorInfo*>::const_iterator itEnd = m_generatorsInOrder.end();
+            for(; it != itEnd; ++it )
+                count *= (*it)->m_size;
+            return count;
+        }
+        
+        ///////////////////////////////////////////////////////////////////////        
+        // Jumps straight to the combination that moveNext() would reach after
+        // combinationIndex calls. The first generator varies fastest
+        void setCombination
+        (
+            std::size_t combinationIndex
+        )
+        {
+            std::vector<GeneratorInfo*>::const_iterator it = m_generatorsInOrder.begin();
+            std::vector<GeneratorInfo*>::const_iterator itEnd = m_generatorsInOrder.end();
+            for(; it != itEnd; ++it )
+            {
+                (*it)->setCurrentIndex( combinationIndex % (*it)->m_size );
+                combinationIndex /= (*it)->m_size;
+            }
+        }
+        
     private:
         std::map<std::string, GeneratorInfo*> m_generatorsByName;
         std::vector<GeneratorInfo*> m_generatorsInOrder;
@@ -77,6 +77,13 @@ namespace Catch
         static bool advanceGeneratorsForCurrentTest
             ();
         
+        static std::size_t getGeneratorCombinationCount
+            ();
+        
+        static void setGeneratorCombination
+            (   std::size_t combinationIndex
+            );
+        
     private:
         GeneratorsForTest* findGeneratorsForCurrentTest
             ();
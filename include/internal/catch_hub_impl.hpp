@@ -128,6 +128,8 @@ namespace Catch
         size_t totalSize 
     )
     {
+        // The generators' positions outlive the test, so aren't its allocations
+        AllocationCounter::Pause pause;
         return me().getGeneratorsForCurrentTest()
             .getGeneratorInfo( fileInfo, totalSize )
             .getCurrentIndex();
@@ -140,4 +142,23 @@ namespace Catch
         GeneratorsForTest* generators = me().findGeneratorsForCurrentTest();
         return generators && generators->moveNext();
     }
+
+    ///////////////////////////////////////////////////////////////////////////
+    std::size_t Hub::getGeneratorCombinationCount
+    ()
+    {
+        GeneratorsForTest* generators = me().findGeneratorsForCurrentTest();
+        return generators ? generators->getCombinationCount() : 1;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    void Hub::setGeneratorCombination
+    (
+        std::size_t combinationIndex
+    )
+    {
+        GeneratorsForTest* generators = me().findGeneratorsForCurrentTest();
+        if( generators )
+            generators->setCombination( combinationIndex );
+    }
 }
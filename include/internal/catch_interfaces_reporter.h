@@ -14,6 +14,8 @@
 #define TWOBLUECUBES_CATCH_IREPORTERREGISTRY_INCLUDED
 
 #include "catch_common.h"
+#include "catch_repeat_stats.hpp"
+#include "catch_resource_usage.hpp"
 
 #include <string>
 #include <ostream>
@@ -36,6 +38,14 @@ namespace Catch
 
         virtual std::string getName
             () const = 0;
+
+        // Non-zero if the tests are being run in a random order
+        virtual unsigned int getRngSeed
+            () const = 0;
+
+        // Empty unless stream() writes to this file
+        virtual const std::string& getFilename
+            () const = 0;
     };
     
     class TestCaseInfo;
@@ -73,7 +83,20 @@ namespace Catch
         virtual void EndSection
             (   const std::string& sectionName, 
                 std::size_t succeeded, 
-                std::size_t failed 
+                std::size_t failed,
+                const std::string& stdOut, 
+                const std::string& stdErr,
+                const ResourceUsage& usage 
+            ) = 0;
+
+        // Called once each combination of a test case's generators has run
+        // and its sections and results have been reported. Not called for
+        // test cases without generators
+        virtual void EndGeneratorCombination
+            (   std::size_t combination,
+                std::size_t succeeded,
+                std::size_t failed,
+                const ResourceUsage& usage
             ) = 0;
         
         virtual void StartTestCase
@@ -85,12 +108,19 @@ namespace Catch
                 std::size_t succeeded, 
                 std::size_t failed,
                 const std::string& stdOut, 
-                const std::string& stdErr 
+                const std::string& stdErr,
+                const ResourceUsage& usage 
             ) = 0;
         
         virtual void Result
             (   const ResultInfo& result 
             ) = 0;
+
+        // Called for each test case once a run made with --repeat or
+        // --until-fail has finished repeating, before EndTesting
+        virtual void TestCaseRepeated
+            (   const RepeatStats& stats
+            ) = 0;
     };
     
     ///////////////////////////////////////////////////////////////////////////
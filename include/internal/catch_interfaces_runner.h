@@ -37,6 +37,19 @@ namespace Catch
         
         virtual std:: size_t getFailureCount
             () const = 0;
+
+        // Non-zero if the tests are being run in a random order
+        virtual unsigned int getRngSeed
+            () const = 0;
+
+        // Non-zero if the one thread schedule with this seed is to be
+        // replayed by each INTERLEAVING_TEST_CASE
+        virtual unsigned int getScheduleSeed
+            () const = 0;
+
+        // Non-zero if each PROPERTY is to generate its values from this seed
+        virtual unsigned int getPropertySeed
+            () const = 0;
         
     };
 }
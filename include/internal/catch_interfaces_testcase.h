@@ -23,6 +23,13 @@ namespace Catch
         ()
         {}
         
+        // Called before any of the test cases that are about to run is
+        // invoked. Only a test case that runs asynchronously does anything,
+        // starting so it can make progress while others are invoked
+        virtual void start
+            () const
+        {}
+
         virtual void invoke
             () const = 0;
         
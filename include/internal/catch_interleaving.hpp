@@ -0,0 +1,959 @@
+/*
+ *  catch_interleaving.hpp
+ *  Catch
+ *
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * Runs a test's threads one at a time, switching between them in a seeded
+ * order, so races can be searched for and the schedule that found one replayed
+ */
+
+#ifndef TWOBLUECUBES_CATCH_INTERLEAVING_HPP_INCLUDED
+#define TWOBLUECUBES_CATCH_INTERLEAVING_HPP_INCLUDED
+
+#include "catch_capture.hpp"
+#include "catch_interfaces_exception.h"
+#include "catch_interfaces_runner.h"
+#include "catch_property.hpp"
+#include "catch_random.hpp"
+#include "catch_test_registry.hpp"
+#include "catch_threading.hpp"
+
+#include <exception>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace Catch
+{
+namespace Detail
+{
+    // Thrown on a scheduled thread to unwind it when its schedule has been
+    // abandoned
+    struct InterleavingAborted
+    {
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Runs each thread on a thread of its own, but only lets one run at a
+    // time. A running thread carries on until its next scheduling point
+    // (CATCH_YIELD, or an operation on one of the shims), where the
+    // scheduler picks which thread goes next.
+    //
+    // The pick follows PCT (Probabilistic Concurrency Testing - Burckhardt
+    // et al): each thread is given a distinct priority, in a random order,
+    // and the highest priority thread that isn't waiting for a mutex always
+    // runs. At depth-1 random steps the running thread drops below all of the
+    // others. Every bug that needs at most depth ordering constraints to show
+    // itself has a good chance of being hit by each schedule, and the seed
+    // alone decides the schedule
+    class InterleavingScheduler : NonCopyable
+    {
+        ///////////////////////////////////////////////////////////////////////
+        class ScheduledThread : public IRunnable
+        {
+        public:
+            ///////////////////////////////////////////////////////////////////
+            ScheduledThread
+            (
+                InterleavingScheduler& scheduler,
+                IRunnable& body_,
+                std::size_t index_,
+                std::size_t priority_
+            )
+            :   body( &body_ ),
+                index( index_ ),
+                priority( priority_ ),
+                id(),
+                isRegistered( false ),
+                isFinished( false ),
+                blockedOn( NULL ),
+                m_scheduler( scheduler )
+            {
+            }
+
+            ///////////////////////////////////////////////////////////////////
+            virtual void run
+            ()
+            {
+                m_scheduler.runThread( *this );
+            }
+
+            Thread thread;
+            IRunnable* body;
+            std::size_t index;
+            std::size_t priority;
+            ThreadId id;
+            bool isRegistered;
+            bool isFinished;
+
+            // The locked flag of the mutex the thread is waiting for
+            const bool* blockedOn;
+
+        private:
+            InterleavingScheduler& m_scheduler;
+        };
+
+        enum { None = static_cast<std::size_t>( -1 ) };
+
+    public:
+        ///////////////////////////////////////////////////////////////////////
+        // expectedSteps is roughly how many scheduling points a schedule has,
+        // which the change points are spread over
+        InterleavingScheduler
+        (
+            const std::vector<IRunnable*>& bodies,
+            unsigned int seed,
+            std::size_t depth,
+            std::size_t expectedSteps,
+            std::size_t maxSteps,
+            const std::string& filename,
+            std::size_t line
+        )
+        :   m_running( None ),
+            m_registered( 0 ),
+            m_steps( 0 ),
+            m_maxSteps( maxSteps ),
+            m_isAborting( false ),
+            m_requireFailed( false ),
+            m_filename( filename ),
+            m_line( line )
+        {
+            // Initial priorities are all above the ones change points lower
+            // a thread to
+            SeededRandom rng( seed );
+            std::vector<std::size_t> priorities;
+            for( std::size_t i = 0; i < bodies.size(); ++i )
+                priorities.push_back( depth + i );
+            shuffle( priorities, rng );
+            for( std::size_t i = 0; i < bodies.size(); ++i )
+                m_threads.push_back( new ScheduledThread( *this, *bodies[i], i, priorities[i] ) );
+            for( std::size_t i = 1; i < depth; ++i )
+                m_changePoints.push_back( 1 + rng.below( expectedSteps > 0 ? expectedSteps : 1 ) );
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        ~InterleavingScheduler
+        ()
+        {
+            for( std::size_t i = 0; i < m_threads.size(); ++i )
+                delete m_threads[i];
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // The scheduler the calling thread belongs to, if any, and its index
+        static InterleavingScheduler* find
+        (
+            std::size_t& index
+        )
+        {
+            InterleavingScheduler* scheduler = current();
+            if( scheduler == NULL )
+                return NULL;
+
+            ScopedLock lock( scheduler->m_mutex );
+            ThreadId id = getCurrentThreadId();
+            for( std::size_t i = 0; i < scheduler->m_threads.size(); ++i )
+            {
+                const ScheduledThread& thread = *scheduler->m_threads[i];
+                if( thread.isRegistered && !thread.isFinished && isSameThread( thread.id, id ) )
+                {
+                    index = i;
+                    return scheduler;
+                }
+            }
+            return NULL;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // Runs all of the threads to the end. Returns why the schedule was
+        // abandoned, if it was
+        std::string run
+        ()
+        {
+            current() = this;
+            try
+            {
+                ScopedLock lock( m_mutex );
+                std::size_t started = 0;
+                for( std::size_t i = 0; i < m_threads.size(); ++i )
+                {
+                    if( m_threads[i]->thread.start( *m_threads[i] ) )
+                    {
+                        ++started;
+                    }
+                    else
+                    {
+                        m_threads[i]->isFinished = true;
+                        abort( "Couldn't start a thread" );
+                    }
+                }
+                while( m_registered < started )
+                    m_changed.wait( m_mutex );
+                pickNext();
+                while( !isFinished() )
+                    m_changed.wait( m_mutex );
+            }
+            catch( ... )
+            {
+                // Cancelled by the watchdog - the threads mustn't outlive us
+                {
+                    ScopedLock lock( m_mutex );
+                    abort( "Cancelled" );
+                    pickNext();
+                }
+                joinThreads();
+                current() = NULL;
+                throw;
+            }
+            joinThreads();
+            current() = NULL;
+            return m_abortReason;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // A scheduling point. Only throws (to unwind the thread) if the
+        // schedule is abandoned while the thread is waiting, and mayThrow
+        void yield
+        (
+            std::size_t index,
+            bool mayThrow = true
+        )
+        {
+            ScopedLock lock( m_mutex );
+            step( *m_threads[index] );
+            waitForTurn( *m_threads[index], mayThrow );
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // A scheduling point, after which the thread waits until locked is
+        // false
+        void waitUntilFree
+        (
+            std::size_t index,
+            const bool& locked
+        )
+        {
+            ScheduledThread& thread = *m_threads[index];
+            ScopedLock lock( m_mutex );
+            step( thread );
+            waitForTurn( thread, true );
+            while( locked && !m_isAborting )
+            {
+                thread.blockedOn = &locked;
+                pickNext();
+                waitForTurn( thread, true );
+                thread.blockedOn = NULL;
+            }
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        std::size_t getSteps
+        ()
+        const
+        {
+            return m_steps;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        bool requireFailed
+        ()
+        const
+        {
+            return m_requireFailed;
+        }
+
+    private:
+
+        ///////////////////////////////////////////////////////////////////////
+        static InterleavingScheduler*& current
+        ()
+        {
+            static InterleavingScheduler* scheduler = NULL;
+            return scheduler;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        void runThread
+        (
+            ScheduledThread& thread
+        )
+        {
+            try
+            {
+                {
+                    ScopedLock lock( m_mutex );
+                    thread.id = getCurrentThreadId();
+                    thread.isRegistered = true;
+                    ++m_registered;
+                    m_changed.notifyAll();
+                    waitForTurn( thread, true );
+                }
+                thread.body->run();
+            }
+            catch( InterleavingAborted& )
+            {
+            }
+            catch( TestFailureException& )
+            {
+                // A REQUIRE failed (already reported), which ends the test
+                ScopedLock lock( m_mutex );
+                m_requireFailed = true;
+                abort( "" );
+            }
+            catch( ... )
+            {
+                Hub::getResultCapture().acceptExpression( ( ResultBuilder( m_filename.c_str(), m_line, "INTERLEAVING" )
+                    << Hub::getExceptionTranslatorRegistry().translateActiveException() ).setResultType( ResultWas::ThrewException ) );
+            }
+
+            ScopedLock lock( m_mutex );
+            thread.isFinished = true;
+            thread.blockedOn = NULL;
+            pickNext();
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // m_mutex must be locked, by the running thread
+        void step
+        (
+            ScheduledThread& thread
+        )
+        {
+            if( m_isAborting )
+                return;
+            ++m_steps;
+            if( m_steps > m_maxSteps )
+            {
+                std::ostringstream oss;
+                oss << "Gave up after " << m_maxSteps << " scheduling steps - is a thread spinning, "
+                    << "waiting for one that this schedule never runs?";
+                abort( oss.str() );
+                return;
+            }
+            for( std::size_t i = 0; i < m_changePoints.size(); ++i )
+                if( m_changePoints[i] == m_steps )
+                    thread.priority = i;
+            pickNext();
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // m_mutex must be locked. Once the schedule is being abandoned, the
+        // threads that are left are let go one at a time, to unwind
+        void pickNext
+        ()
+        {
+            std::size_t next = None;
+            std::size_t unfinished = None;
+            for( std::size_t i = 0; i < m_threads.size(); ++i )
+            {
+                const ScheduledThread& thread = *m_threads[i];
+                if( thread.isFinished )
+                    continue;
+                if( unfinished == None )
+                    unfinished = i;
+                if( thread.blockedOn != NULL && *thread.blockedOn )
+                    continue;
+                if( next == None || thread.priority > m_threads[next]->priority )
+                    next = i;
+            }
+            if( unfinished != None && ( next == None || m_isAborting ) )
+            {
+                if( next == None )
+                    abort( "Deadlock - every unfinished thread is waiting for a mutex" );
+                next = unfinished;
+            }
+            m_running = next;
+            m_changed.notifyAll();
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // m_mutex must be locked
+        void waitForTurn
+        (
+            const ScheduledThread& thread,
+            bool mayThrow
+        )
+        {
+            while( m_running != thread.index )
+                m_changed.wait( m_mutex );
+            if( m_isAborting && mayThrow && !isUnwinding() )
+                throw InterleavingAborted();
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // A thread that is already unwinding mustn't be thrown through again
+        static bool isUnwinding
+        ()
+        {
+#if __cplusplus >= 201703L
+            return std::uncaught_exceptions() > 0;
+#else
+            return std::uncaught_exception();
+#endif
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // m_mutex must be locked. Only the first reason is kept
+        void abort
+        (
+            const std::string& reason
+        )
+        {
+            if( !m_isAborting )
+                m_abortReason = reason;
+            m_isAborting = true;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // m_mutex must be locked
+        bool isFinished
+        ()
+        const
+        {
+            for( std::size_t i = 0; i < m_threads.size(); ++i )
+                if( !m_threads[i]->isFinished )
+                    return false;
+            return true;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        void joinThreads
+        ()
+        {
+            for( std::size_t i = 0; i < m_threads.size(); ++i )
+                m_threads[i]->thread.join();
+        }
+
+        Mutex m_mutex;
+        ConditionVariable m_changed;
+        std::vector<ScheduledThread*> m_threads;
+        std::vector<std::size_t> m_changePoints;
+        std::size_t m_running;
+        std::size_t m_registered;
+        std::size_t m_steps;
+        std::size_t m_maxSteps;
+        bool m_isAborting;
+        bool m_requireFailed;
+        std::string m_abortReason;
+        std::string m_filename;
+        std::size_t m_line;
+    };
+
+} // end namespace Detail
+
+///////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+// Runs a test's threads under the scheduler. Within an INTERLEAVING_TEST_CASE
+// each run of the test body is given the schedule being explored - elsewhere
+// the threads are run under a single, fixed, schedule.
+//
+// Only the threads started here are scheduled, and they only switch at
+// CATCH_YIELD() and at the operations of InterleavedMutex and Interleaved<T>.
+// Those shims behave as an ordinary mutex and atomic on any other thread
+class Interleaving
+{
+public:
+    struct Settings
+    {
+        ///////////////////////////////////////////////////////////////////////
+        Settings
+        ()
+        :   seed( 0 ),
+            depth( 3 ),
+            expectedSteps( 100 ),
+            maxSteps( 100000 ),
+            line( 0 ),
+            stepsTaken( 0 )
+        {
+        }
+
+        unsigned int seed;
+        std::size_t depth;
+        std::size_t expectedSteps;
+        std::size_t maxSteps;
+
+        // Where exceptions thrown by the threads are reported
+        std::string filename;
+        std::size_t line;
+
+        // Counts the scheduling steps of every run() since it was reset
+        std::size_t stepsTaken;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Sets how threads are scheduled for as long as it is in scope
+    class Scope : NonCopyable
+    {
+    public:
+        ///////////////////////////////////////////////////////////////////////
+        explicit Scope
+        (
+            const Settings& settings
+        )
+        :   m_previous( Interleaving::settings() )
+        {
+            Interleaving::settings() = settings;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        ~Scope
+        ()
+        {
+            Interleaving::settings() = m_previous;
+        }
+
+    private:
+        Settings m_previous;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    static Settings& settings
+    ()
+    {
+        static Settings s;
+        return s;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // A scheduling point, if called from a scheduled thread
+    static void yield
+    ()
+    {
+        std::size_t index = 0;
+        if( Detail::InterleavingScheduler* scheduler = Detail::InterleavingScheduler::find( index ) )
+            scheduler->yield( index );
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    static void run
+    (
+        IRunnable& first,
+        IRunnable& second
+    )
+    {
+        std::vector<IRunnable*> threads;
+        threads.push_back( &first );
+        threads.push_back( &second );
+        run( threads );
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    static void run
+    (
+        IRunnable& first,
+        IRunnable& second,
+        IRunnable& third
+    )
+    {
+        std::vector<IRunnable*> threads;
+        threads.push_back( &first );
+        threads.push_back( &second );
+        threads.push_back( &third );
+        run( threads );
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Returns once every thread has finished. A schedule that deadlocks, or
+    // never finishes, is reported as a failure
+    static void run
+    (
+        const std::vector<IRunnable*>& threads
+    )
+    {
+        Settings& s = settings();
+        Detail::InterleavingScheduler scheduler( threads, s.seed, s.depth, s.expectedSteps, s.maxSteps, s.filename, s.line );
+        std::string abandoned = scheduler.run();
+        s.stepsTaken += scheduler.getSteps();
+
+        if( !abandoned.empty() )
+            Hub::getResultCapture().acceptExpression( ( ResultBuilder( s.filename.c_str(), s.line, "INTERLEAVING" ) << abandoned ).setResultType( ResultWas::ExplicitFailure ) );
+        if( scheduler.requireFailed() )
+            throw TestFailureException();
+    }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+class InterleavedMutex : NonCopyable
+{
+public:
+    ///////////////////////////////////////////////////////////////////////////
+    class Lock : NonCopyable
+    {
+    public:
+        ///////////////////////////////////////////////////////////////////////
+        explicit Lock
+        (
+            InterleavedMutex& mutex
+        )
+        :   m_mutex( mutex )
+        {
+            m_mutex.lock();
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        ~Lock
+        ()
+        {
+            m_mutex.unlock();
+        }
+
+    private:
+        InterleavedMutex& m_mutex;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    InterleavedMutex
+    ()
+    :   m_isLocked( false )
+    {
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    void lock
+    ()
+    {
+        std::size_t index = 0;
+        if( Detail::InterleavingScheduler* scheduler = Detail::InterleavingScheduler::find( index ) )
+            scheduler->waitUntilFree( index, m_isLocked );
+        else
+            m_mutex.lock();
+        m_isLocked = true;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Never throws, so it is safe to call from a destructor
+    void unlock
+    ()
+    {
+        std::size_t index = 0;
+        if( Detail::InterleavingScheduler* scheduler = Detail::InterleavingScheduler::find( index ) )
+        {
+            scheduler->yield( index, false );
+            m_isLocked = false;
+        }
+        else
+        {
+            m_isLocked = false;
+            m_mutex.unlock();
+        }
+    }
+
+private:
+    Mutex m_mutex;
+    bool m_isLocked;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+// Each operation is atomic, and a scheduling point
+template<typename T>
+class Interleaved : NonCopyable
+{
+public:
+    ///////////////////////////////////////////////////////////////////////////
+    explicit Interleaved
+    (
+        T value = T()
+    )
+    :   m_value( value )
+    {
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    T load
+    ()
+    const
+    {
+        Interleaving::yield();
+        ScopedLock lock( m_mutex );
+        return m_value;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    void store
+    (
+        T value
+    )
+    {
+        Interleaving::yield();
+        ScopedLock lock( m_mutex );
+        m_value = value;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    T exchange
+    (
+        T value
+    )
+    {
+        Interleaving::yield();
+        ScopedLock lock( m_mutex );
+        T previous = m_value;
+        m_value = value;
+        return previous;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // If the value is expected, replaces it with desired. Otherwise
+    // expected is set to the value
+    bool compareExchange
+    (
+        T& expected,
+        T desired
+    )
+    {
+        Interleaving::yield();
+        ScopedLock lock( m_mutex );
+        if( !( m_value == expected ) )
+        {
+            expected = m_value;
+            return false;
+        }
+        m_value = desired;
+        return true;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    T fetchAdd
+    (
+        T delta
+    )
+    {
+        Interleaving::yield();
+        ScopedLock lock( m_mutex );
+        T previous = m_value;
+        m_value = m_value + delta;
+        return previous;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    T fetchSub
+    (
+        T delta
+    )
+    {
+        Interleaving::yield();
+        ScopedLock lock( m_mutex );
+        T previous = m_value;
+        m_value = m_value - delta;
+        return previous;
+    }
+
+private:
+    mutable Mutex m_mutex;
+    T m_value;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+// Runs a test body (which runs its threads with Interleaving::run) under one
+// schedule after another, silently, until one fails. That schedule is then
+// replayed for real, so its failures are reported as usual, along with the
+// seed that --schedule replays it with. Before exploring, the body is run
+// once to count its scheduling points, which the change points are spread
+// over - so the seed alone decides the schedule
+class InterleavingTest
+{
+public:
+    typedef void (*InterleavingFunction)();
+
+    ///////////////////////////////////////////////////////////////////////////
+    InterleavingTest
+    (
+        const std::string& name,
+        const char* filename,
+        std::size_t line,
+        InterleavingFunction function,
+        std::size_t schedules = 100
+    )
+    :   m_function( function ),
+        m_schedules( schedules ),
+        m_seed( Detail::hashName( name ) )
+    {
+        m_settings.filename = filename;
+        m_settings.line = line;
+
+        // As with PROPERTY, a randomised run explores different schedules
+        if( unsigned int rngSeed = Hub::getRunner().getRngSeed() )
+            m_seed = Detail::mixBits( m_seed ^ rngSeed );
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // How many ordering constraints a bug may need and still be likely to
+    // be found (3 by default)
+    InterleavingTest& withDepth
+    (
+        std::size_t depth
+    )
+    {
+        m_settings.depth = depth > 0 ? depth : 1;
+        return *this;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    InterleavingTest& withMaxSteps
+    (
+        std::size_t maxSteps
+    )
+    {
+        m_settings.maxSteps = maxSteps;
+        return *this;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    void explore
+    ()
+    {
+        calibrate();
+
+        if( unsigned int scheduleSeed = Hub::getRunner().getScheduleSeed() )
+        {
+            std::size_t prevFailures = Hub::getRunner().getFailureCount();
+            runSchedule( scheduleSeed );
+            if( Hub::getRunner().getFailureCount() == prevFailures )
+            {
+                std::ostringstream oss;
+                oss << "replayed schedule " << scheduleSeed;
+                accept( ResultWas::Ok, oss.str() );
+            }
+            return;
+        }
+
+        for( std::size_t i = 0; i < m_schedules; ++i )
+        {
+            unsigned int scheduleSeed = getScheduleSeed( i );
+            if( !holds( scheduleSeed ) )
+                return reportFailingSchedule( scheduleSeed, i+1 );
+        }
+        std::ostringstream oss;
+        oss << "explored " << m_schedules << " schedule(s) (seed: " << m_seed << ")";
+        accept( ResultWas::Ok, oss.str() );
+    }
+
+private:
+
+    ///////////////////////////////////////////////////////////////////////////
+    unsigned int getScheduleSeed
+    (
+        std::size_t index
+    )
+    const
+    {
+        return Detail::mixBits( m_seed, index ) | 1;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Runs the body once, without change points, to see how many
+    // scheduling points it has
+    void calibrate
+    ()
+    {
+        Interleaving::Settings settings( m_settings );
+        settings.seed = m_seed;
+        settings.depth = 1;
+        {
+            Interleaving::Scope scope( settings );
+            Detail::SilentResultCapture capture;
+            try
+            {
+                m_function();
+            }
+            catch( ... )
+            {
+            }
+            settings.stepsTaken = Interleaving::settings().stepsTaken;
+        }
+        m_settings.expectedSteps = settings.stepsTaken > 0 ? settings.stepsTaken : 1;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    void runSchedule
+    (
+        unsigned int scheduleSeed
+    )
+    const
+    {
+        Interleaving::Settings settings( m_settings );
+        settings.seed = scheduleSeed;
+        Interleaving::Scope scope( settings );
+        m_function();
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    bool holds
+    (
+        unsigned int scheduleSeed
+    )
+    const
+    {
+        Detail::SilentResultCapture capture;
+        try
+        {
+            runSchedule( scheduleSeed );
+        }
+        catch( TestFailureException& )
+        {
+            // REQUIRE failed - already noted by the capture
+        }
+        catch( ... )
+        {
+            capture.fail();
+        }
+        return !capture.failed();
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    void reportFailingSchedule
+    (
+        unsigned int scheduleSeed,
+        std::size_t schedulesRun
+    )
+    const
+    {
+        std::ostringstream oss;
+        oss << "Failed on schedule " << schedulesRun << " of " << m_schedules
+            << " (seed: " << m_seed << ") - replay it with --schedule " << scheduleSeed;
+        accept( ResultWas::Info, oss.str() );
+
+        std::size_t prevFailures = Hub::getRunner().getFailureCount();
+        runSchedule( scheduleSeed );
+        if( Hub::getRunner().getFailureCount() == prevFailures )
+            accept( ResultWas::ExplicitFailure, "schedule did not fail when replayed - does the test depend on more than the schedule?" );
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    void accept
+    (
+        ResultWas::OfType resultType,
+        const std::string& message
+    )
+    const
+    {
+        Hub::getResultCapture().acceptExpression( ( ResultBuilder( m_settings.filename.c_str(), m_settings.line, "INTERLEAVING" ) << message ).setResultType( resultType ) );
+    }
+
+    InterleavingFunction m_function;
+    std::size_t m_schedules;
+    unsigned int m_seed;
+    Interleaving::Settings m_settings;
+};
+
+} // end namespace Catch
+
+///////////////////////////////////////////////////////////////////////////////
+#define INTERNAL_CATCH_INTERLEAVING_TESTCASE( Name, Desc, Schedules ) \
+    static void INTERNAL_CATCH_UNIQUE_NAME( catch_internal_InterleavingFunction )(); \
+    INTERNAL_CATCH_TESTCASE( Name, Desc ) \
+    { \
+        Catch::InterleavingTest( Name, __FILE__, __LINE__, &INTERNAL_CATCH_UNIQUE_NAME( catch_internal_InterleavingFunction ), Schedules ).explore(); \
+    } \
+    static void INTERNAL_CATCH_UNIQUE_NAME( catch_internal_InterleavingFunction )()
+
+#endif // TWOBLUECUBES_CATCH_INTERLEAVING_HPP_INCLUDED
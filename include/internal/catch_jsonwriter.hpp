@@ -0,0 +1,317 @@
+/*
+ *  catch_jsonwriter.hpp
+ *  Catch
+ *
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ *
+ */
+#ifndef TWOBLUECUBES_CATCH_JSONWRITER_HPP_INCLUDED
+#define TWOBLUECUBES_CATCH_JSONWRITER_HPP_INCLUDED
+
+#include <cstring>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace Catch
+{
+    // Writes JSON objects, one per line (JSON Lines). Objects are flat, apart
+    // from any fields that are objects themselves. Everything is written
+    // straight to the stream - nothing is built up in memory first
+    class JsonLineWriter
+    {
+    public:
+        ///////////////////////////////////////////////////////////////////////
+        JsonLineWriter
+        ()
+        :   m_os( NULL ),
+            m_isFirstField( true )
+        {
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        explicit JsonLineWriter
+        (
+            std::ostream& os
+        )
+        :   m_os( &os ),
+            m_isFirstField( true )
+        {
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        JsonLineWriter& startObject
+        ()
+        {
+            stream() << '{';
+            m_isFirstField = true;
+            return *this;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        void endObject
+        ()
+        {
+            stream() << "}\n";
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        JsonLineWriter& writeField
+        (
+            const char* name,
+            const std::string& value
+        )
+        {
+            writeName( name );
+            stream() << '"';
+            writeEscaped( value.data(), value.size() );
+            stream() << '"';
+            return *this;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        JsonLineWriter& writeField
+        (
+            const char* name,
+            const char* value
+        )
+        {
+            writeName( name );
+            stream() << '"';
+            writeEscaped( value, std::strlen( value ) );
+            stream() << '"';
+            return *this;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        JsonLineWriter& writeField
+        (
+            const char* name,
+            std::size_t value
+        )
+        {
+            writeName( name );
+            stream() << value;
+            return *this;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        JsonLineWriter& writeField
+        (
+            const char* name,
+            double value
+        )
+        {
+            writeName( name );
+            stream() << value;
+            return *this;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        JsonLineWriter& writeField
+        (
+            const char* name,
+            bool value
+        )
+        {
+            writeName( name );
+            stream() << ( value ? "true" : "false" );
+            return *this;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // An array of numbers
+        template<typename T>
+        JsonLineWriter& writeField
+        (
+            const char* name,
+            const std::vector<T>& values
+        )
+        {
+            writeName( name );
+            stream() << '[';
+            for( std::size_t i = 0; i < values.size(); ++i )
+                stream() << ( i == 0 ? "" : "," ) << values[i];
+            stream() << ']';
+            return *this;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // The fields that follow, until endObjectField(), are the object's
+        JsonLineWriter& startObjectField
+        (
+            const char* name
+        )
+        {
+            writeName( name );
+            stream() << '{';
+            m_isFirstField = true;
+            return *this;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        JsonLineWriter& endObjectField
+        ()
+        {
+            stream() << '}';
+            m_isFirstField = false;
+            return *this;
+        }
+
+    private:
+
+        ///////////////////////////////////////////////////////////////////////
+        std::ostream& stream
+        ()
+        {
+            return *m_os;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // Names are always literals, so are never escaped
+        void writeName
+        (
+            const char* name
+        )
+        {
+            if( !m_isFirstField )
+                stream() << ',';
+            m_isFirstField = false;
+            stream() << '"' << name << "\":";
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // 1 for characters that must be escaped, 2 for the first byte of a
+        // (possible) multi-byte UTF-8 sequence
+        static unsigned char classify
+        (
+            unsigned char c
+        )
+        {
+            static const unsigned char table[256] =
+            {
+                1,1,1,1,1,1,1,1, 1,1,1,1,1,1,1,1, 1,1,1,1,1,1,1,1, 1,1,1,1,1,1,1,1,
+                0,0,1,0,0,0,0,0, 0,0,0,0,0,0,0,0, 0,0,0,0,0,0,0,0, 0,0,0,0,0,0,0,0,
+                0,0,0,0,0,0,0,0, 0,0,0,0,0,0,0,0, 0,0,0,0,0,0,0,0, 0,0,0,0,1,0,0,0,
+                0,0,0,0,0,0,0,0, 0,0,0,0,0,0,0,0, 0,0,0,0,0,0,0,0, 0,0,0,0,0,0,0,1,
+                2,2,2,2,2,2,2,2, 2,2,2,2,2,2,2,2, 2,2,2,2,2,2,2,2, 2,2,2,2,2,2,2,2,
+                2,2,2,2,2,2,2,2, 2,2,2,2,2,2,2,2, 2,2,2,2,2,2,2,2, 2,2,2,2,2,2,2,2,
+                2,2,2,2,2,2,2,2, 2,2,2,2,2,2,2,2, 2,2,2,2,2,2,2,2, 2,2,2,2,2,2,2,2,
+                2,2,2,2,2,2,2,2, 2,2,2,2,2,2,2,2, 2,2,2,2,2,2,2,2, 2,2,2,2,2,2,2,2
+            };
+            return table[c];
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // The length of the valid UTF-8 sequence starting at data, or 0
+        static std::size_t utf8SequenceLength
+        (
+            const unsigned char* data,
+            std::size_t size
+        )
+        {
+            std::size_t length;
+            unsigned int codePoint;
+            if( data[0] >= 0xc2 && data[0] <= 0xdf )
+            {
+                length = 2;
+                codePoint = data[0] & 0x1f;
+            }
+            else if( data[0] >= 0xe0 && data[0] <= 0xef )
+            {
+                length = 3;
+                codePoint = data[0] & 0x0f;
+            }
+            else if( data[0] >= 0xf0 && data[0] <= 0xf4 )
+            {
+                length = 4;
+                codePoint = data[0] & 0x07;
+            }
+            else
+                return 0;
+
+            if( size < length )
+                return 0;
+            for( std::size_t i = 1; i < length; ++i )
+            {
+                if( ( data[i] & 0xc0 ) != 0x80 )
+                    return 0;
+                codePoint = ( codePoint << 6 ) | ( data[i] & 0x3f );
+            }
+            // Overlong, surrogate and out of range encodings are invalid
+            if( ( length == 3 && codePoint < 0x800 ) ||
+                ( length == 4 && ( codePoint < 0x10000 || codePoint > 0x10ffff ) ) ||
+                ( codePoint >= 0xd800 && codePoint <= 0xdfff ) )
+                return 0;
+            return length;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // Runs of characters that need no escaping are written in one go.
+        // Bytes that aren't part of valid UTF-8 are written as if they were
+        // Latin-1, so the output is always valid JSON
+        void writeEscaped
+        (
+            const char* text,
+            std::size_t size
+        )
+        {
+            const unsigned char* data = reinterpret_cast<const unsigned char*>( text );
+            std::size_t runStart = 0;
+            std::size_t pos = 0;
+            while( pos < size )
+            {
+                unsigned char type = classify( data[pos] );
+                if( type == 0 )
+                {
+                    ++pos;
+                    continue;
+                }
+                if( type == 2 )
+                {
+                    std::size_t length = utf8SequenceLength( data + pos, size - pos );
+                    if( length != 0 )
+                    {
+                        pos += length;
+                        continue;
+                    }
+                }
+                stream().write( text + runStart, static_cast<std::streamsize>( pos - runStart ) );
+                writeEscapedChar( data[pos] );
+                runStart = ++pos;
+            }
+            stream().write( text + runStart, static_cast<std::streamsize>( size - runStart ) );
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        void writeEscapedChar
+        (
+            unsigned char c
+        )
+        {
+            switch( c )
+            {
+                case '"':   stream() << "\\\"";     break;
+                case '\\':  stream() << "\\\\";     break;
+                case '\n':  stream() << "\\n";      break;
+                case '\r':  stream() << "\\r";      break;
+                case '\t':  stream() << "\\t";      break;
+                case '\b':  stream() << "\\b";      break;
+                case '\f':  stream() << "\\f";      break;
+                default:
+                    {
+                        static const char hexDigits[] = "0123456789abcdef";
+                        char escaped[] = { '\\', 'u', '0', '0', hexDigits[c >> 4], hexDigits[c & 0xf] };
+                        stream().write( escaped, sizeof( escaped ) );
+                    }
+                    break;
+            }
+        }
+
+        std::ostream* m_os;
+        bool m_isFirstField;
+    };
+
+}
+#endif // TWOBLUECUBES_CATCH_JSONWRITER_HPP_INCLUDED
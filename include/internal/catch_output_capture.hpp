@@ -0,0 +1,417 @@
+/*
+ *  catch_output_capture.hpp
+ *  Catch
+ *
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * Captures stdout and stderr at the file descriptor level, so output written
+ * with printf, write() or by child processes is captured along with std::cout
+ * and std::cerr
+ */
+
+#ifndef TWOBLUECUBES_CATCH_OUTPUT_CAPTURE_HPP_INCLUDED
+#define TWOBLUECUBES_CATCH_OUTPUT_CAPTURE_HPP_INCLUDED
+
+#include "catch_captured_output.hpp"
+#include "catch_common.h"
+#include "catch_debugger.hpp"
+#include "catch_stream.hpp"
+#include "catch_workers.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#ifndef CATCH_PLATFORM_WINDOWS
+    #include <errno.h>
+    #include <fcntl.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace Catch
+{
+#ifndef CATCH_PLATFORM_WINDOWS
+
+    // While started, everything written to the descriptor goes to a capture
+    // file instead: a temporary file on disk, so a test that writes a lot
+    // doesn't hold it all in memory. The capture file is reused from one test
+    // to the next. What has been written so far can be drained into an
+    // OutputCollector at any time (such as when a section starts or ends).
+    // If a run writes more than the collector keeps, its capture file is
+    // kept, the test case's output says where it is, and a new one is used
+    // from then on
+    class DescriptorCapture : NonCopyable
+    {
+    public:
+        ///////////////////////////////////////////////////////////////////////
+        DescriptorCapture
+        (
+            int fd,
+            OutputCollector::Stream stream
+        )
+        :   m_fd( fd ),
+            m_stream( stream ),
+            m_savedFd( dup( fd ) ),
+            m_captureFd( createTemporaryFile( m_captureFilename ) ),
+            m_isStarted( false ),
+            m_drained( 0 )
+        {
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        ~DescriptorCapture
+        ()
+        {
+            if( m_savedFd != -1 )
+                ::close( m_savedFd );
+            discardCaptureFile();
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        bool isValid
+        ()
+        const
+        {
+            return m_savedFd != -1 && m_captureFd != -1;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // Moves on to a new capture file, leaving the old one where it is
+        void renewCaptureFile
+        ()
+        {
+            if( m_captureFd != -1 )
+                ::close( m_captureFd );
+            m_captureFd = createTemporaryFile( m_captureFilename );
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        void discardCaptureFile
+        ()
+        {
+            if( m_captureFd == -1 )
+                return;
+            ::close( m_captureFd );
+            unlink( m_captureFilename.c_str() );
+            m_captureFd = -1;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // Where the descriptor went before it was captured
+        int getOriginalFd
+        ()
+        const
+        {
+            return m_savedFd;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        void start
+        ()
+        {
+            if( !isValid() || m_isStarted )
+                return;
+            flushAll();
+            if( ftruncate( m_captureFd, 0 ) != 0 || lseek( m_captureFd, 0, SEEK_SET ) != 0 )
+                return;
+            m_drained = 0;
+            m_isStarted = dup2( m_captureFd, m_fd ) != -1;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // Passes on whatever has been written since it was last drained. The
+        // size comes from fstat, as seeking would move the offset the test
+        // is writing at
+        void drain
+        (
+            OutputCollector& collector
+        )
+        {
+            if( !m_isStarted )
+                return;
+            flushAll();
+            struct stat info;
+            if( fstat( m_captureFd, &info ) != 0 )
+                return;
+            std::string chunk;
+            while( m_drained < info.st_size )
+            {
+                chunk.resize( static_cast<std::size_t>( (std::min)( info.st_size - m_drained, static_cast<off_t>( 64 * 1024 ) ) ) );
+                std::size_t count = readAt( m_drained, &chunk[0], chunk.size() );
+                if( count == 0 )
+                    break;
+                collector.append( m_stream, chunk.data(), count );
+                m_drained += static_cast<off_t>( count );
+            }
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        void stop
+        (
+            OutputCollector& collector
+        )
+        {
+            if( !m_isStarted )
+                return;
+            drain( collector );
+            dup2( m_savedFd, m_fd );
+            m_isStarted = false;
+
+            if( collector.getLimit() != 0 && static_cast<std::size_t>( m_drained ) > collector.getLimit() )
+            {
+                std::ostringstream oss;
+                oss << "all " << m_drained << " bytes of this run's output were written to: " << m_captureFilename;
+                collector.addTestCaseNote( m_stream, oss.str() );
+                renewCaptureFile();
+            }
+        }
+
+    private:
+        ///////////////////////////////////////////////////////////////////////
+        static void flushAll
+        ()
+        {
+            std::cout.flush();
+            std::cerr.flush();
+            std::fflush( NULL );
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        static int createTemporaryFile
+        (
+            std::string& filename
+        )
+        {
+            const char* dir = std::getenv( "TMPDIR" );
+            filename = std::string( dir && *dir ? dir : "/tmp" ) + "/catch-output-XXXXXX";
+            return mkstemp( &filename[0] );
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        std::size_t readAt
+        (
+            off_t offset,
+            char* data,
+            std::size_t size
+        )
+        {
+            std::size_t done = 0;
+            while( done < size )
+            {
+                ssize_t count = pread( m_captureFd, data + done, size - done, offset + static_cast<off_t>( done ) );
+                if( count < 0 && errno == EINTR )
+                    continue;
+                if( count <= 0 )
+                    break;
+                done += static_cast<std::size_t>( count );
+            }
+            return done;
+        }
+
+        int m_fd;
+        OutputCollector::Stream m_stream;
+        int m_savedFd;
+        std::string m_captureFilename;
+        int m_captureFd;
+        bool m_isStarted;
+        off_t m_drained;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Captures stdout and stderr. Anything that should still reach them while
+    // capturing - such as a report - must be written to getOriginalStdOut()
+    // and getOriginalStdErr()
+    class OutputCapture : NonCopyable
+    {
+    public:
+        ///////////////////////////////////////////////////////////////////////
+        OutputCapture
+        ()
+        :   m_out( 1, OutputCollector::StdOut ),
+            m_err( 2, OutputCollector::StdErr ),
+            m_originalOut( FileDescriptorWriter( m_out.getOriginalFd() ) ),
+            m_originalErr( FileDescriptorWriter( m_err.getOriginalFd() ) )
+        {
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        bool isValid
+        ()
+        const
+        {
+            return m_out.isValid() && m_err.isValid();
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        std::streambuf* getOriginalStdOut
+        ()
+        {
+            return &m_originalOut;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        std::streambuf* getOriginalStdErr
+        ()
+        {
+            return &m_originalErr;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // A forked child must call this, so it doesn't share capture files
+        // with its parent
+        void renewCaptureFiles
+        ()
+        {
+            m_out.renewCaptureFile();
+            m_err.renewCaptureFile();
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // Removes the capture files. A forked child, which exits without
+        // running destructors, must call this for its own before it exits
+        void discardCaptureFiles
+        ()
+        {
+            m_out.discardCaptureFile();
+            m_err.discardCaptureFile();
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        void start
+        ()
+        {
+            m_originalOut.pubsync();
+            m_originalErr.pubsync();
+            m_out.start();
+            m_err.start();
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        void drain
+        (
+            OutputCollector& collector
+        )
+        {
+            m_out.drain( collector );
+            m_err.drain( collector );
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        void stop
+        (
+            OutputCollector& collector
+        )
+        {
+            m_out.stop( collector );
+            m_err.stop( collector );
+        }
+
+    private:
+        DescriptorCapture m_out;
+        DescriptorCapture m_err;
+        StreamBufImpl<FileDescriptorWriter, 4096> m_originalOut;
+        StreamBufImpl<FileDescriptorWriter, 4096> m_originalErr;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    inline bool canCaptureDescriptors
+    ()
+    {
+        return true;
+    }
+
+#else // CATCH_PLATFORM_WINDOWS
+
+    // !TBD: not implemented on Windows - callers fall back to StreamRedirect
+    class OutputCapture : NonCopyable
+    {
+    public:
+        bool isValid() const { return false; }
+        void renewCaptureFiles(){}
+        void discardCaptureFiles(){}
+        std::streambuf* getOriginalStdOut() { return std::cout.rdbuf(); }
+        std::streambuf* getOriginalStdErr() { return std::cerr.rdbuf(); }
+        void start(){}
+        void drain( OutputCollector& ){}
+        void stop( OutputCollector& ){}
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    inline bool canCaptureDescriptors
+    ()
+    {
+        return false;
+    }
+
+#endif
+
+    ///////////////////////////////////////////////////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    class ScopedOutputCapture : NonCopyable
+    {
+    public:
+        ///////////////////////////////////////////////////////////////////////
+        ScopedOutputCapture
+        (
+            OutputCapture& capture,
+            OutputCollector& collector
+        )
+        :   m_capture( capture ),
+            m_collector( collector )
+        {
+            m_capture.start();
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        ~ScopedOutputCapture
+        ()
+        {
+            m_capture.stop( m_collector );
+        }
+
+    private:
+        OutputCapture& m_capture;
+        OutputCollector& m_collector;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // A worker process captures into files of its own, and removes them as
+    // it finishes, since it exits without running destructors
+    class WorkerCaptureFiles : NonCopyable
+    {
+    public:
+        ///////////////////////////////////////////////////////////////////////
+        explicit WorkerCaptureFiles
+        (
+            OutputCapture* capture
+        )
+        :   m_capture( capture )
+        {
+            if( m_capture )
+                m_capture->renewCaptureFiles();
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        ~WorkerCaptureFiles
+        ()
+        {
+            if( m_capture )
+                m_capture->discardCaptureFiles();
+        }
+
+    private:
+        OutputCapture* m_capture;
+    };
+
+} // end namespace Catch
+
+#endif // TWOBLUECUBES_CATCH_OUTPUT_CAPTURE_HPP_INCLUDED
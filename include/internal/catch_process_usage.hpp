@@ -0,0 +1,169 @@
+/*
+ *  catch_process_usage.hpp
+ *  Catch
+ *
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * Snapshots of the process's resource usage, from getrusage and the list of
+ * open file descriptors
+ */
+
+#ifndef TWOBLUECUBES_CATCH_PROCESS_USAGE_HPP_INCLUDED
+#define TWOBLUECUBES_CATCH_PROCESS_USAGE_HPP_INCLUDED
+
+#include "catch_debugger.hpp"
+#include "catch_resource_usage.hpp"
+
+#ifndef CATCH_PLATFORM_WINDOWS
+    #include <dirent.h>
+    #include <fcntl.h>
+    #include <sys/resource.h>
+    #include <sys/time.h>
+    #include <unistd.h>
+#endif
+
+namespace Catch
+{
+    class ProcessUsage
+    {
+    public:
+        ///////////////////////////////////////////////////////////////////////
+        ProcessUsage
+        ()
+        :   m_maxRss( 0 ),
+            m_minorFaults( 0 ),
+            m_majorFaults( 0 ),
+            m_voluntarySwitches( 0 ),
+            m_involuntarySwitches( 0 ),
+            m_openDescriptors( 0 )
+        {
+        }
+
+#ifndef CATCH_PLATFORM_WINDOWS
+
+        ///////////////////////////////////////////////////////////////////////
+        static bool canRecord
+        ()
+        {
+            return true;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        static ProcessUsage now
+        ()
+        {
+            ProcessUsage usage;
+            struct rusage self;
+            struct rusage children;
+            if( getrusage( RUSAGE_SELF, &self ) == 0 && getrusage( RUSAGE_CHILDREN, &children ) == 0 )
+            {
+                usage.m_maxRss = toSize( self.ru_maxrss ) * MaxRssUnit;
+                usage.m_minorFaults = toSize( self.ru_minflt ) + toSize( children.ru_minflt );
+                usage.m_majorFaults = toSize( self.ru_majflt ) + toSize( children.ru_majflt );
+                usage.m_voluntarySwitches = toSize( self.ru_nvcsw ) + toSize( children.ru_nvcsw );
+                usage.m_involuntarySwitches = toSize( self.ru_nivcsw ) + toSize( children.ru_nivcsw );
+            }
+            usage.m_openDescriptors = countOpenDescriptors();
+            return usage;
+        }
+
+#else // CATCH_PLATFORM_WINDOWS
+
+        // !TBD: GetProcessMemoryInfo and GetProcessHandleCount would do
+        static bool canRecord() { return false; }
+        static ProcessUsage now() { return ProcessUsage(); }
+
+#endif
+
+        ///////////////////////////////////////////////////////////////////////
+        // What was used between the start snapshot and this one
+        void since
+        (
+            const ProcessUsage& start,
+            ResourceUsage& usage
+        )
+        const
+        {
+            usage.processUsageRecorded = true;
+            usage.peakRssGrowth = growth( start.m_maxRss, m_maxRss );
+            usage.minorFaults = growth( start.m_minorFaults, m_minorFaults );
+            usage.majorFaults = growth( start.m_majorFaults, m_majorFaults );
+            usage.voluntarySwitches = growth( start.m_voluntarySwitches, m_voluntarySwitches );
+            usage.involuntarySwitches = growth( start.m_involuntarySwitches, m_involuntarySwitches );
+            usage.descriptorsLeaked = growth( start.m_openDescriptors, m_openDescriptors );
+        }
+
+    private:
+#ifndef CATCH_PLATFORM_WINDOWS
+
+        // ru_maxrss is in bytes on Mac OS X, and kilobytes everywhere else
+#ifdef __APPLE__
+        enum { MaxRssUnit = 1 };
+#else
+        enum { MaxRssUnit = 1024 };
+#endif
+
+        ///////////////////////////////////////////////////////////////////////
+        static std::size_t toSize
+        (
+            long value
+        )
+        {
+            return value > 0 ? static_cast<std::size_t>( value ) : 0;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // Lists /proc/self/fd (or /dev/fd) where there is one, which is much
+        // cheaper than asking about every possible descriptor
+        static std::size_t countOpenDescriptors
+        ()
+        {
+            const char* dirs[] = { "/proc/self/fd", "/dev/fd" };
+            for( std::size_t i = 0; i < sizeof( dirs ) / sizeof( dirs[0] ); ++i )
+            {
+                if( DIR* dir = opendir( dirs[i] ) )
+                {
+                    // Doesn't count the descriptor that is reading the list
+                    std::size_t count = 0;
+                    while( struct dirent* entry = readdir( dir ) )
+                        if( entry->d_name[0] != '.' )
+                            ++count;
+                    closedir( dir );
+                    return count > 0 ? count - 1 : 0;
+                }
+            }
+
+            long maxDescriptors = sysconf( _SC_OPEN_MAX );
+            if( maxDescriptors < 0 || maxDescriptors > 4096 )
+                maxDescriptors = 4096;
+            std::size_t count = 0;
+            for( int fd = 0; fd < maxDescriptors; ++fd )
+                if( fcntl( fd, F_GETFD ) != -1 )
+                    ++count;
+            return count;
+        }
+
+#endif
+
+        ///////////////////////////////////////////////////////////////////////
+        static std::size_t growth
+        (
+            std::size_t from,
+            std::size_t to
+        )
+        {
+            return to > from ? to - from : 0;
+        }
+
+        std::size_t m_maxRss;
+        std::size_t m_minorFaults;
+        std::size_t m_majorFaults;
+        std::size_t m_voluntarySwitches;
+        std::size_t m_involuntarySwitches;
+        std::size_t m_openDescriptors;
+    };
+
+} // end namespace Catch
+
+#endif // TWOBLUECUBES_CATCH_PROCESS_USAGE_HPP_INCLUDED
@@ -0,0 +1,654 @@
+/*
+ *  catch_property.hpp
+ *  Catch
+ *
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ *
+ */
+
+#ifndef TWOBLUECUBES_CATCH_PROPERTY_HPP_INCLUDED
+#define TWOBLUECUBES_CATCH_PROPERTY_HPP_INCLUDED
+
+#include "catch_capture.hpp"
+#include "catch_generators.hpp"
+#include "catch_interfaces_capture.h"
+#include "catch_interfaces_runner.h"
+#include "catch_random.hpp"
+#include "catch_test_registry.hpp"
+
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace Catch
+{
+namespace Detail
+{
+    template<typename T, bool isInteger>
+    struct ArbitraryNumber
+    {
+        ///////////////////////////////////////////////////////////////////////
+        static T generate
+        (
+            SeededRandom& rng,
+            std::size_t size
+        )
+        {
+            if( rng.below( 10 ) == 0 )
+                return T();
+            T value = static_cast<T>( rng.unit() * size );
+            if( std::numeric_limits<T>::is_signed && rng.below( 2 ) == 0 )
+                value = -value;
+            return value;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        static void shrink
+        (
+            T value,
+            std::vector<T>& candidates
+        )
+        {
+            if( value == T() )
+                return;
+            candidates.push_back( T() );
+            // Outside long's range (or NaN) the cast would be undefined - and
+            // a value that big has no fraction to drop anyway
+            if( value > static_cast<T>( (std::numeric_limits<long>::min)() ) &&
+                value < static_cast<T>( (std::numeric_limits<long>::max)() ) )
+            {
+                T truncated = static_cast<T>( static_cast<long>( value ) );
+                if( truncated != value )
+                    candidates.push_back( truncated );
+            }
+            candidates.push_back( value / 2 );
+            if( value < T() )
+                candidates.push_back( -value );
+        }
+    };
+
+    template<typename T>
+    struct ArbitraryNumber<T, true>
+    {
+        ///////////////////////////////////////////////////////////////////////
+        static T generate
+        (
+            SeededRandom& rng,
+            std::size_t size
+        )
+        {
+            // Mostly small values, growing with the size, with the occasional
+            // boundary value or something from anywhere in the range
+            switch( rng.below( 20 ) )
+            {
+                case 0:     return (std::numeric_limits<T>::min)();
+                case 1:     return (std::numeric_limits<T>::max)();
+                case 2:     return static_cast<T>( rng.next() );
+                default:    break;
+            }
+            T value = static_cast<T>( rng.below( size+1 ) );
+            if( std::numeric_limits<T>::is_signed && rng.below( 2 ) == 0 )
+                value = static_cast<T>( -value );
+            return value;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // Candidates move towards zero, biggest jump first:
+        // 0, value - value/2, value - value/4, ... value -/+ 1
+        static void shrink
+        (
+            T value,
+            std::vector<T>& candidates
+        )
+        {
+            if( value < T() && value != (std::numeric_limits<T>::min)() )
+                candidates.push_back( static_cast<T>( -value ) );
+            for( T delta = value; delta != T(); delta = static_cast<T>( delta / 2 ) )
+                candidates.push_back( static_cast<T>( value - delta ) );
+        }
+    };
+
+} // end namespace Detail
+
+///////////////////////////////////////////////////////////////////////////////
+// Specialise this for your own types to use them with PROPERTY.
+// generate() draws a value whose "complexity" is bounded by size and
+// shrink() appends simpler versions of value, most aggressive first
+template<typename T>
+struct Arbitrary
+{
+    ///////////////////////////////////////////////////////////////////////////
+    static T generate
+    (
+        Detail::SeededRandom& rng,
+        std::size_t size
+    )
+    {
+        return Detail::ArbitraryNumber<T, std::numeric_limits<T>::is_integer>::generate( rng, size );
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    static void shrink
+    (
+        const T& value,
+        std::vector<T>& candidates
+    )
+    {
+        Detail::ArbitraryNumber<T, std::numeric_limits<T>::is_integer>::shrink( value, candidates );
+    }
+};
+
+template<>
+struct Arbitrary<bool>
+{
+    ///////////////////////////////////////////////////////////////////////////
+    static bool generate
+    (
+        Detail::SeededRandom& rng,
+        std::size_t
+    )
+    {
+        return rng.below( 2 ) == 1;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    static void shrink
+    (
+        bool value,
+        std::vector<bool>& candidates
+    )
+    {
+        if( value )
+            candidates.push_back( false );
+    }
+};
+
+namespace Detail
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Shared by strings and vectors: first try dropping chunks, halving the
+    // chunk size each time, then simplify one element at a time
+    template<typename ContainerT, typename ElementT>
+    void shrinkSequence
+    (
+        const ContainerT& value,
+        std::vector<ContainerT>& candidates
+    )
+    {
+        std::size_t length = value.size();
+        for( std::size_t chunk = length; chunk > 0; chunk /= 2 )
+        {
+            for( std::size_t start = 0; start + chunk <= length; start += chunk )
+            {
+                ContainerT candidate( value.begin(), value.begin() + start );
+                candidate.insert( candidate.end(), value.begin() + start + chunk, value.end() );
+                candidates.push_back( candidate );
+            }
+        }
+        for( std::size_t i = 0; i < length; ++i )
+        {
+            std::vector<ElementT> elementCandidates;
+            Arbitrary<ElementT>::shrink( value[i], elementCandidates );
+            if( !elementCandidates.empty() )
+            {
+                ContainerT candidate( value );
+                candidate[i] = elementCandidates.front();
+                candidates.push_back( candidate );
+            }
+        }
+    }
+} // end namespace Detail
+
+template<>
+struct Arbitrary<char>
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Printable ASCII, so counterexamples can be read in a report
+    static char generate
+    (
+        Detail::SeededRandom& rng,
+        std::size_t
+    )
+    {
+        return static_cast<char>( ' ' + rng.below( '~' - ' ' + 1 ) );
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    static void shrink
+    (
+        char value,
+        std::vector<char>& candidates
+    )
+    {
+        if( value != 'a' )
+            candidates.push_back( 'a' );
+    }
+};
+
+template<>
+struct Arbitrary<std::string>
+{
+    ///////////////////////////////////////////////////////////////////////////
+    static std::string generate
+    (
+        Detail::SeededRandom& rng,
+        std::size_t size
+    )
+    {
+        std::string value( rng.below( size+1 ), ' ' );
+        for( std::size_t i = 0; i < value.size(); ++i )
+            value[i] = Arbitrary<char>::generate( rng, size );
+        return value;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    static void shrink
+    (
+        const std::string& value,
+        std::vector<std::string>& candidates
+    )
+    {
+        Detail::shrinkSequence<std::string, char>( value, candidates );
+    }
+};
+
+template<typename T>
+struct Arbitrary<std::vector<T> >
+{
+    ///////////////////////////////////////////////////////////////////////////
+    static std::vector<T> generate
+    (
+        Detail::SeededRandom& rng,
+        std::size_t size
+    )
+    {
+        std::vector<T> value;
+        std::size_t length = rng.below( size+1 );
+        for( std::size_t i = 0; i < length; ++i )
+            value.push_back( Arbitrary<T>::generate( rng, size ) );
+        return value;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    static void shrink
+    (
+        const std::vector<T>& value,
+        std::vector<std::vector<T> >& candidates
+    )
+    {
+        Detail::shrinkSequence<std::vector<T>, T>( value, candidates );
+    }
+};
+
+namespace Detail
+{
+    ///////////////////////////////////////////////////////////////////////////
+    template<typename T>
+    std::string describe
+    (
+        const T& value
+    )
+    {
+        return Catch::toString( value );
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    template<typename T>
+    std::string describe
+    (
+        const std::vector<T>& value
+    )
+    {
+        std::ostringstream oss;
+        oss << "{ ";
+        for( std::size_t i = 0; i < value.size(); ++i )
+            oss << ( i > 0 ? ", " : "" ) << describe( value[i] );
+        oss << " }";
+        return oss.str();
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Stands in for the runner while a property is being searched or shrunk.
+    // Results are only noted as pass or fail - nothing reaches the reporter
+    class SilentResultCapture : public IResultCapture
+    {
+    public:
+        ///////////////////////////////////////////////////////////////////////
+        SilentResultCapture
+        ()
+        :   m_prevResultCapture( &Hub::getResultCapture() ),
+            m_failed( false ),
+            m_sawSection( false )
+        {
+            Hub::setResultCapture( this );
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        ~SilentResultCapture
+        ()
+        {
+            Hub::setResultCapture( m_prevResultCapture );
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        void fail
+        ()
+        {
+            m_failed = true;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        bool failed
+        ()
+        const
+        {
+            return m_failed;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        bool sawSection
+        ()
+        const
+        {
+            return m_sawSection;
+        }
+
+    private: // IResultCapture
+
+        ///////////////////////////////////////////////////////////////////////
+        virtual void testEnded
+        (
+            const ResultInfo& result
+        )
+        {
+            if( !result.ok() )
+                m_failed = true;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // A property is evaluated as a whole, but the runner would only run
+        // one of its sections each time the counterexample was re-run - so
+        // sections aren't run here, just noted, and the property is rejected
+        virtual bool sectionStarted
+        (
+            const std::string&,
+            const std::string&,
+            const std::string&,
+            std::size_t,
+            std::size_t&,
+            std::size_t&
+        )
+        {
+            m_sawSection = true;
+            return false;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        virtual void sectionEnded
+        (
+            const std::string&,
+            std::size_t,
+            std::size_t
+        )
+        {
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        virtual void pushScopedInfo
+        (
+            ScopedInfo*
+        )
+        {
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        virtual void popScopedInfo
+        (
+            ScopedInfo*
+        )
+        {
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        virtual bool shouldDebugBreak
+        ()
+        const
+        {
+            return false;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        virtual ResultAction::Value acceptResult
+        (
+            bool result
+        )
+        {
+            return acceptResult( result ? ResultWas::Ok : ResultWas::ExpressionFailed );
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        virtual ResultAction::Value acceptResult
+        (
+            ResultWas::OfType result
+        )
+        {
+            MutableResultInfo resultInfo;
+            resultInfo.setResultType( result );
+            return acceptExpression( resultInfo );
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        virtual ResultAction::Value acceptExpression
+        (
+            const MutableResultInfo& resultInfo
+        )
+        {
+            testEnded( resultInfo );
+            return resultInfo.ok() ? ResultAction::None : ResultAction::Failed;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        virtual void acceptMessage
+        (
+            const std::string&
+        )
+        {
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        virtual std::string getCurrentTestName
+        ()
+        const
+        {
+            return m_prevResultCapture->getCurrentTestName();
+        }
+
+    private:
+        IResultCapture* m_prevResultCapture;
+        bool m_failed;
+        bool m_sawSection;
+    };
+
+} // end namespace Detail
+
+///////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+template<typename T>
+class Property
+{
+public:
+    typedef void (*PropertyFunction)( const T& );
+
+    ///////////////////////////////////////////////////////////////////////////
+    Property
+    (
+        const std::string& name,
+        const char* filename,
+        std::size_t line,
+        PropertyFunction function,
+        std::size_t iterations = 100,
+        std::size_t maxShrinks = 1000
+    )
+    :   m_name( name ),
+        m_filename( filename ),
+        m_line( line ),
+        m_function( function ),
+        m_iterations( iterations ),
+        m_maxShrinks( maxShrinks ),
+        m_seed( Detail::hashName( name ) ),
+        m_sawSection( false )
+    {
+        // Each property keeps its own sequence, but a randomised run shifts
+        // them all, and reruns with the same --rng-seed reproduce them. The
+        // seed a failure reports replays it directly, with --property-seed
+        if( unsigned int propertySeed = Hub::getRunner().getPropertySeed() )
+            m_seed = propertySeed;
+        else if( unsigned int rngSeed = Hub::getRunner().getRngSeed() )
+            m_seed = Detail::mixBits( m_seed ^ rngSeed );
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    Property& setSeed
+    (
+        unsigned int seed
+    )
+    {
+        m_seed = seed;
+        return *this;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    void check
+    ()
+    const
+    {
+        Detail::SeededRandom rng( m_seed );
+        for( std::size_t i = 0; i < m_iterations; ++i )
+        {
+            T value = Arbitrary<T>::generate( rng, i );
+            bool held = holds( value );
+            if( m_sawSection )
+                return accept( ResultWas::ExplicitFailure, "a PROPERTY can't have SECTIONs - it must run the same code each time it is evaluated" );
+            if( !held )
+                return reportCounterExample( value, i+1 );
+        }
+        std::ostringstream oss;
+        oss << "passed " << m_iterations << " test(s) (seed: " << m_seed << ")";
+        accept( ResultWas::Ok, oss.str() );
+    }
+
+private:
+
+    ///////////////////////////////////////////////////////////////////////////
+    bool holds
+    (
+        const T& value
+    )
+    const
+    {
+        Detail::SilentResultCapture capture;
+        try
+        {
+            m_function( value );
+        }
+        catch( TestFailureException& )
+        {
+            // REQUIRE failed - already noted by the capture
+        }
+        catch( ... )
+        {
+            capture.fail();
+        }
+        if( capture.sawSection() )
+            m_sawSection = true;
+        return !capture.failed();
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Greedy: take the first simpler candidate that still fails and start
+    // again from there, until nothing simpler fails or the budget runs out
+    std::size_t shrink
+    (
+        T& value
+    )
+    const
+    {
+        std::size_t shrinks = 0;
+        std::size_t evaluations = 0;
+        for( bool shrunk = true; shrunk && evaluations < m_maxShrinks; )
+        {
+            shrunk = false;
+            std::vector<T> candidates;
+            Arbitrary<T>::shrink( value, candidates );
+            for( std::size_t i = 0; i < candidates.size() && evaluations < m_maxShrinks; ++i )
+            {
+                ++evaluations;
+                if( !holds( candidates[i] ) )
+                {
+                    value = candidates[i];
+                    ++shrinks;
+                    shrunk = true;
+                    break;
+                }
+            }
+        }
+        return shrinks;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    void reportCounterExample
+    (
+        T value,
+        std::size_t testsRun
+    )
+    const
+    {
+        std::size_t shrinks = shrink( value );
+
+        std::ostringstream oss;
+        oss << "Falsified after " << testsRun << " test(s) and " << shrinks << " shrink(s) - replay it with --property-seed " << m_seed << "\n"
+            << "counterexample: " << Detail::describe( value );
+        accept( ResultWas::Info, oss.str() );
+
+        // Run the minimal case once more for real, so its assertions are reported as usual
+        std::size_t prevFailures = Hub::getRunner().getFailureCount();
+        m_function( value );
+        if( Hub::getRunner().getFailureCount() == prevFailures )
+            accept( ResultWas::ExplicitFailure, "counterexample did not fail when re-run - is the property deterministic?" );
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    void accept
+    (
+        ResultWas::OfType resultType,
+        const std::string& message
+    )
+    const
+    {
+        Hub::getResultCapture().acceptExpression( ( ResultBuilder( m_filename.c_str(), m_line, "PROPERTY" ) << message ).setResultType( resultType ) );
+    }
+
+    std::string m_name;
+    std::string m_filename;
+    std::size_t m_line;
+    PropertyFunction m_function;
+    std::size_t m_iterations;
+    std::size_t m_maxShrinks;
+    unsigned int m_seed;
+    mutable bool m_sawSection;
+};
+
+} // end namespace Catch
+
+///////////////////////////////////////////////////////////////////////////////
+#define INTERNAL_CATCH_PROPERTY( Name, Desc, Type, arg ) \
+    static void INTERNAL_CATCH_UNIQUE_NAME( catch_internal_PropertyFunction )( const Type& arg ); \
+    INTERNAL_CATCH_TESTCASE( Name, Desc ) \
+    { \
+        Catch::Property<Type>( Name, __FILE__, __LINE__, &INTERNAL_CATCH_UNIQUE_NAME( catch_internal_PropertyFunction ) ).check(); \
+    } \
+    static void INTERNAL_CATCH_UNIQUE_NAME( catch_internal_PropertyFunction )( const Type& arg )
+
+#endif // TWOBLUECUBES_CATCH_PROPERTY_HPP_INCLUDED
@@ -0,0 +1,128 @@
+/*
+ *  catch_random.hpp
+ *  Catch
+ *
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * Platform independent randomness, so a seed reproduces the same run anywhere
+ */
+
+#ifndef TWOBLUECUBES_CATCH_RANDOM_HPP_INCLUDED
+#define TWOBLUECUBES_CATCH_RANDOM_HPP_INCLUDED
+
+#include <algorithm>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace Catch
+{
+namespace Detail
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // A stateless, counter based, hash (after Chris Wellons' lowbias32).
+    // Any index can be mapped to its value without generating the ones before it
+    inline unsigned int mixBits
+    (
+        unsigned int bits
+    )
+    {
+        bits &= 0xffffffffU;
+        bits ^= bits >> 16;
+        bits = ( bits * 0x7feb352dU ) & 0xffffffffU;
+        bits ^= bits >> 15;
+        bits = ( bits * 0x846ca68bU ) & 0xffffffffU;
+        bits ^= bits >> 16;
+        return bits;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    inline unsigned int mixBits
+    (
+        unsigned int seed,
+        std::size_t index
+    )
+    {
+        // The double shift avoids undefined behaviour where size_t is 32 bits
+        unsigned int high = static_cast<unsigned int>( index >> 16 >> 16 );
+        return mixBits( seed ^ mixBits( static_cast<unsigned int>( index ) ^ mixBits( high + 0x9e3779b9U ) ) );
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Draws values from the same counter based hash as RandomGenerator, so a
+    // (seed, draw number) pair always reproduces the same value
+    class SeededRandom
+    {
+    public:
+        ///////////////////////////////////////////////////////////////////////
+        explicit SeededRandom
+        (
+            unsigned int seed
+        )
+        :   m_seed( mixBits( seed ) ),
+            m_count( 0 )
+        {
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        unsigned int next
+        ()
+        {
+            return mixBits( m_seed, m_count++ );
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // A value in the range [0, limit)
+        std::size_t below
+        (
+            std::size_t limit
+        )
+        {
+            return limit == 0 ? 0 : next() % limit;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // A value in the range [0, 1)
+        double unit
+        ()
+        {
+            return next() / 4294967296.0;
+        }
+
+    private:
+        unsigned int m_seed;
+        std::size_t m_count;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    inline unsigned int hashName
+    (
+        const std::string& name
+    )
+    {
+        // FNV-1a
+        unsigned int hash = 2166136261U;
+        for( std::size_t i = 0; i < name.size(); ++i )
+            hash = ( ( hash ^ static_cast<unsigned char>( name[i] ) ) * 16777619U ) & 0xffffffffU;
+        return hash;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Fisher-Yates. std::random_shuffle would do, but its algorithm differs
+    // between library implementations, so the same seed wouldn't reproduce
+    template<typename T>
+    void shuffle
+    (
+        std::vector<T>& values,
+        SeededRandom& rng
+    )
+    {
+        for( std::size_t i = values.size(); i > 1; --i )
+            std::swap( values[i-1], values[rng.below( i )] );
+    }
+
+} // end namespace Detail
+} // end namespace Catch
+
+#endif // TWOBLUECUBES_CATCH_RANDOM_HPP_INCLUDED
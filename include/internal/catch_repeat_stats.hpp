@@ -0,0 +1,101 @@
+/*
+ *  catch_repeat_stats.hpp
+ *  Catch
+ *
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * How a test case fared over the repetitions of a run made with --repeat or
+ * --until-fail
+ */
+
+#ifndef TWOBLUECUBES_CATCH_REPEAT_STATS_HPP_INCLUDED
+#define TWOBLUECUBES_CATCH_REPEAT_STATS_HPP_INCLUDED
+
+#include <algorithm>
+#include <cstddef>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace Catch
+{
+    struct RepeatStats
+    {
+        ///////////////////////////////////////////////////////////////////////
+        RepeatStats
+        ()
+        :   runs( 0 ),
+            minMicroseconds( 0 ),
+            medianMicroseconds( 0 ),
+            maxMicroseconds( 0 )
+        {
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // Adds a run that failed, in the repetition (from 1) that was run
+        // with rngSeed
+        void addFailure
+        (
+            std::size_t repetition,
+            unsigned int rngSeed
+        )
+        {
+            failedRepetitions.push_back( repetition );
+            failedRngSeeds.push_back( rngSeed );
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // Sets the runs, and the durations, from every run's duration
+        void setDurations
+        (
+            std::vector<uint64_t> durations
+        )
+        {
+            runs = durations.size();
+            if( durations.empty() )
+                return;
+            std::sort( durations.begin(), durations.end() );
+            minMicroseconds = durations.front();
+            maxMicroseconds = durations.back();
+            std::size_t middle = durations.size() / 2;
+            medianMicroseconds = durations.size() % 2 == 1
+                ? durations[middle]
+                : ( durations[middle-1] + durations[middle] ) / 2;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        std::size_t getFailedRuns
+        ()
+        const
+        {
+            return failedRepetitions.size();
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // The proportion of runs, from 0 to 1, that passed
+        double getPassRate
+        ()
+        const
+        {
+            return runs == 0 ? 0 : static_cast<double>( runs - getFailedRuns() ) / runs;
+        }
+
+        std::string name;
+        std::size_t runs;
+
+        // The repetitions (from 1) the test case failed in, and the seeds
+        // they were run with. A seed is only non-zero if the tests were run
+        // in a random order, in which case --rng-seed with it runs the tests
+        // in the same order again
+        std::vector<std::size_t> failedRepetitions;
+        std::vector<unsigned int> failedRngSeeds;
+
+        uint64_t minMicroseconds;
+        uint64_t medianMicroseconds;
+        uint64_t maxMicroseconds;
+    };
+
+} // end namespace Catch
+
+#endif // TWOBLUECUBES_CATCH_REPEAT_STATS_HPP_INCLUDED
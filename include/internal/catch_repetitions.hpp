@@ -0,0 +1,193 @@
+/*
+ *  catch_repetitions.hpp
+ *  Catch
+ *
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * Numbers, seeds and names the repetitions of a run made with --repeat or
+ * --until-fail, and keeps track of how each test case fared across them
+ */
+
+#ifndef TWOBLUECUBES_CATCH_REPETITIONS_HPP_INCLUDED
+#define TWOBLUECUBES_CATCH_REPETITIONS_HPP_INCLUDED
+
+#include "catch_config.hpp"
+#include "catch_interfaces_reporter.h"
+#include "catch_random.hpp"
+#include "catch_repeat_stats.hpp"
+
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace Catch
+{
+    // Repetitions count from 0. In a random order every repetition after
+    // the first has a seed of its own, so any one of them can be run again
+    // with --rng-seed
+    class Repetitions : NonCopyable
+    {
+    public:
+        ///////////////////////////////////////////////////////////////////////
+        explicit Repetitions
+        (
+            const Config& config
+        )
+        :   m_config( config ),
+            m_current( 0 ),
+            m_rngSeed( 0 ),
+            m_runs( 0 ),
+            m_anyFailed( false )
+        {
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // How many repetitions there are to run - 0 to repeat until
+        // something fails
+        std::size_t getLimit
+        ()
+        const
+        {
+            std::size_t repetitions = m_config.getRepeat();
+            if( repetitions == 0 && !m_config.repeatUntilFail() )
+                repetitions = 1;
+            return repetitions;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // Makes the repetition the current one, and returns the name of the
+        // group it is reported as
+        std::string start
+        (
+            std::size_t repetition
+        )
+        {
+            m_current = repetition;
+            m_rngSeed = getRngSeed( repetition );
+            return getName( repetition );
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        void finish
+        ()
+        {
+            m_rngSeed = 0;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // The current repetition's seed - 0 if it has none of its own
+        unsigned int getRngSeed
+        ()
+        const
+        {
+            return m_rngSeed;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // How many test cases have been run, over all of the repetitions
+        std::size_t getRunCount
+        ()
+        const
+        {
+            return m_runs;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        bool anyFailed
+        ()
+        const
+        {
+            return m_anyFailed;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // Records a run of the test case in the current repetition
+        void addRun
+        (
+            const std::string& testName,
+            bool failed,
+            uint64_t durationMicroseconds
+        )
+        {
+            ++m_runs;
+            std::map<std::string, std::size_t>::const_iterator it = m_indices.find( testName );
+            std::size_t index = m_stats.size();
+            if( it == m_indices.end() )
+            {
+                m_indices.insert( std::make_pair( testName, index ) );
+                m_stats.push_back( RepeatStats() );
+                m_stats.back().name = testName;
+                m_durations.push_back( std::vector<uint64_t>() );
+            }
+            else
+            {
+                index = it->second;
+            }
+            m_durations[index].push_back( durationMicroseconds );
+            if( failed )
+            {
+                m_stats[index].addFailure( m_current+1, m_rngSeed != 0 ? m_rngSeed : m_config.getRngSeed() );
+                m_anyFailed = true;
+            }
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // Reports how each test case fared, in the order they were first run
+        void report
+        (
+            IReporter& reporter
+        )
+        {
+            for( std::size_t i = 0; i < m_stats.size(); ++i )
+            {
+                m_stats[i].setDurations( m_durations[i] );
+                reporter.TestCaseRepeated( m_stats[i] );
+            }
+        }
+
+    private:
+        ///////////////////////////////////////////////////////////////////////
+        // The first repetition has the run's own seed (if it has one)
+        unsigned int getRngSeed
+        (
+            std::size_t repetition
+        )
+        const
+        {
+            unsigned int rngSeed = m_config.getRngSeed();
+            if( rngSeed == 0 || repetition == 0 )
+                return rngSeed;
+            return ( Detail::mixBits( rngSeed, repetition ) & 0x7fffffffU ) | 1;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        std::string getName
+        (
+            std::size_t repetition
+        )
+        const
+        {
+            std::ostringstream oss;
+            oss << "Repetition " << repetition+1;
+            if( m_config.getRepeat() != 0 )
+                oss << " of " << m_config.getRepeat();
+            if( unsigned int rngSeed = getRngSeed( repetition ) )
+                oss << " (--rng-seed " << rngSeed << ")";
+            return oss.str();
+        }
+
+        const Config& m_config;
+        std::size_t m_current;
+        unsigned int m_rngSeed;
+        std::size_t m_runs;
+        bool m_anyFailed;
+        std::vector<RepeatStats> m_stats;
+        std::vector<std::vector<uint64_t> > m_durations;
+        std::map<std::string, std::size_t> m_indices;
+    };
+
+} // end namespace Catch
+
+#endif // TWOBLUECUBES_CATCH_REPETITIONS_HPP_INCLUDED
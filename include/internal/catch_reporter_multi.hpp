@@ -0,0 +1,483 @@
+/*
+ *  catch_reporter_multi.hpp
+ *  Catch
+ *
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * Fans reporter events out to several reporters, each with its own output
+ */
+#ifndef TWOBLUECUBES_CATCH_REPORTER_MULTI_HPP_INCLUDED
+#define TWOBLUECUBES_CATCH_REPORTER_MULTI_HPP_INCLUDED
+
+#include "catch_hub.h"
+#include "catch_interfaces_reporter.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+namespace Catch
+{
+    // Writes everything to several streams
+    class TeeStreamBuf : public std::streambuf
+    {
+    public:
+        ///////////////////////////////////////////////////////////////////////
+        explicit TeeStreamBuf
+        (
+            const std::vector<std::ostream*>& targets
+        )
+        :   m_targets( targets )
+        {
+            setp( m_data, m_data + sizeof( m_data ) );
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        ~TeeStreamBuf
+        ()
+        {
+            writeBuffer();
+        }
+
+    private:
+        ///////////////////////////////////////////////////////////////////////
+        void writeBuffer
+        ()
+        {
+            if( pptr() == pbase() )
+                return;
+            for( std::size_t i = 0; i < m_targets.size(); ++i )
+                m_targets[i]->write( pbase(), pptr() - pbase() );
+            setp( pbase(), epptr() );
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        virtual int overflow
+        (
+            int c
+        )
+        {
+            writeBuffer();
+            if( c != EOF )
+                sputc( static_cast<char>( c ) );
+            return 0;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        virtual int sync
+        ()
+        {
+            writeBuffer();
+            for( std::size_t i = 0; i < m_targets.size(); ++i )
+                m_targets[i]->flush();
+            return 0;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // Only a single target can be seeked in
+        virtual pos_type seekoff
+        (
+            off_type off,
+            std::ios_base::seekdir dir,
+            std::ios_base::openmode which
+        )
+        {
+            if( m_targets.size() != 1 )
+                return pos_type( off_type( -1 ) );
+            writeBuffer();
+            return m_targets[0]->rdbuf()->pubseekoff( off, dir, which );
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        virtual pos_type seekpos
+        (
+            pos_type pos,
+            std::ios_base::openmode which
+        )
+        {
+            if( m_targets.size() != 1 )
+                return pos_type( off_type( -1 ) );
+            writeBuffer();
+            return m_targets[0]->rdbuf()->pubseekpos( pos, which );
+        }
+
+        char m_data[4096];
+        std::vector<std::ostream*> m_targets;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Everything as the main config, except for where the output goes
+    class ReporterSinkConfig : public IReporterConfig
+    {
+    public:
+        ///////////////////////////////////////////////////////////////////////
+        ReporterSinkConfig
+        (
+            const IReporterConfig& config,
+            const std::vector<std::ostream*>& targets,
+            const std::string& filename
+        )
+        :   m_config( config ),
+            m_buf( targets ),
+            m_os( &m_buf ),
+            m_filename( filename )
+        {
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        virtual std::ostream& stream
+        ()
+        const
+        {
+            return m_os;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        virtual bool includeSuccessfulResults
+        ()
+        const
+        {
+            return m_config.includeSuccessfulResults();
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        virtual std::string getName
+        ()
+        const
+        {
+            return m_config.getName();
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        virtual unsigned int getRngSeed
+        ()
+        const
+        {
+            return m_config.getRngSeed();
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        virtual const std::string& getFilename
+        ()
+        const
+        {
+            return m_filename;
+        }
+
+    private:
+        const IReporterConfig& m_config;
+        TeeStreamBuf m_buf;
+        mutable std::ostream m_os;
+        std::string m_filename;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Reporters are created when testing starts, once all of them (and their
+    // outputs) are known. Outputs that ask for the same reporter share one
+    // instance, which writes to all of them - so its formatting is done once
+    class MultiReporter : public IReporter
+    {
+        struct Sink
+        {
+            std::string name;
+            std::vector<std::ostream*> targets;
+            std::vector<std::string> filenames;
+        };
+
+    public:
+        ///////////////////////////////////////////////////////////////////////
+        explicit MultiReporter
+        (
+            const IReporterConfig& config
+        )
+        :   m_config( config )
+        {
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        ~MultiReporter
+        ()
+        {
+            deleteAll( m_reporters );
+            deleteAll( m_sinkConfigs );
+            deleteAll( m_streams );
+            deleteAll( m_streamBufs );
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // Spec is <reporter name>[::out=<file name>|%<stream name>].
+        // Returns an error message, if there is one
+        std::string addReporter
+        (
+            const std::string& spec
+        )
+        {
+            std::string name;
+            std::string destination;
+            std::string error = parseSpec( spec, name, destination );
+            if( !error.empty() )
+                return error;
+            if( Hub::getReporterRegistry().getFactories().count( name ) == 0 )
+                return "Unrecognised reporter: " + name;
+            if( !m_reporters.empty() )
+                return "Reporters can't be added once testing has started";
+
+            std::ostream* target = &m_config.stream();
+            std::string filename;
+            if( !destination.empty() )
+            {
+                if( destination[0] != '%' )
+                    filename = destination;
+                error = openDestination( destination, target );
+                if( !error.empty() )
+                    return error;
+            }
+
+            std::vector<Sink>::iterator it = m_sinks.begin();
+            std::vector<Sink>::iterator itEnd = m_sinks.end();
+            for(; it != itEnd && it->name != name; ++it )
+                ;
+            if( it == itEnd )
+                it = m_sinks.insert( itEnd, Sink() );
+            it->name = name;
+            if( std::find( it->targets.begin(), it->targets.end(), target ) == it->targets.end() )
+            {
+                it->targets.push_back( target );
+                it->filenames.push_back( filename );
+            }
+            return "";
+        }
+
+    private: // IReporter
+
+        ///////////////////////////////////////////////////////////////////////
+        virtual void StartTesting
+        ()
+        {
+            if( m_reporters.empty() )
+                createReporters();
+            for( std::size_t i = 0; i < m_reporters.size(); ++i )
+                m_reporters[i]->StartTesting();
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        virtual void EndTesting
+        (
+            std::size_t succeeded,
+            std::size_t failed
+        )
+        {
+            for( std::size_t i = 0; i < m_reporters.size(); ++i )
+                m_reporters[i]->EndTesting( succeeded, failed );
+            for( std::size_t i = 0; i < m_sinkConfigs.size(); ++i )
+                m_sinkConfigs[i]->stream().flush();
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        virtual void StartGroup
+        (
+            const std::string& groupName
+        )
+        {
+            for( std::size_t i = 0; i < m_reporters.size(); ++i )
+                m_reporters[i]->StartGroup( groupName );
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        virtual void EndGroup
+        (
+            const std::string& groupName,
+            std::size_t succeeded,
+            std::size_t failed
+        )
+        {
+            for( std::size_t i = 0; i < m_reporters.size(); ++i )
+                m_reporters[i]->EndGroup( groupName, succeeded, failed );
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        virtual void StartSection
+        (
+            const std::string& sectionName,
+            const std::string description
+        )
+        {
+            for( std::size_t i = 0; i < m_reporters.size(); ++i )
+                m_reporters[i]->StartSection( sectionName, description );
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        virtual void EndSection
+        (
+            const std::string& sectionName,
+            std::size_t succeeded,
+            std::size_t failed,
+            const std::string& stdOut,
+            const std::string& stdErr,
+            const ResourceUsage& usage
+        )
+        {
+            for( std::size_t i = 0; i < m_reporters.size(); ++i )
+                m_reporters[i]->EndSection( sectionName, succeeded, failed, stdOut, stdErr, usage );
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        virtual void EndGeneratorCombination
+        (
+            std::size_t combination,
+            std::size_t succeeded,
+            std::size_t failed,
+            const ResourceUsage& usage
+        )
+        {
+            for( std::size_t i = 0; i < m_reporters.size(); ++i )
+                m_reporters[i]->EndGeneratorCombination( combination, succeeded, failed, usage );
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        virtual void StartTestCase
+        (
+            const TestCaseInfo& testInfo
+        )
+        {
+            for( std::size_t i = 0; i < m_reporters.size(); ++i )
+                m_reporters[i]->StartTestCase( testInfo );
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        virtual void EndTestCase
+        (
+            const TestCaseInfo& testInfo,
+            std::size_t succeeded,
+            std::size_t failed,
+            const std::string& stdOut,
+            const std::string& stdErr,
+            const ResourceUsage& usage
+        )
+        {
+            for( std::size_t i = 0; i < m_reporters.size(); ++i )
+                m_reporters[i]->EndTestCase( testInfo, succeeded, failed, stdOut, stdErr, usage );
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        virtual void Result
+        (
+            const ResultInfo& result
+        )
+        {
+            for( std::size_t i = 0; i < m_reporters.size(); ++i )
+                m_reporters[i]->Result( result );
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        virtual void TestCaseRepeated
+        (
+            const RepeatStats& stats
+        )
+        {
+            for( std::size_t i = 0; i < m_reporters.size(); ++i )
+                m_reporters[i]->TestCaseRepeated( stats );
+        }
+
+    private:
+
+        ///////////////////////////////////////////////////////////////////////
+        void createReporters
+        ()
+        {
+            std::vector<Sink>::const_iterator it = m_sinks.begin();
+            std::vector<Sink>::const_iterator itEnd = m_sinks.end();
+            for(; it != itEnd; ++it )
+            {
+                // A reporter writing only to the main output uses it directly
+                // (so, e.g., it can still seek in it)
+                if( it->targets.size() == 1 && it->targets[0] == &m_config.stream() )
+                {
+                    m_reporters.push_back( Hub::getReporterRegistry().create( it->name, m_config ) );
+                }
+                else
+                {
+                    std::string filename = it->targets.size() == 1 ? it->filenames[0] : "";
+                    m_sinkConfigs.push_back( new ReporterSinkConfig( m_config, it->targets, filename ) );
+                    m_reporters.push_back( Hub::getReporterRegistry().create( it->name, *m_sinkConfigs.back() ) );
+                }
+            }
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        std::string openDestination
+        (
+            const std::string& destination,
+            std::ostream*& target
+        )
+        {
+            if( destination[0] == '%' )
+            {
+                std::streambuf* buf = NULL;
+                try
+                {
+                    buf = Hub::createStreamBuf( destination.substr( 1 ) );
+                }
+                catch( std::exception& ex )
+                {
+                    return ex.what();
+                }
+                if( buf != std::cout.rdbuf() && buf != std::cerr.rdbuf() )
+                    m_streamBufs.push_back( buf );
+                m_streams.push_back( new std::ostream( buf ) );
+            }
+            else
+            {
+                std::ofstream* ofs = new std::ofstream( destination.c_str() );
+                m_streams.push_back( ofs );
+                if( ofs->fail() )
+                    return "Unable to open file: '" + destination + "'";
+            }
+            target = m_streams.back();
+            return "";
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        static std::string parseSpec
+        (
+            const std::string& spec,
+            std::string& name,
+            std::string& destination
+        )
+        {
+            std::string::size_type pos = spec.find( "::" );
+            name = spec.substr( 0, pos );
+            while( pos != std::string::npos )
+            {
+                std::string::size_type start = pos + 2;
+                pos = spec.find( "::", start );
+                std::string option = spec.substr( start, pos == std::string::npos ? pos : pos - start );
+                if( option.substr( 0, 4 ) == "out=" && option.size() > 4 )
+                    destination = option.substr( 4 );
+                else
+                    return "Unrecognised reporter option: '" + option + "' in: " + spec;
+            }
+            return "";
+        }
+
+    private:
+        const IReporterConfig& m_config;
+        std::vector<Sink> m_sinks;
+        std::vector<IReporter*> m_reporters;
+        std::vector<ReporterSinkConfig*> m_sinkConfigs;
+        std::vector<std::ostream*> m_streams;
+        std::vector<std::streambuf*> m_streamBufs;
+    };
+
+} // end namespace Catch
+
+#endif // TWOBLUECUBES_CATCH_REPORTER_MULTI_HPP_INCLUDED
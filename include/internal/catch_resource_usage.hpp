@@ -0,0 +1,91 @@
+/*
+ *  catch_resource_usage.hpp
+ *  Catch
+ *
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * What a test case, section or generator combination used while it ran,
+ * and when it ran
+ */
+
+#ifndef TWOBLUECUBES_CATCH_RESOURCE_USAGE_HPP_INCLUDED
+#define TWOBLUECUBES_CATCH_RESOURCE_USAGE_HPP_INCLUDED
+
+#include <cstddef>
+#include <stdint.h>
+
+namespace Catch
+{
+    struct ResourceUsage
+    {
+        ///////////////////////////////////////////////////////////////////////
+        ResourceUsage
+        ()
+        :   timed( false ),
+            startMicroseconds( 0 ),
+            durationMicroseconds( 0 ),
+            worker( 0 ),
+            allocationsCounted( false ),
+            allocations( 0 ),
+            deallocations( 0 ),
+            bytesAllocated( 0 ),
+            bytesFreed( 0 ),
+            peakBytes( 0 ),
+            processUsageRecorded( false ),
+            peakRssGrowth( 0 ),
+            minorFaults( 0 ),
+            majorFaults( 0 ),
+            voluntarySwitches( 0 ),
+            involuntarySwitches( 0 ),
+            descriptorsLeaked( 0 )
+        {
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // Allocations that were not freed again
+        bool leaked
+        ()
+        const
+        {
+            return allocationsCounted && allocations > deallocations;
+        }
+
+        // When it started, from getCurrentMicroseconds(), how long it took and
+        // where it ran: 0 for this process, or the number of the worker
+        // process (from 1) it ran in. Set by the runner, but not by a binary
+        // log being converted
+        bool timed;
+        uint64_t startMicroseconds;
+        uint64_t durationMicroseconds;
+        std::size_t worker;
+
+        // Set when run with --allocations. Only allocations made through
+        // operator new on the thread running the tests are counted, and a
+        // deallocation is only counted if its allocation was. peakBytes is
+        // the most that was allocated and not yet freed at any one time
+        bool allocationsCounted;
+        std::size_t allocations;
+        std::size_t deallocations;
+        std::size_t bytesAllocated;
+        std::size_t bytesFreed;
+        std::size_t peakBytes;
+
+        // Set for test cases when run with --resources. These are the
+        // process's own figures, so they only mean much for tests run one at
+        // a time. Faults and context switches include those of any worker
+        // processes that finished during the test case. descriptorsLeaked is
+        // how many more file descriptors were open at the end than at the
+        // start
+        bool processUsageRecorded;
+        std::size_t peakRssGrowth;
+        std::size_t minorFaults;
+        std::size_t majorFaults;
+        std::size_t voluntarySwitches;
+        std::size_t involuntarySwitches;
+        std::size_t descriptorsLeaked;
+    };
+
+} // end namespace Catch
+
+#endif // TWOBLUECUBES_CATCH_RESOURCE_USAGE_HPP_INCLUDED
@@ -41,8 +41,20 @@ struct ResultWas{ enum OfType
         {
             None,
             Failed = 1,     // Failure - but no debug break if Debug bit not set
-            DebugFailed = 3 // Indicates that the debugger should break, if possible
+            DebugFailed = 3, // Indicates that the debugger should break, if possible
+            Abort = 5,      // Failure, and the run is being aborted - so the test case ends here, even for a CHECK
+            DebugAbort = 7  // Both of the above
         };    
+
+        static bool shouldDebugBreak( Value action )
+        {
+            return ( action & DebugFailed ) == DebugFailed;
+        }
+
+        static bool shouldAbort( Value action )
+        {
+            return ( action & Abort ) == Abort;
+        }
     };
     
 }
@@ -158,6 +158,11 @@ namespace Catch
         }        
         
     protected:
+        friend class EventWriter;
+        friend class EventReader;
+        friend class BinaryReporter;
+        friend class BinaryLogReader;
+
         std::string m_macroName;
         std::string m_filename;
         std::size_t m_line;
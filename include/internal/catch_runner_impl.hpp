@@ -12,13 +12,26 @@
 #ifndef TWOBLUECUBES_INTERNAL_CATCH_RUNNER_HPP_INCLUDED
 #define TWOBLUECUBES_INTERNAL_CATCH_RUNNER_HPP_INCLUDED
 
+#include "catch_allocation_counter.hpp"
 #include "catch_interfaces_runner.h"
 #include "catch_interfaces_reporter.h"
 #include "catch_config.hpp"
 #include "catch_test_registry.hpp"
 #include "catch_test_case_info.hpp"
 #include "catch_capture.hpp"
+#include "catch_event_stream.hpp"
+#include "catch_output_capture.hpp"
+#include "catch_process_usage.hpp"
+#include "catch_random.hpp"
+#include "catch_repetitions.hpp"
+#include "catch_shared_fixture.hpp"
+#include "catch_timer.hpp"
+#include "catch_watchdog.hpp"
+#include "catch_worker_plan.hpp"
+#include "catch_workers.hpp"
 
+#include <map>
+#include <memory>
 #include <set>
 #include <string>
 
@@ -32,28 +45,27 @@ namespace Catch
         StreamRedirect
         (
             std::ostream& stream, 
-            std::string& targetString
+            OutputCollector& collector,
+            OutputCollector::Stream which
         )
         :   m_stream( stream ),
             m_prevBuf( stream.rdbuf() ),
-            m_targetString( targetString )
+            m_buf( collector, which )
         {            
-            stream.rdbuf( m_oss.rdbuf() );
+            stream.rdbuf( &m_buf );
         }
         
         ///////////////////////////////////////////////////////////////////////        
         ~StreamRedirect
         ()
         {
-            m_targetString = m_oss.str();
             m_stream.rdbuf( m_prevBuf );
         }
         
     private:
         std::ostream& m_stream;
         std::streambuf* m_prevBuf;
-        std::ostringstream m_oss;
-        std::string& m_targetString;
+        CaptureStreamBuf m_buf;
     };
     
     
@@ -289,7 +301,7 @@ namespace Catch
     
     ///////////////////////////////////////////////////////////////////////////
     ///////////////////////////////////////////////////////////////////////////    
-    class Runner : public IResultCapture, public IRunner
+    class Runner : public IResultCapture, public IRunner, private IWorkerTask
     {
         Runner( const Runner& );
         void operator =( const Runner& );
@@ -307,10 +319,18 @@ namespace Catch
             m_failures( 0 ),
             m_reporter( m_config.getReporter() ),
             m_prevRunner( &Hub::getRunner() ),
-            m_prevResultCapture( &Hub::getResultCapture() )
+            m_prevResultCapture( &Hub::getResultCapture() ),
+            m_prevReportBuf( NULL ),
+            m_output( config.getOutputLimit() ),
+            m_timedOut( false ),
+            m_threadLeftRunning( false ),
+            m_repetitions( config ),
+            m_workers( config )
         {
             Hub::setRunner( this );
             Hub::setResultCapture( this );
+            if( m_config.getCapture() == Config::Capture::Descriptors && canCaptureDescriptors() )
+                startCapturingDescriptors();
             m_reporter->StartTesting();
         }
         
@@ -319,6 +339,11 @@ namespace Catch
         ()
         {
             m_reporter->EndTesting( m_successes, m_failures );
+            if( m_prevReportBuf )
+            {
+                m_config.stream().flush();
+                m_config.stream().rdbuf( m_prevReportBuf );
+            }
             Hub::setRunner( m_prevRunner );
             Hub::setResultCapture( m_prevResultCapture );
         }
@@ -330,7 +355,13 @@ namespace Catch
         )
         {
             std::vector<TestCaseInfo> allTests = Hub::getTestCaseRegistry().getAllTests();
+            orderTests( allTests );
             for( std::size_t i=0; i < allTests.size(); ++i )
+            {
+                if( runHiddenTests || !allTests[i].isHidden() )
+                    allTests[i].start();
+            }
+            for( std::size_t i=0; i < allTests.size() && !stopping(); ++i )
             {
                 if( runHiddenTests || !allTests[i].isHidden() )
                    runTest( allTests[i] );
@@ -346,8 +377,17 @@ namespace Catch
             TestSpec testSpec( rawTestSpec );
             
             std::vector<TestCaseInfo> allTests = Hub::getTestCaseRegistry().getAllTests();
-            std::size_t testsRun = 0;
+            orderTests( allTests );
+            // Asynchronous test cases start together, so they can run
+            // alongside each other. Any not run (such as when the run is
+            // aborted) are stopped as allTests goes
             for( std::size_t i=0; i < allTests.size(); ++i )
+            {
+                if( testSpec.matches( allTests[i].getName() ) )
+                    allTests[i].start();
+            }
+            std::size_t testsRun = 0;
+            for( std::size_t i=0; i < allTests.size() && !stopping(); ++i )
             {
                 if( testSpec.matches( allTests[i].getName() ) )
                 {
@@ -358,6 +398,31 @@ namespace Catch
             return testsRun;
         }
         
+        ///////////////////////////////////////////////////////////////////////////
+        // Runs the selected tests over and over, for --repeat and
+        // --until-fail, then reports how each test case fared across the
+        // repetitions. Each repetition is a group of its own, which runs the
+        // tests as a run without --repeat would. With more than one worker,
+        // that many repetitions are run at once, each in a worker process
+        void runRepeatedly
+        ()
+        {
+            // 0 repeats until something fails
+            std::size_t repetitions = m_repetitions.getLimit();
+            if( m_config.getWorkerCount() > 1 && repetitions != 1 && canRunWorkers() )
+            {
+                runRepetitionsInWorkers( repetitions );
+            }
+            else
+            {
+                for( std::size_t i = 0; repetitions == 0 || i < repetitions; ++i )
+                    if( runRepetition( i ) == 0 || stopping() )
+                        break;
+            }
+            m_repetitions.finish();
+            m_repetitions.report( *m_reporter );
+        }
+
         ///////////////////////////////////////////////////////////////////////////
         void runTest
         (
@@ -366,32 +431,110 @@ namespace Catch
         {
             std::size_t prevSuccessCount = m_successes;
             std::size_t prevFailureCount = m_failures;
+            uint64_t start = getCurrentMicroseconds();
 
-            std::string redirectedCout;
-            std::string redirectedCerr;
-            
+            // Only the tests' own code is counted - see runCurrentTest
+            AllocationCounter::Pause pause;
+            if( m_config.countAllocations() )
+                AllocationCounter::startScope();
+
+            m_output.startTestCase();
             m_reporter->StartTestCase( testInfo );
+
+            ProcessUsage processUsageAtStart;
+            if( m_config.recordProcessUsage() )
+                processUsageAtStart = ProcessUsage::now();
             
             m_runningTest = new RunningTest( &testInfo );
+            m_timedOut = false;
 
-            do
+            // The first pass discovers the generators (if any), and so how
+            // many combinations there are to run
+            runGeneratorCombination( 0 );
+
+            std::size_t combinations = Hub::getGeneratorCombinationCount();
+            orderGeneratorCombinations( testInfo, combinations );
+            // A worker process (such as one running repetitions) doesn't
+            // start workers of its own
+            if( !m_timedOut && !aborting() && m_workers.getCurrentWorker() == 0 && m_config.getWorkerCount() > 1 && combinations > 2 && canRunWorkers() )
             {
-                do
+                runGeneratorCombinationsInWorkers( combinations );
+            }
+            else if( !m_combinationOrder.empty() )
+            {
+                for( std::size_t i = 1; i < combinations; ++i )
                 {
-                    m_currentResult.setFileAndLine( m_runningTest->getTestCaseInfo().getFilename(), 
-                                                    m_runningTest->getTestCaseInfo().getLine() );
-                    runCurrentTest( redirectedCout, redirectedCerr );
+                    Hub::setGeneratorCombination( m_combinationOrder[i] );
+                    runGeneratorCombination( m_combinationOrder[i] );
                 }
-                while( m_runningTest->hasUntestedSections() );
+                Hub::setGeneratorCombination( 0 );
+            }
+            else
+            {
+                for( std::size_t i = 1; Hub::advanceGeneratorsForCurrentTest(); ++i )
+                    runGeneratorCombination( i );
             }
-            while( Hub::advanceGeneratorsForCurrentTest() );
 
             delete m_runningTest;
             m_runningTest = NULL;
 
-            m_reporter->EndTestCase( testInfo, m_successes - prevSuccessCount, m_failures - prevFailureCount, redirectedCout, redirectedCerr );
+            ResourceUsage usage;
+            setTiming( usage, start );
+            if( m_config.countAllocations() )
+            {
+                AllocationCounter::endScope( usage );
+                if( usage.leaked() )
+                {
+                    std::ostringstream oss;
+                    oss << "Test case leaked " << usage.allocations - usage.deallocations
+                        << " of its " << usage.allocations << " allocation(s) ("
+                        << usage.bytesAllocated - usage.bytesFreed << " bytes)";
+                    m_currentResult.setFileAndLine( testInfo.getFilename(), testInfo.getLine() );
+                    acceptMessage( oss.str() );
+                    acceptResult( ResultWas::ExplicitFailure );
+                }
+            }
+            if( m_config.recordProcessUsage() )
+            {
+                ProcessUsage::now().since( processUsageAtStart, usage );
+                if( usage.descriptorsLeaked > 0 )
+                {
+                    std::ostringstream oss;
+                    oss << "Test case left " << usage.descriptorsLeaked << " more file descriptor(s) open than it started with";
+                    m_currentResult.setFileAndLine( testInfo.getFilename(), testInfo.getLine() );
+                    acceptMessage( oss.str() );
+                    acceptResult( ResultWas::ExplicitFailure );
+                }
+            }
+
+            std::string stdOut;
+            std::string stdErr;
+            m_output.getTestCaseOutput( stdOut, stdErr );
+            m_reporter->EndTestCase( testInfo, m_successes - prevSuccessCount, m_failures - prevFailureCount, stdOut, stdErr, usage );
+            if( m_config.isRepeating() )
+                m_repetitions.addRun( testInfo.getName(), m_failures > prevFailureCount, usage.durationMicroseconds );
         }
         
+        ///////////////////////////////////////////////////////////////////////////
+        // True once as many assertions have failed as the run is allowed
+        bool aborting
+        ()
+        const
+        {
+            return m_config.getAbortAfter() != 0 && m_failures >= m_config.getAbortAfter();
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        // Aborting, repeating until a test case fails and one has, or a
+        // timed out test's thread couldn't be stopped (and would carry on
+        // alongside whatever ran next)
+        bool stopping
+        ()
+        const
+        {
+            return aborting() || m_threadLeftRunning || ( m_config.repeatUntilFail() && m_repetitions.anyFailed() );
+        }
+
         ///////////////////////////////////////////////////////////////////////////
         virtual std::size_t getSuccessCount
         ()
@@ -408,8 +551,38 @@ namespace Catch
             return m_failures;
         }
 
+        ///////////////////////////////////////////////////////////////////////////
+        // Each repetition of a repeated run has a seed of its own
+        virtual unsigned int getRngSeed
+        ()
+        const
+        {
+            return m_repetitions.getRngSeed() != 0
+                ? m_repetitions.getRngSeed()
+                : m_config.getRngSeed();
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        virtual unsigned int getScheduleSeed
+        ()
+        const
+        {
+            return m_config.getScheduleSeed();
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        virtual unsigned int getPropertySeed
+        ()
+        const
+        {
+            return m_config.getPropertySeed();
+        }
+
     private: // IResultCapture
 
+        // These are called from the tests, but what the framework allocates
+        // isn't counted as the test's
+
         ///////////////////////////////////////////////////////////////////////////
         virtual ResultAction::Value acceptResult
         (
@@ -425,6 +598,7 @@ namespace Catch
             ResultWas::OfType result
         )
         {
+            AllocationCounter::Pause pause;
             m_currentResult.setResultType( result );            
             return actOnCurrentResult();
         }
@@ -435,6 +609,7 @@ namespace Catch
             const MutableResultInfo& resultInfo
         )
         {
+            AllocationCounter::Pause pause;
             m_currentResult = resultInfo;
             return actOnCurrentResult();
         }
@@ -445,6 +620,7 @@ namespace Catch
             const std::string& msg
         )
         {
+            AllocationCounter::Pause pause;
             m_currentResult.setMessage( msg );
         }
                 
@@ -454,6 +630,7 @@ namespace Catch
             const ResultInfo& result        
         )
         { 
+            AllocationCounter::Pause pause;
             if( result.getResultType() == ResultWas::Ok )
             {
                 m_successes++;
@@ -486,6 +663,7 @@ namespace Catch
             std::size_t& failures 
         )
         {
+            AllocationCounter::Pause pause;
             std::ostringstream oss;
             oss << filename << ":" << line;
 
@@ -493,6 +671,11 @@ namespace Catch
                 return false;
 
             m_currentResult.setFileAndLine( filename, line );
+            collectOutput();
+            m_output.startSection();
+            if( m_config.countAllocations() )
+                AllocationCounter::startScope();
+            m_sectionStarts.push_back( getCurrentMicroseconds() );
             m_reporter->StartSection( name, description );
             successes = m_successes;
             failures = m_failures;
@@ -508,8 +691,21 @@ namespace Catch
             std::size_t prevFailures 
         )
         {
+            AllocationCounter::Pause pause;
+            ResourceUsage usage;
+            if( !m_sectionStarts.empty() )
+            {
+                setTiming( usage, m_sectionStarts.back() );
+                m_sectionStarts.pop_back();
+            }
+            if( m_config.countAllocations() )
+                AllocationCounter::endScope( usage );
             m_runningTest->endSection( name );
-            m_reporter->EndSection( name, m_successes - prevSuccesses, m_failures - prevFailures );
+            collectOutput();
+            std::string stdOut;
+            std::string stdErr;
+            m_output.endSection( stdOut, stdErr );
+            m_reporter->EndSection( name, m_successes - prevSuccesses, m_failures - prevFailures, stdOut, stdErr, usage );
         }
 
         ///////////////////////////////////////////////////////////////////////////
@@ -518,6 +714,7 @@ namespace Catch
             ScopedInfo* scopedInfo 
         )
         {
+            AllocationCounter::Pause pause;
             m_scopedInfos.push_back( scopedInfo );
         }
 
@@ -561,6 +758,8 @@ namespace Catch
             m_currentResult = MutableResultInfo();
             if( ok )
                 return ResultAction::None;
+            else if( aborting() )
+                return shouldDebugBreak() ? ResultAction::DebugAbort : ResultAction::Abort;
             else if( shouldDebugBreak() )
                 return ResultAction::DebugFailed;
             else
@@ -568,24 +767,454 @@ namespace Catch
         }
 
         ///////////////////////////////////////////////////////////////////////////
-        void runCurrentTest
+        // A report going to stdout or stderr is written to where they were
+        // before being captured, so it doesn't end up in the tests' output
+        void startCapturingDescriptors
+        ()
+        {
+            m_outputCapture.reset( new OutputCapture() );
+            if( !m_outputCapture->isValid() )
+            {
+                m_outputCapture.reset();
+                return;
+            }
+            std::streambuf* reportBuf = m_config.stream().rdbuf();
+            if( reportBuf == std::cout.rdbuf() )
+                m_prevReportBuf = m_config.stream().rdbuf( m_outputCapture->getOriginalStdOut() );
+            else if( reportBuf == std::cerr.rdbuf() )
+                m_prevReportBuf = m_config.stream().rdbuf( m_outputCapture->getOriginalStdErr() );
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        // Brings m_output up to date with what the test has written
+        void collectOutput
+        ()
+        {
+            if( m_outputCapture.get() )
+            {
+                m_outputCapture->drain( m_output );
+            }
+            else
+            {
+                std::cout.flush();
+                std::cerr.flush();
+            }
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        void orderTests
+        (
+            std::vector<TestCaseInfo>& tests
+        )
+        const
+        {
+            if( unsigned int rngSeed = getRngSeed() )
+            {
+                Detail::SeededRandom rng( rngSeed );
+                Detail::shuffle( tests, rng );
+            }
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        // Combination 0 has always run first (it is how the generators are
+        // discovered); the rest are shuffled. The order is seeded by the test
+        // name too, so it doesn't depend on which other tests were selected
+        void orderGeneratorCombinations
+        (
+            const TestCaseInfo& testInfo,
+            std::size_t combinations
+        )
+        {
+            m_combinationOrder.clear();
+            unsigned int rngSeed = getRngSeed();
+            if( rngSeed == 0 || combinations <= 2 )
+                return;
+
+            m_combinationOrder.reserve( combinations );
+            for( std::size_t i = 0; i < combinations; ++i )
+                m_combinationOrder.push_back( i );
+            std::vector<std::size_t> rest( m_combinationOrder.begin()+1, m_combinationOrder.end() );
+            Detail::SeededRandom rng( rngSeed ^ Detail::hashName( testInfo.getName() ) );
+            Detail::shuffle( rest, rng );
+            std::copy( rest.begin(), rest.end(), m_combinationOrder.begin()+1 );
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        // Test cases with generators report each combination as it ends. Once
+        // a test case has timed out, or the run is aborting, the rest of it
+        // is skipped
+        void runGeneratorCombination
+        (
+            std::size_t combination
+        )
+        {
+            if( m_timedOut || aborting() )
+                return;
+            std::size_t prevSuccessCount = m_successes;
+            std::size_t prevFailureCount = m_failures;
+            uint64_t start = getCurrentMicroseconds();
+            do
+            {
+                m_currentResult.setFileAndLine( m_runningTest->getTestCaseInfo().getFilename(), 
+                                                m_runningTest->getTestCaseInfo().getLine() );
+                runCurrentTest();
+            }
+            while( m_runningTest->hasUntestedSections() && !m_timedOut && !aborting() );
+
+            if( Hub::getGeneratorCombinationCount() > 1 )
+            {
+                ResourceUsage usage;
+                setTiming( usage, start );
+                m_reporter->EndGeneratorCombination( combination, m_successes - prevSuccessCount, m_failures - prevFailureCount, usage );
+            }
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        void setTiming
+        (
+            ResourceUsage& usage,
+            uint64_t start
+        )
+        const
+        {
+            usage.timed = true;
+            usage.startMicroseconds = start;
+            usage.durationMicroseconds = getCurrentMicroseconds() - start;
+            usage.worker = m_workers.getCurrentWorker();
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        // Events are replayed in worker order, so the reporter sees the same
+        // sequence as a serial run would produce
+        void runGeneratorCombinationsInWorkers
+        (
+            std::size_t combinations
+        )
+        {
+            std::size_t workerCount = m_workers.planCombinations( combinations, getTimeout( m_runningTest->getTestCaseInfo() ) );
+            std::vector<WorkerResult> results;
+            runWorkers( workerCount, *this, results, m_workers.getTimeout() );
+
+            for( std::size_t i = 0; i < workerCount; ++i )
+            {
+                // A cancelled worker's last combination may be half reported
+                if( results[i].cancelled )
+                    results[i].output.resize( WorkerPlan::endOfLast( results[i].output, Event::GeneratorCombinationEnded ) );
+                EventReader reader( results[i].output );
+                Event event;
+                while( reader.next( event ) )
+                    replayEvent( event );
+                if( results[i].timedOut )
+                {
+                    std::ostringstream oss;
+                    oss << "Worker process for generator combinations " << m_workers.getFirstCombination( i )
+                        << " to " << m_workers.getEndCombination( i )-1 << " was killed after " << TestTimedOut::formatTimeout( m_workers.getTimeout() );
+                    acceptMessage( oss.str() );
+                    acceptResult( ResultWas::ExplicitFailure );
+                }
+                else if( !results[i].cancelled && ( !results[i].completed || !reader.isValid() ) )
+                {
+                    std::ostringstream oss;
+                    oss << "Worker process for generator combinations " << m_workers.getFirstCombination( i )
+                        << " to " << m_workers.getEndCombination( i )-1 << " did not complete";
+                    acceptMessage( oss.str() );
+                    acceptResult( ResultWas::ThrewException );
+                }
+            }
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        // Raises an event from a worker as if it had happened here. Groups
+        // and test cases are replayed by runRepetitionsInWorkers
+        void replayEvent
+        (
+            const Event& event
+        )
+        {
+            switch( event.type )
+            {
+                case Event::SectionStarted:
+                    m_reporter->StartSection( event.name, event.text );
+                    break;
+                case Event::SectionEnded:
+                    m_reporter->EndSection( event.name, event.succeeded, event.failed, event.text, event.stdErr, event.usage );
+                    break;
+                case Event::GeneratorCombinationEnded:
+                    m_reporter->EndGeneratorCombination( event.combination, event.succeeded, event.failed, event.usage );
+                    break;
+                case Event::Result:
+                    if( event.result.getResultType() == ResultWas::Ok )
+                        m_successes++;
+                    else if( !event.result.ok() )
+                        m_failures++;
+                    m_reporter->Result( event.result );
+                    break;
+                case Event::StdOut:
+                    m_output.append( OutputCollector::StdOut, event.text );
+                    break;
+                case Event::StdErr:
+                    m_output.append( OutputCollector::StdErr, event.text );
+                    break;
+                case Event::Usage:
+                    AllocationCounter::add( event.usage );
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        virtual bool shouldCancelWorkers
         (
-            std::string& redirectedCout,
-            std::string& redirectedCerr
+            std::size_t workerIndex,
+            const std::string& output
         )
+        {
+            return m_workers.shouldCancel( workerIndex, output, m_failures );
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        // Runs the selected tests once, as a group named for the repetition
+        // (which counts from 0). Returns how many tests were run
+        std::size_t runRepetition
+        (
+            std::size_t repetition
+        )
+        {
+            std::string groupName = m_repetitions.start( repetition );
+            std::size_t prevSuccessCount = m_successes;
+            std::size_t prevFailureCount = m_failures;
+            std::size_t prevRuns = m_repetitions.getRunCount();
+
+            m_reporter->StartGroup( groupName );
+            if( !m_config.testsSpecified() )
+            {
+                runAll();
+            }
+            else
+            {
+                std::vector<std::string>::const_iterator it = m_config.getTestSpecs().begin();
+                std::vector<std::string>::const_iterator itEnd = m_config.getTestSpecs().end();
+                for(; it != itEnd && !stopping(); ++it )
+                    runMatching( *it );
+            }
+            m_reporter->EndGroup( groupName, m_successes - prevSuccessCount, m_failures - prevFailureCount );
+            SharedFixtures::endScope( FixtureScope::Group );
+            return m_repetitions.getRunCount() - prevRuns;
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        // The repetitions the workers ran are replayed in order, so the
+        // reporter sees what a serial run would have reported - up to the
+        // repetition that stopped the run, if one did
+        void runRepetitionsInWorkers
+        (
+            std::size_t repetitions
+        )
+        {
+            std::size_t workerCount = m_workers.planRepetitions( repetitions );
+            std::vector<WorkerResult> results;
+            runWorkers( workerCount, *this, results );
+
+            // A cancelled worker's last test case may be half reported
+            std::vector<std::vector<std::size_t> > starts( workerCount );
+            std::size_t mostRepetitions = 0;
+            for( std::size_t i = 0; i < workerCount; ++i )
+            {
+                if( results[i].cancelled )
+                    results[i].output.resize( WorkerPlan::endOfLast( results[i].output, Event::TestCaseEnded ) );
+                starts[i] = WorkerPlan::findRepetitions( results[i].output );
+                mostRepetitions = (std::max)( mostRepetitions, starts[i].size() );
+            }
+
+            std::map<std::string, TestCaseInfo> tests;
+            const std::vector<TestCaseInfo>& allTests = Hub::getTestCaseRegistry().getAllTests();
+            for( std::size_t i = 0; i < allTests.size(); ++i )
+                tests.insert( std::make_pair( allTests[i].getName(), allTests[i] ) );
+
+            // A worker that crashed has no more repetitions after the one it
+            // crashed in, but the others carry on
+            for( std::size_t repetition = 0; repetition < mostRepetitions * workerCount && !stopping(); ++repetition )
+            {
+                std::size_t worker = repetition % workerCount;
+                std::size_t index = repetition / workerCount;
+                if( index >= starts[worker].size() )
+                    continue;
+                std::size_t end = index+1 < starts[worker].size()
+                    ? starts[worker][index+1]
+                    : results[worker].output.size();
+                bool crashed = !results[worker].completed && !results[worker].cancelled;
+                replayRepetition( repetition, results[worker].output.substr( starts[worker][index], end - starts[worker][index] ), tests, crashed );
+            }
+            m_repetitions.finish();
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        // Whatever wasn't reported (because the worker was stopped, or
+        // crashed) is closed here, so the report is still well formed
+        void replayRepetition
+        (
+            std::size_t repetition,
+            const std::string& output,
+            const std::map<std::string, TestCaseInfo>& tests,
+            bool crashed
+        )
+        {
+            std::string groupName = m_repetitions.start( repetition );
+            std::size_t prevSuccessCount = m_successes;
+            std::size_t prevFailureCount = m_failures;
+            std::size_t testCaseSuccesses = 0;
+            std::size_t testCaseFailures = 0;
+            const TestCaseInfo* testInfo = NULL;
+            bool groupEnded = false;
+
+            EventReader reader( output );
+            Event event;
+            while( !groupEnded && reader.next( event ) )
+            {
+                switch( event.type )
+                {
+                    case Event::GroupStarted:
+                        m_reporter->StartGroup( groupName );
+                        break;
+                    case Event::GroupEnded:
+                        groupEnded = true;
+                        break;
+                    case Event::TestCaseStarted:
+                        {
+                            std::map<std::string, TestCaseInfo>::const_iterator it = tests.find( event.name );
+                            testInfo = it != tests.end() ? &it->second : NULL;
+                            if( testInfo )
+                                m_reporter->StartTestCase( *testInfo );
+                            testCaseSuccesses = m_successes;
+                            testCaseFailures = m_failures;
+                        }
+                        break;
+                    case Event::TestCaseEnded:
+                        if( testInfo )
+                        {
+                            m_reporter->EndTestCase( *testInfo, event.succeeded, event.failed, event.text, event.stdErr, event.usage );
+                            m_repetitions.addRun( testInfo->getName(), event.failed > 0, event.usage.durationMicroseconds );
+                        }
+                        testInfo = NULL;
+                        break;
+                    default:
+                        replayEvent( event );
+                        break;
+                }
+            }
+
+            if( testInfo )
+            {
+                if( crashed )
+                {
+                    std::ostringstream oss;
+                    oss << "Worker process running repetition " << repetition+1 << " did not complete";
+                    m_currentResult.setFileAndLine( testInfo->getFilename(), testInfo->getLine() );
+                    acceptMessage( oss.str() );
+                    acceptResult( ResultWas::ThrewException );
+                }
+                m_reporter->EndTestCase( *testInfo, m_successes - testCaseSuccesses, m_failures - testCaseFailures, "", "", ResourceUsage() );
+                if( crashed )
+                    m_repetitions.addRun( testInfo->getName(), true, 0 );
+            }
+            m_reporter->EndGroup( groupName, m_successes - prevSuccessCount, m_failures - prevFailureCount );
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        // Only ever runs in a worker process, which exits afterwards
+        virtual void runWorker
+        (
+            std::size_t workerIndex,
+            std::ostream& os
+        )
+        {
+            SharedFixtures::WorkerScope fixtureScope;
+            EventWriter writer( os );
+            m_reporter = &writer;
+            m_workers.enterWorker( workerIndex );
+            WorkerCaptureFiles captureFiles( m_outputCapture.get() );
+
+            if( m_workers.isRepeating() )
+            {
+                for(    std::size_t i = workerIndex;
+                        m_workers.hasRepetition( i ) && !stopping();
+                        i = m_workers.getNextRepetition( i ) )
+                {
+                    if( runRepetition( i ) == 0 )
+                        break;
+                    os.flush();
+                }
+                return;
+            }
+
+            // Only this worker's output and allocations go back to the parent
+            m_output.startTestCase();
+            if( m_config.countAllocations() )
+                AllocationCounter::startScope();
+
+            for(    std::size_t i = m_workers.getFirstCombination( workerIndex ); 
+                    i < m_workers.getEndCombination( workerIndex ); 
+                    ++i )
+            {
+                std::size_t combination = m_combinationOrder.empty()
+                                            ? i
+                                            : m_combinationOrder[i];
+                Hub::setGeneratorCombination( combination );
+                runGeneratorCombination( combination );
+                // So what has been reported survives the worker being killed
+                os.flush();
+            }
+            std::string stdOut;
+            std::string stdErr;
+            m_output.getTestCaseOutput( stdOut, stdErr );
+            writer.writeOutput( Event::StdOut, stdOut );
+            writer.writeOutput( Event::StdErr, stdErr );
+            if( m_config.countAllocations() )
+            {
+                ResourceUsage usage;
+                AllocationCounter::endScope( usage );
+                writer.writeUsage( usage );
+            }
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        void runCurrentTest
+        ()
         {            
+            const TestCaseInfo& testInfo = m_runningTest->getTestCaseInfo();
             try
             {
                 m_runningTest->reset();
-                StreamRedirect coutRedir( std::cout, redirectedCout );
-                StreamRedirect cerrRedir( std::cerr, redirectedCerr );
-                m_runningTest->getTestCaseInfo().invoke();
+                Watchdog::Scope watchdog( getTimeout( testInfo ) );
+                if( m_outputCapture.get() )
+                {
+                    ScopedOutputCapture capture( *m_outputCapture, m_output );
+                    AllocationCounter::Resume resume;
+                    m_runningTest->getTestCaseInfo().invoke();
+                }
+                else
+                {
+                    StreamRedirect coutRedir( std::cout, m_output, OutputCollector::StdOut );
+                    StreamRedirect cerrRedir( std::cerr, m_output, OutputCollector::StdErr );
+                    AllocationCounter::Resume resume;
+                    m_runningTest->getTestCaseInfo().invoke();
+                }
                 m_runningTest->ranToCompletion();
             }
             catch( TestFailureException& )
             {
                 // This just means the test was aborted due to failure
             }
+            catch( TestTimedOut& timedOut )
+            {
+                m_timedOut = true;
+                if( !timedOut.wasStopped() )
+                    m_threadLeftRunning = true;
+                m_currentResult.setFileAndLine( testInfo.getFilename(), testInfo.getLine() );
+                acceptMessage( timedOut.getMessage() );
+                acceptResult( ResultWas::ExplicitFailure );
+            }
             catch( std::exception& ex )
             {
                 acceptMessage( ex.what() );
@@ -608,6 +1237,19 @@ namespace Catch
             }
             m_info.clear();
         }
+
+        ///////////////////////////////////////////////////////////////////////////
+        // A test case's own timeout wins over the command line's
+        unsigned int getTimeout
+        (
+            const TestCaseInfo& testInfo
+        )
+        const
+        {
+            return testInfo.getTimeout() != 0
+                ? testInfo.getTimeout()
+                : m_config.getTimeout();
+        }
         
     private:
         RunningTest* m_runningTest;
@@ -621,6 +1263,15 @@ namespace Catch
         std::vector<ResultInfo> m_info;
         IRunner* m_prevRunner;
         IResultCapture* m_prevResultCapture;
+        std::vector<std::size_t> m_combinationOrder;
+        std::auto_ptr<OutputCapture> m_outputCapture;
+        std::streambuf* m_prevReportBuf;
+        OutputCollector m_output;
+        std::vector<uint64_t> m_sectionStarts;
+        bool m_timedOut;
+        bool m_threadLeftRunning;
+        Repetitions m_repetitions;
+        WorkerPlan m_workers;
     };
 }
 
@@ -23,16 +23,21 @@ namespace Catch
     {
     public:
         ///////////////////////////////////////////////////////////////////////        
+        // The strings are copied while allocation counting is paused, so
+        // nothing the runner holds on to shares a block that the test's
+        // allocation count would otherwise expect to see freed
         Section
         (
             const std::string& name, 
             const std::string& description,
-            const std::string& filename,
+            const char* filename,
             std::size_t line
         )
-        :   m_name( name ),
-            m_sectionIncluded( Hub::getResultCapture().sectionStarted( name, description, filename, line, m_successes, m_failures ) )
+        :   m_sectionIncluded( false )
         {
+            AllocationCounter::Pause pause;
+            m_name.assign( name.data(), name.size() );
+            m_sectionIncluded = Hub::getResultCapture().sectionStarted( m_name, std::string( description.data(), description.size() ), filename, line, m_successes, m_failures );
         }
 
         ///////////////////////////////////////////////////////////////////////        
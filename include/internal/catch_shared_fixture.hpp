@@ -0,0 +1,273 @@
+/*
+ *  catch_shared_fixture.hpp
+ *  Catch
+ *
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * Fixtures that are too expensive to set up for every test, so are set up
+ * once and shared, for the run, a group or a worker process
+ */
+
+#ifndef TWOBLUECUBES_CATCH_SHARED_FIXTURE_HPP_INCLUDED
+#define TWOBLUECUBES_CATCH_SHARED_FIXTURE_HPP_INCLUDED
+
+#include "catch_common.h"
+#include "catch_threading.hpp"
+
+#include <vector>
+
+namespace Catch
+{
+    struct FixtureScope { enum What {
+        Run,        // until the end of the run
+        Group,      // until the end of the group (a test spec given with -t, or a repetition)
+        Worker      // until the end of the worker process (or the run, outside of one)
+    }; };
+
+    struct ISharedFixture
+    {
+        virtual ~ISharedFixture
+        ()
+        {}
+
+        virtual FixtureScope::What getScope
+            () const = 0;
+
+        // Destroys the fixture, so the next test to use it sets it up again
+        virtual void tearDown
+            () = 0;
+
+        // Lets go of a fixture without destroying it, as a worker process
+        // does with one it inherited from its parent
+        virtual void forget
+            () = 0;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Keeps the fixtures that have been set up, in the order they were, so
+    // they can be torn down in reverse as their scopes end. A worker process
+    // starts with the fixtures its parent had set up. Those scoped to the
+    // worker are forgotten, so the worker sets up its own. The rest are
+    // shared with the parent, and are left for the parent to tear down
+    class SharedFixtures
+    {
+        struct State
+        {
+            ///////////////////////////////////////////////////////////////////
+            State
+            ()
+            :   inherited( 0 )
+            {
+            }
+
+            Mutex mutex;
+            std::vector<ISharedFixture*> fixtures;
+
+            // The first this many of fixtures belong to the parent process
+            std::size_t inherited;
+        };
+
+    public:
+        ///////////////////////////////////////////////////////////////////////
+        // Started by a worker process, which tears down everything it set up
+        // once it is done
+        class WorkerScope : NonCopyable
+        {
+        public:
+            ///////////////////////////////////////////////////////////////////
+            WorkerScope
+            ()
+            {
+                State& s = state();
+                ScopedLock lock( s.mutex );
+                std::vector<ISharedFixture*> kept;
+                for( std::size_t i = 0; i < s.fixtures.size(); ++i )
+                {
+                    if( s.fixtures[i]->getScope() == FixtureScope::Worker )
+                        s.fixtures[i]->forget();
+                    else
+                        kept.push_back( s.fixtures[i] );
+                }
+                s.fixtures.swap( kept );
+                s.inherited = s.fixtures.size();
+            }
+
+            ///////////////////////////////////////////////////////////////////
+            // The worker exits without running destructors, so the fixtures
+            // it inherited are only ever torn down by the parent
+            ~WorkerScope
+            ()
+            {
+                endAll();
+                State& s = state();
+                ScopedLock lock( s.mutex );
+                s.inherited = 0;
+            }
+        };
+
+        ///////////////////////////////////////////////////////////////////////
+        static void constructed
+        (
+            ISharedFixture& fixture
+        )
+        {
+            State& s = state();
+            ScopedLock lock( s.mutex );
+            s.fixtures.push_back( &fixture );
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // Tears down this process's fixtures with the scope, most recently
+        // set up first
+        static void endScope
+        (
+            FixtureScope::What scope
+        )
+        {
+            State& s = state();
+            ScopedLock lock( s.mutex );
+            for( std::size_t i = s.fixtures.size(); i > s.inherited; --i )
+            {
+                if( s.fixtures[i-1]->getScope() == scope )
+                {
+                    s.fixtures[i-1]->tearDown();
+                    s.fixtures.erase( s.fixtures.begin() + static_cast<std::ptrdiff_t>( i-1 ) );
+                }
+            }
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // Tears down all of this process's fixtures, whatever their scope
+        static void endAll
+        ()
+        {
+            State& s = state();
+            ScopedLock lock( s.mutex );
+            while( s.fixtures.size() > s.inherited )
+            {
+                s.fixtures.back()->tearDown();
+                s.fixtures.pop_back();
+            }
+        }
+
+    private:
+        ///////////////////////////////////////////////////////////////////////
+        static State& state
+        ()
+        {
+            static State s;
+            return s;
+        }
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // A T, default constructed the first time a test asks for it, then
+    // shared (read only) by every test until its scope ends. Declare one at
+    // namespace scope:
+    //
+    //     Catch::SharedFixture<Dataset> dataset( Catch::FixtureScope::Run );
+    //
+    // and call dataset.get() (or use dataset->) from any test that needs it
+    template<typename T>
+    class SharedFixture : public ISharedFixture, NonCopyable
+    {
+    public:
+        ///////////////////////////////////////////////////////////////////////
+        explicit SharedFixture
+        (
+            FixtureScope::What scope = FixtureScope::Run
+        )
+        :   m_scope( scope ),
+            m_instance( NULL )
+        {
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // Anything not torn down by the end of the run (such as when the
+        // runner was used directly) goes at exit. This doesn't touch the
+        // registry, which may already have been destroyed by then
+        virtual ~SharedFixture
+        ()
+        {
+            delete m_instance;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // If the constructor throws, the test that asked fails, and the next
+        // test to ask tries again
+        const T& get
+        ()
+        {
+            bool isNew = false;
+            {
+                ScopedLock lock( m_mutex );
+                if( m_instance == NULL )
+                {
+                    m_instance = new T();
+                    isNew = true;
+                }
+            }
+            // Registered once set up, so a fixture that its constructor
+            // asked for is torn down after it
+            if( isNew )
+                SharedFixtures::constructed( *this );
+            return *m_instance;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        const T* operator ->
+        ()
+        {
+            return &get();
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        bool isSetUp
+        ()
+        const
+        {
+            ScopedLock lock( m_mutex );
+            return m_instance != NULL;
+        }
+
+    private: // ISharedFixture
+
+        ///////////////////////////////////////////////////////////////////////
+        virtual FixtureScope::What getScope
+        ()
+        const
+        {
+            return m_scope;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        virtual void tearDown
+        ()
+        {
+            ScopedLock lock( m_mutex );
+            delete m_instance;
+            m_instance = NULL;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        virtual void forget
+        ()
+        {
+            ScopedLock lock( m_mutex );
+            m_instance = NULL;
+        }
+
+    private:
+        FixtureScope::What m_scope;
+        mutable Mutex m_mutex;
+        T* m_instance;
+    };
+
+} // end namespace Catch
+
+#endif // TWOBLUECUBES_CATCH_SHARED_FIXTURE_HPP_INCLUDED
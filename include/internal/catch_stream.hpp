@@ -13,6 +13,9 @@
 #ifndef TWOBLUECUBES_CATCH_STREAM_HPP_INCLUDED
 #define TWOBLUECUBES_CATCH_STREAM_HPP_INCLUDED
 
+#include "catch_hub.h"
+#include "catch_debugger.hpp"
+
 #include <stdexcept>
 #include <cstdio>
 
@@ -32,6 +35,16 @@ namespace Catch
             setp( data, data + sizeof(data) );
         }
 
+        ///////////////////////////////////////////////////////////////////////
+        explicit StreamBufImpl
+        (
+            const WriterF& writer
+        )
+        :   m_writer( writer )
+        {
+            setp( data, data + sizeof(data) );
+        }
+
         ///////////////////////////////////////////////////////////////////////
         ~StreamBufImpl
         ()
@@ -0,0 +1,606 @@
+/*
+ *  catch_stress.hpp
+ *  Catch
+ *
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * Runs a test body on several threads at once, to shake out races
+ */
+
+#ifndef TWOBLUECUBES_CATCH_STRESS_HPP_INCLUDED
+#define TWOBLUECUBES_CATCH_STRESS_HPP_INCLUDED
+
+#include "catch_capture.hpp"
+#include "catch_interfaces_capture.h"
+#include "catch_interfaces_exception.h"
+#include "catch_interfaces_runner.h"
+#include "catch_test_registry.hpp"
+#include "catch_threading.hpp"
+#include "catch_timer.hpp"
+
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace Catch
+{
+namespace Detail
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Stands in for the runner while a stress test's threads run, passing
+    // their results on to it one at a time. Failures are labelled with the
+    // thread they happened on
+    class StressResultCapture : public IResultCapture
+    {
+    public:
+        ///////////////////////////////////////////////////////////////////////
+        explicit StressResultCapture
+        (
+            std::size_t threads
+        )
+        :   m_prevResultCapture( &Hub::getResultCapture() ),
+            m_threadIds( threads ),
+            m_isRegistered( threads, false )
+        {
+            Hub::setResultCapture( this );
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        ~StressResultCapture
+        ()
+        {
+            Hub::setResultCapture( m_prevResultCapture );
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // Called by each thread as it starts
+        void registerThread
+        (
+            std::size_t index
+        )
+        {
+            ScopedLock lock( m_mutex );
+            m_threadIds[index] = getCurrentThreadId();
+            m_isRegistered[index] = true;
+        }
+
+    private: // IResultCapture
+
+        ///////////////////////////////////////////////////////////////////////
+        virtual void testEnded
+        (
+            const ResultInfo& result
+        )
+        {
+            ScopedLock lock( m_mutex );
+            m_prevResultCapture->testEnded( result );
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // Sections all run on every iteration of a stress test
+        virtual bool sectionStarted
+        (
+            const std::string&,
+            const std::string&,
+            const std::string&,
+            std::size_t,
+            std::size_t&,
+            std::size_t&
+        )
+        {
+            return true;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        virtual void sectionEnded
+        (
+            const std::string&,
+            std::size_t,
+            std::size_t
+        )
+        {
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // The runner keeps one stack of scoped info, which the threads can't
+        // share, so theirs isn't passed on
+        virtual void pushScopedInfo
+        (
+            ScopedInfo*
+        )
+        {
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        virtual void popScopedInfo
+        (
+            ScopedInfo*
+        )
+        {
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        virtual bool shouldDebugBreak
+        ()
+        const
+        {
+            ScopedLock lock( m_mutex );
+            return m_prevResultCapture->shouldDebugBreak();
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        virtual ResultAction::Value acceptResult
+        (
+            bool result
+        )
+        {
+            return acceptResult( result ? ResultWas::Ok : ResultWas::ExpressionFailed );
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // Only the runner pairs these with acceptMessage, and it doesn't
+        // while a stress test runs, so each result stands on its own
+        virtual ResultAction::Value acceptResult
+        (
+            ResultWas::OfType result
+        )
+        {
+            MutableResultInfo resultInfo;
+            resultInfo.setResultType( result );
+            return acceptExpression( resultInfo );
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        virtual ResultAction::Value acceptExpression
+        (
+            const MutableResultInfo& resultInfo
+        )
+        {
+            ScopedLock lock( m_mutex );
+            if( resultInfo.ok() )
+                return m_prevResultCapture->acceptExpression( resultInfo );
+
+            MutableResultInfo labelled( resultInfo );
+            std::ostringstream oss;
+            if( !resultInfo.getMessage().empty() )
+                oss << resultInfo.getMessage() << " ";
+            oss << "(on thread " << getThreadIndex() + 1 << " of " << m_threadIds.size() << ")";
+            labelled.setMessage( oss.str() );
+            return m_prevResultCapture->acceptExpression( labelled );
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        virtual void acceptMessage
+        (
+            const std::string&
+        )
+        {
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        virtual std::string getCurrentTestName
+        ()
+        const
+        {
+            return m_prevResultCapture->getCurrentTestName();
+        }
+
+    private:
+
+        ///////////////////////////////////////////////////////////////////////
+        // m_mutex must be locked
+        std::size_t getThreadIndex
+        ()
+        const
+        {
+            ThreadId current = getCurrentThreadId();
+            for( std::size_t i = 0; i < m_threadIds.size(); ++i )
+                if( m_isRegistered[i] && isSameThread( m_threadIds[i], current ) )
+                    return i;
+            return 0;
+        }
+
+        IResultCapture* m_prevResultCapture;
+        mutable Mutex m_mutex;
+        std::vector<ThreadId> m_threadIds;
+        std::vector<bool> m_isRegistered;
+    };
+
+} // end namespace Detail
+
+///////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+// Runs a body on a number of threads that are started together on a barrier,
+// either for a number of iterations on each thread or until a time is up.
+// Assertions from all of the threads are reported as usual, followed by how
+// many iterations each thread managed and how evenly the work was shared.
+// A REQUIRE that fails, or an exception, stops every thread. STRESS_TEST_CASE
+// runs a whole test case this way - within a SECTION, construct one with an
+// IRunnable whose run() is the body
+class StressTest : NonCopyable
+{
+    ///////////////////////////////////////////////////////////////////////////
+    class FunctionRunnable : public IRunnable
+    {
+    public:
+        ///////////////////////////////////////////////////////////////////////
+        explicit FunctionRunnable
+        (
+            void (*function)()
+        )
+        :   m_function( function )
+        {
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        virtual void run
+        ()
+        {
+            m_function();
+        }
+
+    private:
+        void (*m_function)();
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    class Worker : public IRunnable
+    {
+    public:
+        ///////////////////////////////////////////////////////////////////////
+        Worker
+        (
+            StressTest& stressTest,
+            std::size_t index_
+        )
+        :   index( index_ ),
+            iterations( 0 ),
+            microseconds( 0 ),
+            m_stressTest( stressTest )
+        {
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        virtual void run
+        ()
+        {
+            m_stressTest.runWorker( *this );
+        }
+
+        Thread thread;
+        std::size_t index;
+        std::size_t iterations;
+        uint64_t microseconds;
+
+    private:
+        StressTest& m_stressTest;
+    };
+
+public:
+    typedef void (*StressFunction)();
+
+    ///////////////////////////////////////////////////////////////////////////
+    StressTest
+    (
+        const char* filename,
+        std::size_t line,
+        std::size_t threads,
+        StressFunction function
+    )
+    :   m_filename( filename ),
+        m_line( line ),
+        m_function( function ),
+        m_body( &m_function ),
+        m_barrier( threads + 1 ),
+        m_iterations( 1000 ),
+        m_milliseconds( 0 ),
+        m_microseconds( 0 ),
+        m_stopping( false ),
+        m_requireFailed( false ),
+        m_capture( NULL )
+    {
+        createWorkers( threads );
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    StressTest
+    (
+        const char* filename,
+        std::size_t line,
+        std::size_t threads,
+        IRunnable& body
+    )
+    :   m_filename( filename ),
+        m_line( line ),
+        m_function( NULL ),
+        m_body( &body ),
+        m_barrier( threads + 1 ),
+        m_iterations( 1000 ),
+        m_milliseconds( 0 ),
+        m_microseconds( 0 ),
+        m_stopping( false ),
+        m_requireFailed( false ),
+        m_capture( NULL )
+    {
+        createWorkers( threads );
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    ~StressTest
+    ()
+    {
+        for( std::size_t i = 0; i < m_workers.size(); ++i )
+            delete m_workers[i];
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // The number of times each thread runs the body (1000 by default)
+    StressTest& forIterations
+    (
+        std::size_t iterations
+    )
+    {
+        m_iterations = iterations;
+        m_milliseconds = 0;
+        return *this;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Each thread runs the body over and over until the time is up
+    StressTest& forMilliseconds
+    (
+        unsigned int milliseconds
+    )
+    {
+        m_milliseconds = milliseconds;
+        return *this;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    void run
+    ()
+    {
+        std::size_t prevFailures = Hub::getRunner().getFailureCount();
+        std::size_t threadsStarted = 0;
+        {
+            Detail::StressResultCapture capture( m_workers.size() );
+            m_capture = &capture;
+            for( std::size_t i = 0; i < m_workers.size(); ++i )
+            {
+                if( m_workers[i]->thread.start( *m_workers[i] ) )
+                {
+                    ++threadsStarted;
+                }
+                else
+                {
+                    stop( false );
+                    m_barrier.arriveAndDrop();
+                }
+            }
+
+            // If this thread is cancelled (by the watchdog) the workers are
+            // stopped before the capture they report to goes away
+            try
+            {
+                m_barrier.wait();
+                Timer timer;
+                joinWorkers();
+                m_microseconds = timer.getElapsedMicroseconds();
+            }
+            catch( ... )
+            {
+                stop( false );
+                joinWorkers();
+                m_capture = NULL;
+                throw;
+            }
+            m_capture = NULL;
+        }
+
+        if( threadsStarted < m_workers.size() )
+        {
+            std::ostringstream oss;
+            oss << "Only " << threadsStarted << " of " << m_workers.size() << " thread(s) could be started";
+            accept( ResultWas::ExplicitFailure, oss.str() );
+        }
+        else
+        {
+            bool failed = Hub::getRunner().getFailureCount() != prevFailures;
+            accept( failed ? ResultWas::Warning : ResultWas::Ok, describeRun() );
+        }
+
+        if( m_requireFailed )
+            throw TestFailureException();
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    std::size_t getThreadCount
+    ()
+    const
+    {
+        return m_workers.size();
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // How many times the thread (from 0) completed the body
+    std::size_t getIterations
+    (
+        std::size_t thread
+    )
+    const
+    {
+        return m_workers[thread]->iterations;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    std::size_t getTotalIterations
+    ()
+    const
+    {
+        std::size_t total = 0;
+        for( std::size_t i = 0; i < m_workers.size(); ++i )
+            total += m_workers[i]->iterations;
+        return total;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Jain's fairness index of the threads' iterations per second: 1 when
+    // they all ran at the same rate, down to 1/threads when one did all of
+    // the work
+    double getFairness
+    ()
+    const
+    {
+        double sum = 0;
+        double sumOfSquares = 0;
+        for( std::size_t i = 0; i < m_workers.size(); ++i )
+        {
+            const Worker& worker = *m_workers[i];
+            double rate = worker.microseconds > 0
+                ? static_cast<double>( worker.iterations ) / worker.microseconds
+                : 0;
+            sum += rate;
+            sumOfSquares += rate * rate;
+        }
+        return sumOfSquares > 0 ? sum * sum / ( m_workers.size() * sumOfSquares ) : 1;
+    }
+
+private:
+
+    ///////////////////////////////////////////////////////////////////////////
+    void createWorkers
+    (
+        std::size_t threads
+    )
+    {
+        for( std::size_t i = 0; i < threads; ++i )
+            m_workers.push_back( new Worker( *this, i ) );
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    void joinWorkers
+    ()
+    {
+        for( std::size_t i = 0; i < m_workers.size(); ++i )
+            m_workers[i]->thread.join();
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Runs on each of the worker threads
+    void runWorker
+    (
+        Worker& worker
+    )
+    {
+        m_capture->registerThread( worker.index );
+        m_barrier.wait();
+
+        Timer timer;
+        try
+        {
+            while( !m_stopping && ( m_milliseconds > 0
+                    ? timer.getElapsedMilliseconds() < m_milliseconds
+                    : worker.iterations < m_iterations ) )
+            {
+                m_body->run();
+                ++worker.iterations;
+            }
+        }
+        catch( TestFailureException& )
+        {
+            // REQUIRE failed (or the run is aborting) - already reported
+            stop( true );
+        }
+        catch( ... )
+        {
+            Hub::getResultCapture().acceptExpression( ( ResultBuilder( m_filename.c_str(), m_line, "STRESS_TEST" )
+                << Hub::getExceptionTranslatorRegistry().translateActiveException() ).setResultType( ResultWas::ThrewException ) );
+            stop( false );
+        }
+        worker.microseconds = timer.getElapsedMicroseconds();
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    void stop
+    (
+        bool requireFailed
+    )
+    {
+        ScopedLock lock( m_mutex );
+        m_stopping = true;
+        if( requireFailed )
+            m_requireFailed = true;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    std::string describeRun
+    ()
+    const
+    {
+        std::size_t total = getTotalIterations();
+        std::ostringstream oss;
+        oss << m_workers.size() << " thread(s) ran " << total << " iteration(s) in "
+            << m_microseconds / 1000.0 << " ms";
+        if( m_microseconds > 0 )
+            oss << " (" << static_cast<uint64_t>( total * 1000000.0 / m_microseconds ) << " iterations/s)";
+        oss << "\niterations per thread: ";
+        for( std::size_t i = 0; i < m_workers.size(); ++i )
+            oss << ( i > 0 ? ", " : "" ) << m_workers[i]->iterations;
+        oss << "\nfairness: " << std::fixed << std::setprecision( 3 ) << getFairness();
+        return oss.str();
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    void accept
+    (
+        ResultWas::OfType resultType,
+        const std::string& message
+    )
+    const
+    {
+        Hub::getResultCapture().acceptExpression( ( ResultBuilder( m_filename.c_str(), m_line, "STRESS_TEST" ) << message ).setResultType( resultType ) );
+    }
+
+    std::string m_filename;
+    std::size_t m_line;
+    FunctionRunnable m_function;
+    IRunnable* m_body;
+    std::vector<Worker*> m_workers;
+    Barrier m_barrier;
+    std::size_t m_iterations;
+    unsigned int m_milliseconds;
+    uint64_t m_microseconds;
+
+    // Only written under m_mutex. The workers check m_stopping between
+    // iterations without it, so a stop is seen at most an iteration late
+    Mutex m_mutex;
+    volatile bool m_stopping;
+    volatile bool m_requireFailed;
+
+    Detail::StressResultCapture* m_capture;
+};
+
+} // end namespace Catch
+
+///////////////////////////////////////////////////////////////////////////////
+#define INTERNAL_CATCH_STRESS_TESTCASE( Name, Desc, Threads, Iterations ) \
+    static void INTERNAL_CATCH_UNIQUE_NAME( catch_internal_StressFunction )(); \
+    INTERNAL_CATCH_TESTCASE( Name, Desc ) \
+    { \
+        Catch::StressTest( __FILE__, __LINE__, Threads, &INTERNAL_CATCH_UNIQUE_NAME( catch_internal_StressFunction ) ).forIterations( Iterations ).run(); \
+    } \
+    static void INTERNAL_CATCH_UNIQUE_NAME( catch_internal_StressFunction )()
+
+///////////////////////////////////////////////////////////////////////////////
+#define INTERNAL_CATCH_STRESS_TESTCASE_FOR( Name, Desc, Threads, Seconds ) \
+    static void INTERNAL_CATCH_UNIQUE_NAME( catch_internal_StressFunction )(); \
+    INTERNAL_CATCH_TESTCASE( Name, Desc ) \
+    { \
+        Catch::StressTest( __FILE__, __LINE__, Threads, &INTERNAL_CATCH_UNIQUE_NAME( catch_internal_StressFunction ) ).forMilliseconds( static_cast<unsigned int>( (Seconds) * 1000.0 + 0.5 ) ).run(); \
+    } \
+    static void INTERNAL_CATCH_UNIQUE_NAME( catch_internal_StressFunction )()
+
+#endif // TWOBLUECUBES_CATCH_STRESS_HPP_INCLUDED
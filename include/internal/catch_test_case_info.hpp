@@ -29,20 +29,23 @@ namespace Catch
             const char* name, 
             const char* description,
             const char* filename,
-            std::size_t line
+            std::size_t line,
+            unsigned int timeout = 0
         )
         :   m_test( testCase ),
             m_name( name ),
             m_description( description ),
             m_filename( filename ),
-            m_line( line )
+            m_line( line ),
+            m_timeout( timeout )
         {
         }
 
         ///////////////////////////////////////////////////////////////////////
         TestCaseInfo
         ()
-        :   m_test( NULL )
+        :   m_test( NULL ),
+            m_timeout( 0 )
         {
         }
         
@@ -51,11 +54,12 @@ namespace Catch
         (
             const TestCaseInfo& other
         )
-        :   m_test( other.m_test->clone() ),
+        :   m_test( other.m_test ? other.m_test->clone() : NULL ),
             m_name( other.m_name ),
             m_description( other.m_description ),
             m_filename( other.m_filename ),
-            m_line( other.m_line )
+            m_line( other.m_line ),
+            m_timeout( other.m_timeout )
         {
         }
         
@@ -69,7 +73,8 @@ namespace Catch
             m_name( name ),
             m_description( other.m_description ),
             m_filename( other.m_filename ),
-            m_line( other.m_line )
+            m_line( other.m_line ),
+            m_timeout( other.m_timeout )
         {
         }
         
@@ -91,6 +96,14 @@ namespace Catch
             delete m_test;
         }
         
+        ///////////////////////////////////////////////////////////////////////
+        void start
+        ()
+        const
+        {
+            m_test->start();
+        }
+
         ///////////////////////////////////////////////////////////////////////
         void invoke
         ()
@@ -131,6 +144,15 @@ namespace Catch
             return m_line;
         }
         
+        ///////////////////////////////////////////////////////////////////////
+        // In milliseconds. 0 if the test case has no timeout of its own
+        unsigned int getTimeout
+        ()
+        const
+        {
+            return m_timeout;
+        }
+
         ///////////////////////////////////////////////////////////////////////
         bool isHidden
         ()
@@ -148,6 +170,9 @@ namespace Catch
             std::swap( m_test, other.m_test );
             m_name.swap( other.m_name );
             m_description.swap( other.m_description );
+            m_filename.swap( other.m_filename );
+            std::swap( m_line, other.m_line );
+            std::swap( m_timeout, other.m_timeout );
         }
         
         ///////////////////////////////////////////////////////////////////////
@@ -181,6 +206,7 @@ namespace Catch
         std::string m_description;
         std::string m_filename;
         std::size_t m_line;
+        unsigned int m_timeout;
         
     };
     
@@ -10,9 +10,13 @@
  *
  */
 
+#include "catch_allocation_counter.hpp"
 #include "catch_test_registry.hpp"
 #include "catch_test_case_info.hpp"
 #include "catch_hub.h"
+#include "catch_threading.hpp"
+#include "catch_timer.hpp"
+#include "catch_watchdog.hpp"
 
 #include <vector>
 #include <set>
@@ -26,6 +30,9 @@
 #else
 	#include <signal.h>
 	#include <pthread.h>	// MUST LINK -lpthread
+	#ifdef __GLIBC__
+		#include <cxxabi.h>
+	#endif
 #endif
 
 #include <iostream> // !TBD DBG
@@ -36,6 +43,7 @@ namespace Catch
 	DWORD WINAPI RunTestInThread(LPVOID lpParam);
 	#else
 	void * RunTestInThread(void *lpParam);
+	void * RunWatchedTestInThread(void *lpParam);
 	#endif
 
 	class TestRegistry : public ITestCaseRegistry
@@ -106,6 +114,111 @@ namespace Catch
 
     ///////////////////////////////////////////////////////////////////////////
     ///////////////////////////////////////////////////////////////////////////
+
+    // What a test's thread shares with the thread watching it. Either may
+    // finish with it first - the test's thread may be left running after a
+    // timeout - so it is deleted when both have released it
+    class WatchedTest : NonCopyable
+    {
+    public:
+        ///////////////////////////////////////////////////////////////////////
+        // The result stays crashed unless the test's thread returns one
+        WatchedTest
+        (
+            TestFunction fun,
+            unsigned int crashed
+        )
+        :   m_fun( fun ),
+            m_result( crashed ),
+            m_finished( false ),
+            m_references( 2 )
+        {
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        TestFunction getFunction
+        ()
+        const
+        {
+            return m_fun;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        unsigned int getResult
+        ()
+        {
+            ScopedLock lock( m_mutex );
+            return m_result;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        void setResult
+        (
+            unsigned int result
+        )
+        {
+            ScopedLock lock( m_mutex );
+            m_result = result;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        void finish
+        ()
+        {
+            ScopedLock lock( m_mutex );
+            m_finished = true;
+            m_condition.notifyAll();
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // Returns false if the time ran out first. A timeout of 0 waits for
+        // as long as it takes
+        bool waitUntilFinished
+        (
+            unsigned int timeout
+        )
+        {
+            uint64_t deadline = getCurrentMicroseconds() + static_cast<uint64_t>( timeout ) * 1000;
+            ScopedLock lock( m_mutex );
+            while( !m_finished )
+            {
+                if( timeout == 0 )
+                {
+                    m_condition.wait( m_mutex );
+                    continue;
+                }
+                uint64_t now = getCurrentMicroseconds();
+                if( now >= deadline )
+                    return false;
+                m_condition.waitFor( m_mutex, static_cast<unsigned int>( ( deadline - now + 999 ) / 1000 ) );
+            }
+            return true;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        void release
+        ()
+        {
+            bool isLast = false;
+            {
+                ScopedLock lock( m_mutex );
+                isLast = --m_references == 0;
+            }
+            if( isLast )
+                delete this;
+        }
+
+    private:
+        TestFunction m_fun;
+        unsigned int m_result;
+        bool m_finished;
+        int m_references;
+        Mutex m_mutex;
+        ConditionVariable m_condition;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
     
     
     struct FreeFunctionTestCase : ITestCase
@@ -128,26 +241,62 @@ namespace Catch
 				DWORD  result   = 0;
 				DWORD  threadId = 0;
 				HANDLE worker   = CreateThread(NULL,0,RunTestInThread,m_fun,0,&threadId);
+				unsigned int timeout = Watchdog::getTimeout();
 			
-				if(WaitForMultipleObjects(1,&worker,TRUE,INFINITE) == WAIT_OBJECT_0)
+				DWORD waited = WaitForMultipleObjects(1,&worker,TRUE,timeout ? timeout : INFINITE);
+				if(waited == WAIT_OBJECT_0)
 				{
 					GetExitCodeThread(worker,&result);
 				}
+				else if(waited == WAIT_TIMEOUT)
+				{
+					// Nothing short of terminating the thread stops it. What it
+					// had locked stays locked, but it no longer runs
+					std::string backtrace = Watchdog::getBacktrace(worker);
+					bool stopped =	TerminateThread(worker,FreeFunctionTestCase::CRASH) != FALSE &&
+									WaitForSingleObject(worker,Watchdog::CancelGraceMilliseconds) == WAIT_OBJECT_0;
+					CloseHandle(worker);
+					throw TestTimedOut(timeout,stopped,backtrace);
+				}
 				else
 				{
 					result = FreeFunctionTestCase::EXCEPTION;
 				}			
+				CloseHandle(worker);
 			#else
-				// Invoke the test case in a worker thread for crash tolerance
+				// Invoke the test case in a worker thread for crash tolerance,
+				// and so it can be watched for hanging
 				pthread_t worker;
-				void *    retVal;
-				pthread_create( &worker, NULL, RunTestInThread, (void*)m_fun );
-				pthread_join( worker, &retVal);
-				unsigned int result = *((unsigned int*)retVal);			
+				unsigned int timeout = Watchdog::getTimeout();
+				WatchedTest* watched = new WatchedTest( m_fun, FreeFunctionTestCase::CRASH );
+				if( pthread_create( &worker, NULL, RunWatchedTestInThread, watched ) != 0 )
+				{
+					delete watched;
+					throw "Test case could not be started on a thread of its own.";
+				}
+				if( !watched->waitUntilFinished( timeout ) )
+				{
+					std::string backtrace = Watchdog::getBacktrace( worker );
+					pthread_cancel( worker );
+					bool stopped = watched->waitUntilFinished( Watchdog::CancelGraceMilliseconds );
+					if( stopped )
+						pthread_join( worker, NULL );
+					else
+						pthread_detach( worker );
+					watched->release();
+					throw TestTimedOut( timeout, stopped, backtrace );
+				}
+				pthread_join( worker, NULL );
+				unsigned int result = watched->getResult();
+				watched->release();
 			#endif
 
 			switch(result)
 			{
+			case FreeFunctionTestCase::FAILED:
+				// A REQUIRE failed (or the run is aborting), so the test case
+				// didn't run to completion - its sections may need another run
+				throw TestFailureException();
 			case FreeFunctionTestCase::EXCEPTION:
 				throw "Test case aborted due to unhandled exception.";
 				break;
@@ -192,6 +341,7 @@ namespace Catch
 		static const unsigned int SUCCESS	= 0U;
 		static const unsigned int EXCEPTION = 1U;
 		static const unsigned int CRASH		= 2U;
+		static const unsigned int FAILED	= 3U;
     private:
         TestFunction m_fun;		
     };
@@ -232,8 +382,15 @@ namespace Catch
 		signal(SIGABRT,SignalHandler);
 		try
 		{
+			AllocationCounter::CountingThread countingThread;
 			((Catch::TestFunction)lpParam)();
 		}
+		catch(TestFailureException&)
+		{
+			// The failure has been reported already - invoke() passes the
+			// abort on to the runner
+			error = FreeFunctionTestCase::FAILED;
+		}
 		catch(...)
 		{
 			// NOTE: CHECK_THROWS, REQUIRE_THROWS, etc. will still work.  This just consumes SEH crashes, 
@@ -260,8 +417,22 @@ namespace Catch
 		signal(SIGABRT,SignalHandler);
 		try
 		{
+			AllocationCounter::CountingThread countingThread;
 			((Catch::TestFunction)lpParam)();
 		}
+		catch(TestFailureException&)
+		{
+			// The failure has been reported already - invoke() passes the
+			// abort on to the runner
+			error = const_cast<unsigned int *>(&FreeFunctionTestCase::FAILED);
+		}
+		#ifdef __GLIBC__
+		catch(abi::__forced_unwind&)
+		{
+			// The thread is being cancelled (or exited) - which must not be stopped
+			throw;
+		}
+		#endif
 		catch(...)
 		{
 			// NOTE: CHECK_THROWS, REQUIRE_THROWS, etc. will still work.  This just consumes SEH crashes, 
@@ -276,11 +447,32 @@ namespace Catch
 		signal(SIGABRT,SIG_DFL);
 		return error;
 	}
+
+	void FinishWatchedTest(void *lpParam)
+	{
+		WatchedTest* watched = static_cast<WatchedTest*>(lpParam);
+		watched->finish();
+		watched->release();
+	}
+
+	// The cleanup handler runs however the thread ends - returning, being
+	// cancelled by the watchdog or exiting from SignalHandler
+	void * RunWatchedTestInThread(void *lpParam)
+	{
+		WatchedTest* watched = static_cast<WatchedTest*>(lpParam);
+		void * retVal = NULL;
+		pthread_cleanup_push(FinishWatchedTest, watched);
+		retVal = RunTestInThread((void*)watched->getFunction());
+		watched->setResult(*((unsigned int*)retVal));
+		pthread_cleanup_pop(1);
+		return retVal;
+	}
 	#endif
 	
 	const unsigned int FreeFunctionTestCase::SUCCESS;
 	const unsigned int FreeFunctionTestCase::EXCEPTION;
 	const unsigned int FreeFunctionTestCase::CRASH;
+	const unsigned int FreeFunctionTestCase::FAILED;
         
     ///////////////////////////////////////////////////////////////////////////
     ///////////////////////////////////////////////////////////////////////////
@@ -292,10 +484,11 @@ namespace Catch
         const char* name,
         const char* description,
         const char* filename,
-        std::size_t line
+        std::size_t line,
+        unsigned int timeout
     )
     {
-        registerTestCase( new FreeFunctionTestCase( function ), name, description, filename, line );
+        registerTestCase( new FreeFunctionTestCase( function ), name, description, filename, line, timeout );
     }    
     
     ///////////////////////////////////////////////////////////////////////////
@@ -311,10 +504,11 @@ namespace Catch
         const char* name, 
         const char* description,
         const char* filename,
-        std::size_t line
+        std::size_t line,
+        unsigned int timeout
     )
     {
-        Hub::getTestCaseRegistry().registerTest( TestCaseInfo( testCase, name, description, filename, line ) );
+        Hub::getTestCaseRegistry().registerTest( TestCaseInfo( testCase, name, description, filename, line, timeout ) );
     }
     
 } // end namespace Catch
@@ -13,12 +13,15 @@
 #define TWOBLUECUBES_CATCH_REGISTRY_HPP_INCLUDED
 
 #include "catch_common.h"
+#include "catch_fixture_pool.hpp"
 #include "catch_interfaces_testcase.h"
 
 namespace Catch
 {
     
-template<typename C>
+// Fixture is the class whose reset() decides if the fixture is pooled -
+// for TEST_CASE_METHOD, the class its test method's class derives from
+template<typename C, typename Fixture = C>
 struct MethodTestCase : ITestCase
 {
     ///////////////////////////////////////////////////////////////////////////
@@ -30,12 +33,13 @@ struct MethodTestCase : ITestCase
     {}
     
     ///////////////////////////////////////////////////////////////////////////
+    // A fixture class that declares a reset() is constructed once, and
+    // reset between invocations, rather than constructed for every one
     virtual void invoke
     ()
     const
     {
-        C obj;
-        (obj.*m_method)();
+        FixturePool<C, HasReset<Fixture>::value>::invoke( m_method );
     }
     
     ///////////////////////////////////////////////////////////////////////////
@@ -43,7 +47,7 @@ struct MethodTestCase : ITestCase
     ()
     const
     {
-        return new MethodTestCase<C>( m_method );
+        return new MethodTestCase( m_method );
     }
 
     ///////////////////////////////////////////////////////////////////////////
@@ -76,14 +80,30 @@ typedef void(*TestFunction)();
     
 struct AutoReg
 {
+    // A timeout (in milliseconds) overrides the one on the command line
     AutoReg
         (   TestFunction function, 
             const char* name, 
             const char* description,
             const char* filename,
-            std::size_t line
+            std::size_t line,
+            unsigned int timeout = 0
         );
     
+    ///////////////////////////////////////////////////////////////////////////
+    // For test cases of other kinds, such as asynchronous ones
+    AutoReg
+    (
+        ITestCase* testCase,
+        const char* name,
+        const char* description,
+        const char* filename,
+        std::size_t line
+    )
+    {
+        registerTestCase( testCase, name, description, filename, line );
+    }
+
     ///////////////////////////////////////////////////////////////////////////
     template<typename C>
     AutoReg
@@ -97,6 +117,22 @@ struct AutoReg
     {
         registerTestCase( new MethodTestCase<C>( method ), name, description, filename, line );
     }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // For TEST_CASE_METHOD - the fixture is only there for its type
+    template<typename C, typename Fixture>
+    AutoReg
+    (
+        void (C::*method)(),
+        const Fixture*,
+        const char* name,
+        const char* description,
+        const char* filename,
+        std::size_t line
+    )
+    {
+        registerTestCase( new MethodTestCase<C, Fixture>( method ), name, description, filename, line );
+    }
     
     ///////////////////////////////////////////////////////////////////////////
     void registerTestCase
@@ -105,7 +141,8 @@ struct AutoReg
         const char* name, 
         const char* description,
         const char* filename,
-        std::size_t line
+        std::size_t line,
+        unsigned int timeout = 0
     );
     
     ~AutoReg
@@ -127,6 +164,12 @@ private:
     namespace{ Catch::AutoReg INTERNAL_CATCH_UNIQUE_NAME( autoRegistrar )( &INTERNAL_CATCH_UNIQUE_NAME(  catch_internal_TestFunction ), Name, Desc, __FILE__, __LINE__ ); }\
     static void INTERNAL_CATCH_UNIQUE_NAME(  catch_internal_TestFunction )()
 
+///////////////////////////////////////////////////////////////////////////////
+#define INTERNAL_CATCH_TESTCASE_TIMEOUT( Name, Desc, Seconds ) \
+    static void INTERNAL_CATCH_UNIQUE_NAME( catch_internal_TestFunction )(); \
+    namespace{ Catch::AutoReg INTERNAL_CATCH_UNIQUE_NAME( autoRegistrar )( &INTERNAL_CATCH_UNIQUE_NAME(  catch_internal_TestFunction ), Name, Desc, __FILE__, __LINE__, static_cast<unsigned int>( (Seconds) * 1000.0 + 0.5 ) ); }\
+    static void INTERNAL_CATCH_UNIQUE_NAME(  catch_internal_TestFunction )()
+
 ///////////////////////////////////////////////////////////////////////////////
 #define INTERNAL_CATCH_TESTCASE_NORETURN( Name, Desc ) \
     static void INTERNAL_CATCH_UNIQUE_NAME( catch_internal_TestFunction )() ATTRIBUTE_NORETURN; \
@@ -143,7 +186,7 @@ private:
     { \
         void test(); \
     }; \
-    namespace{ Catch::AutoReg INTERNAL_CATCH_UNIQUE_NAME( autoRegistrar ) ( &INTERNAL_CATCH_UNIQUE_NAME( Catch_FixtureWrapper )::test, TestName, Desc, __FILE__, __LINE__ ); } \
+    namespace{ Catch::AutoReg INTERNAL_CATCH_UNIQUE_NAME( autoRegistrar ) ( &INTERNAL_CATCH_UNIQUE_NAME( Catch_FixtureWrapper )::test, static_cast<const ClassName*>( NULL ), TestName, Desc, __FILE__, __LINE__ ); } \
     void INTERNAL_CATCH_UNIQUE_NAME( Catch_FixtureWrapper )::test()
 
 #endif // TWOBLUECUBES_CATCH_REGISTRY_HPP_INCLUDED
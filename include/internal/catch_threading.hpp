@@ -0,0 +1,475 @@
+/*
+ *  catch_threading.hpp
+ *  Catch
+ *
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * Minimal wrappers over the platform threading primitives
+ */
+
+#ifndef TWOBLUECUBES_CATCH_THREADING_HPP_INCLUDED
+#define TWOBLUECUBES_CATCH_THREADING_HPP_INCLUDED
+
+#include "catch_common.h"
+#include "catch_debugger.hpp"
+
+#ifdef CATCH_PLATFORM_WINDOWS
+    #include "Windows.h"
+#else
+    #include <pthread.h>    // MUST LINK -lpthread
+    #include <errno.h>
+    #include <sched.h>
+    #include <sys/time.h>
+    #include <time.h>
+#endif
+
+namespace Catch
+{
+    class Mutex : NonCopyable
+    {
+        friend class ConditionVariable;
+
+    public:
+        ///////////////////////////////////////////////////////////////////////
+        Mutex
+        ()
+        {
+#ifdef CATCH_PLATFORM_WINDOWS
+            InitializeCriticalSection( &m_mutex );
+#else
+            pthread_mutex_init( &m_mutex, NULL );
+#endif
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        ~Mutex
+        ()
+        {
+#ifdef CATCH_PLATFORM_WINDOWS
+            DeleteCriticalSection( &m_mutex );
+#else
+            pthread_mutex_destroy( &m_mutex );
+#endif
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        void lock
+        ()
+        {
+#ifdef CATCH_PLATFORM_WINDOWS
+            EnterCriticalSection( &m_mutex );
+#else
+            pthread_mutex_lock( &m_mutex );
+#endif
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        bool tryLock
+        ()
+        {
+#ifdef CATCH_PLATFORM_WINDOWS
+            return TryEnterCriticalSection( &m_mutex ) != 0;
+#else
+            return pthread_mutex_trylock( &m_mutex ) == 0;
+#endif
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        void unlock
+        ()
+        {
+#ifdef CATCH_PLATFORM_WINDOWS
+            LeaveCriticalSection( &m_mutex );
+#else
+            pthread_mutex_unlock( &m_mutex );
+#endif
+        }
+
+    private:
+#ifdef CATCH_PLATFORM_WINDOWS
+        CRITICAL_SECTION m_mutex;
+#else
+        pthread_mutex_t m_mutex;
+#endif
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    class ScopedLock : NonCopyable
+    {
+    public:
+        ///////////////////////////////////////////////////////////////////////
+        explicit ScopedLock
+        (
+            Mutex& mutex
+        )
+        :   m_mutex( mutex )
+        {
+            m_mutex.lock();
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        ~ScopedLock
+        ()
+        {
+            m_mutex.unlock();
+        }
+
+    private:
+        Mutex& m_mutex;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // A lock that is unlocked when zero initialised and never allocates, so
+    // it can be used from operator new and operator delete. It spins, so it
+    // is only for locks held briefly
+    class SpinLock
+    {
+    public:
+        ///////////////////////////////////////////////////////////////////////
+        void lock
+        ()
+        {
+#ifdef CATCH_PLATFORM_WINDOWS
+            while( InterlockedExchange( &m_locked, 1 ) != 0 )
+                SwitchToThread();
+#else
+            while( __sync_lock_test_and_set( &m_locked, 1 ) != 0 )
+                sched_yield();
+#endif
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        void unlock
+        ()
+        {
+#ifdef CATCH_PLATFORM_WINDOWS
+            InterlockedExchange( &m_locked, 0 );
+#else
+            __sync_lock_release( &m_locked );
+#endif
+        }
+
+    private:
+#ifdef CATCH_PLATFORM_WINDOWS
+        volatile LONG m_locked;
+#else
+        volatile long m_locked;
+#endif
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    class ScopedSpinLock : NonCopyable
+    {
+    public:
+        ///////////////////////////////////////////////////////////////////////
+        explicit ScopedSpinLock
+        (
+            SpinLock& lock
+        )
+        :   m_lock( lock )
+        {
+            m_lock.lock();
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        ~ScopedSpinLock
+        ()
+        {
+            m_lock.unlock();
+        }
+
+    private:
+        SpinLock& m_lock;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    class ConditionVariable : NonCopyable
+    {
+    public:
+        ///////////////////////////////////////////////////////////////////////
+        ConditionVariable
+        ()
+        {
+#ifdef CATCH_PLATFORM_WINDOWS
+            InitializeConditionVariable( &m_condition );
+#else
+            pthread_cond_init( &m_condition, NULL );
+#endif
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        ~ConditionVariable
+        ()
+        {
+#ifndef CATCH_PLATFORM_WINDOWS
+            pthread_cond_destroy( &m_condition );
+#endif
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // mutex must be locked. As always, callers should wait in a loop
+        void wait
+        (
+            Mutex& mutex
+        )
+        {
+#ifdef CATCH_PLATFORM_WINDOWS
+            SleepConditionVariableCS( &m_condition, &mutex.m_mutex, INFINITE );
+#else
+            pthread_cond_wait( &m_condition, &mutex.m_mutex );
+#endif
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // Returns false if the time ran out
+        bool waitFor
+        (
+            Mutex& mutex,
+            unsigned int milliseconds
+        )
+        {
+#ifdef CATCH_PLATFORM_WINDOWS
+            return SleepConditionVariableCS( &m_condition, &mutex.m_mutex, milliseconds ) != 0;
+#else
+            timeval now;
+            gettimeofday( &now, NULL );
+            long microseconds = now.tv_usec + static_cast<long>( milliseconds % 1000 ) * 1000;
+            timespec deadline;
+            deadline.tv_sec = now.tv_sec + static_cast<time_t>( milliseconds / 1000 + microseconds / 1000000 );
+            deadline.tv_nsec = ( microseconds % 1000000 ) * 1000;
+            return pthread_cond_timedwait( &m_condition, &mutex.m_mutex, &deadline ) != ETIMEDOUT;
+#endif
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        void notifyAll
+        ()
+        {
+#ifdef CATCH_PLATFORM_WINDOWS
+            WakeAllConditionVariable( &m_condition );
+#else
+            pthread_cond_broadcast( &m_condition );
+#endif
+        }
+
+    private:
+#ifdef CATCH_PLATFORM_WINDOWS
+        CONDITION_VARIABLE m_condition;
+#else
+        pthread_cond_t m_condition;
+#endif
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Holds each thread that waits on it until all of the parties have, then
+    // lets them all go together. It can then be used again
+    class Barrier : NonCopyable
+    {
+    public:
+        ///////////////////////////////////////////////////////////////////////
+        explicit Barrier
+        (
+            std::size_t parties
+        )
+        :   m_parties( parties ),
+            m_waiting( 0 ),
+            m_generation( 0 )
+        {
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        void wait
+        ()
+        {
+            ScopedLock lock( m_mutex );
+            std::size_t generation = m_generation;
+            if( ++m_waiting >= m_parties )
+                release();
+            else
+                while( generation == m_generation )
+                    m_released.wait( m_mutex );
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // For a party that won't be coming (such as a thread that couldn't be
+        // started), so the others aren't left waiting for it
+        void arriveAndDrop
+        ()
+        {
+            ScopedLock lock( m_mutex );
+            if( m_parties > 0 && --m_parties > 0 && m_waiting >= m_parties )
+                release();
+        }
+
+    private:
+        ///////////////////////////////////////////////////////////////////////
+        void release
+        ()
+        {
+            m_waiting = 0;
+            ++m_generation;
+            m_released.notifyAll();
+        }
+
+        Mutex m_mutex;
+        ConditionVariable m_released;
+        std::size_t m_parties;
+        std::size_t m_waiting;
+        std::size_t m_generation;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    struct IRunnable
+    {
+        virtual ~IRunnable
+        ()
+        {}
+
+        virtual void run
+            () = 0;
+    };
+
+    // Runs an IRunnable on its own thread. The thread must be joined before
+    // the Thread (or the IRunnable) is destroyed
+    class Thread : NonCopyable
+    {
+    public:
+        ///////////////////////////////////////////////////////////////////////
+        Thread
+        ()
+        :   m_started( false )
+        {
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        bool start
+        (
+            IRunnable& runnable
+        )
+        {
+#ifdef CATCH_PLATFORM_WINDOWS
+            m_thread = CreateThread( NULL, 0, threadProc, &runnable, 0, NULL );
+            m_started = m_thread != NULL;
+#else
+            m_started = pthread_create( &m_thread, NULL, threadProc, &runnable ) == 0;
+#endif
+            return m_started;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        void join
+        ()
+        {
+            if( !m_started )
+                return;
+#ifdef CATCH_PLATFORM_WINDOWS
+            WaitForSingleObject( m_thread, INFINITE );
+            CloseHandle( m_thread );
+#else
+            pthread_join( m_thread, NULL );
+#endif
+            m_started = false;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        bool isStarted
+        ()
+        const
+        {
+            return m_started;
+        }
+
+    private:
+#ifdef CATCH_PLATFORM_WINDOWS
+        ///////////////////////////////////////////////////////////////////////
+        static DWORD WINAPI threadProc
+        (
+            LPVOID runnable
+        )
+        {
+            static_cast<IRunnable*>( runnable )->run();
+            return 0;
+        }
+
+        HANDLE m_thread;
+#else
+        ///////////////////////////////////////////////////////////////////////
+        static void* threadProc
+        (
+            void* runnable
+        )
+        {
+            static_cast<IRunnable*>( runnable )->run();
+            return NULL;
+        }
+
+        pthread_t m_thread;
+#endif
+        bool m_started;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+#ifdef CATCH_PLATFORM_WINDOWS
+    typedef DWORD ThreadId;
+#else
+    typedef pthread_t ThreadId;
+#endif
+
+    ///////////////////////////////////////////////////////////////////////////
+    inline ThreadId getCurrentThreadId
+    ()
+    {
+#ifdef CATCH_PLATFORM_WINDOWS
+        return GetCurrentThreadId();
+#else
+        return pthread_self();
+#endif
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    inline bool isSameThread
+    (
+        ThreadId first,
+        ThreadId second
+    )
+    {
+#ifdef CATCH_PLATFORM_WINDOWS
+        return first == second;
+#else
+        return pthread_equal( first, second ) != 0;
+#endif
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    inline void sleepFor
+    (
+        unsigned int milliseconds
+    )
+    {
+#ifdef CATCH_PLATFORM_WINDOWS
+        Sleep( milliseconds );
+#else
+        timespec duration;
+        duration.tv_sec = static_cast<time_t>( milliseconds / 1000 );
+        duration.tv_nsec = static_cast<long>( milliseconds % 1000 ) * 1000000;
+        while( nanosleep( &duration, &duration ) != 0 && errno == EINTR )
+            ;
+#endif
+    }
+
+} // end namespace Catch
+
+#endif // TWOBLUECUBES_CATCH_THREADING_HPP_INCLUDED
@@ -0,0 +1,98 @@
+/*
+ *  catch_timer.hpp
+ *  Catch
+ *
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ *
+ */
+
+#ifndef TWOBLUECUBES_CATCH_TIMER_HPP_INCLUDED
+#define TWOBLUECUBES_CATCH_TIMER_HPP_INCLUDED
+
+#include "catch_debugger.hpp"
+
+#include <stdint.h>
+
+#ifdef CATCH_PLATFORM_WINDOWS
+    #include "Windows.h"
+#else
+    #include <sys/time.h>
+#endif
+
+namespace Catch
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Microseconds from an arbitrary (but fixed) point in time
+    inline uint64_t getCurrentMicroseconds
+    ()
+    {
+#ifdef CATCH_PLATFORM_WINDOWS
+        static uint64_t ticksPerSecond = 0;
+        if( ticksPerSecond == 0 )
+        {
+            LARGE_INTEGER frequency;
+            QueryPerformanceFrequency( &frequency );
+            ticksPerSecond = static_cast<uint64_t>( frequency.QuadPart );
+        }
+        LARGE_INTEGER ticks;
+        QueryPerformanceCounter( &ticks );
+        return static_cast<uint64_t>( ticks.QuadPart ) * 1000000 / ticksPerSecond;
+#else
+        timeval now;
+        gettimeofday( &now, NULL );
+        return static_cast<uint64_t>( now.tv_sec ) * 1000000 + static_cast<uint64_t>( now.tv_usec );
+#endif
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    class Timer
+    {
+    public:
+        ///////////////////////////////////////////////////////////////////////
+        Timer
+        ()
+        :   m_start( getCurrentMicroseconds() )
+        {
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        void restart
+        ()
+        {
+            m_start = getCurrentMicroseconds();
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        uint64_t getElapsedMicroseconds
+        ()
+        const
+        {
+            return getCurrentMicroseconds() - m_start;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        unsigned int getElapsedMilliseconds
+        ()
+        const
+        {
+            return static_cast<unsigned int>( getElapsedMicroseconds() / 1000 );
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        double getElapsedSeconds
+        ()
+        const
+        {
+            return static_cast<double>( getElapsedMicroseconds() ) / 1000000.0;
+        }
+
+    private:
+        uint64_t m_start;
+    };
+
+} // end namespace Catch
+
+#endif // TWOBLUECUBES_CATCH_TIMER_HPP_INCLUDED
@@ -0,0 +1,314 @@
+/*
+ *  catch_watchdog.hpp
+ *  Catch
+ *
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * Timeouts for tests that hang, and the backtraces of the threads they hang on
+ */
+
+#ifndef TWOBLUECUBES_CATCH_WATCHDOG_HPP_INCLUDED
+#define TWOBLUECUBES_CATCH_WATCHDOG_HPP_INCLUDED
+
+#include "catch_threading.hpp"
+
+#include <signal.h>
+#include <sstream>
+#include <string>
+
+#if !defined( CATCH_PLATFORM_WINDOWS ) && ( defined( __GLIBC__ ) || defined( CATCH_PLATFORM_MAC ) )
+    #define CATCH_WATCHDOG_HAS_BACKTRACE
+    #include <execinfo.h>
+    #include <stdlib.h>
+#elif defined( _MSC_VER )
+    #include <dbghelp.h>
+    #pragma comment( lib, "dbghelp.lib" )
+#endif
+
+namespace Catch
+{
+    // Thrown, on the thread that started the test, when a test is still
+    // running after its timeout
+    class TestTimedOut
+    {
+    public:
+        ///////////////////////////////////////////////////////////////////////
+        TestTimedOut
+        (
+            unsigned int timeout,
+            bool stopped,
+            const std::string& backtrace
+        )
+        :   m_stopped( stopped )
+        {
+            std::ostringstream oss;
+            oss << "Test case timed out after " << formatTimeout( timeout );
+            if( !stopped )
+                oss << " - its thread couldn't be stopped, so no more tests are run in this process";
+            if( !backtrace.empty() )
+                oss << "\nBacktrace of the test's thread:\n" << backtrace;
+            m_message = oss.str();
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        const std::string& getMessage
+        ()
+        const
+        {
+            return m_message;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // False if the test's thread is still running
+        bool wasStopped
+        ()
+        const
+        {
+            return m_stopped;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        static std::string formatTimeout
+        (
+            unsigned int milliseconds
+        )
+        {
+            std::ostringstream oss;
+            oss << milliseconds / 1000.0 << " s";
+            return oss.str();
+        }
+
+    private:
+        std::string m_message;
+        bool m_stopped;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // The timeout for whichever test is running, in milliseconds (0 for
+    // none). Tests that run on a thread of their own (see
+    // FreeFunctionTestCase) are watched by the thread that started them. If
+    // one outlives its timeout it is cancelled, which stops it at the next
+    // blocking call it makes (on Windows it is terminated). A thread that
+    // won't stop (such as one spinning, or waiting on a mutex) can't be left
+    // to run alongside the tests that follow, so the runner runs no more -
+    // worker processes are the way to carry on past those
+    class Watchdog
+    {
+        enum { MaxFrames = 64 };
+
+        struct State
+        {
+            unsigned int timeout;
+            volatile sig_atomic_t framesCaptured;
+            int frameCount;
+            void* frames[MaxFrames];
+        };
+
+    public:
+        // How long a cancelled thread is given to finish
+        enum { CancelGraceMilliseconds = 1000 };
+
+        ///////////////////////////////////////////////////////////////////////
+        // Sets the timeout while the runner is running a test
+        class Scope : NonCopyable
+        {
+        public:
+            ///////////////////////////////////////////////////////////////////
+            explicit Scope
+            (
+                unsigned int timeout
+            )
+            :   m_previous( state().timeout )
+            {
+                state().timeout = timeout;
+            }
+
+            ///////////////////////////////////////////////////////////////////
+            ~Scope
+            ()
+            {
+                state().timeout = m_previous;
+            }
+
+        private:
+            unsigned int m_previous;
+        };
+
+        ///////////////////////////////////////////////////////////////////////
+        static unsigned int getTimeout
+        ()
+        {
+            return state().timeout;
+        }
+
+#ifdef CATCH_WATCHDOG_HAS_BACKTRACE
+
+        ///////////////////////////////////////////////////////////////////////
+        // Interrupts the thread with SIGUSR2 to have it record its own stack.
+        // Empty if the thread doesn't respond (such as when it has blocked
+        // the signal)
+        static std::string getBacktrace
+        (
+            pthread_t thread
+        )
+        {
+            State& s = state();
+            static Mutex mutex;
+            ScopedLock lock( mutex );
+
+            // backtrace() loads what it needs the first time it is called,
+            // which mustn't happen in the signal handler
+            void* frame;
+            backtrace( &frame, 1 );
+
+            struct sigaction action;
+            struct sigaction previous;
+            action.sa_handler = captureFrames;
+            action.sa_flags = 0;
+            sigemptyset( &action.sa_mask );
+            s.framesCaptured = 0;
+            if( sigaction( SIGUSR2, &action, &previous ) != 0 )
+                return "";
+            if( pthread_kill( thread, SIGUSR2 ) == 0 )
+                for( int waited = 0; !s.framesCaptured && waited < 1000; waited += 10 )
+                    sleepFor( 10 );
+            sigaction( SIGUSR2, &previous, NULL );
+            if( !s.framesCaptured )
+                return "";
+
+            // The first two frames are the handler and the signal trampoline
+            std::ostringstream oss;
+            int skipped = s.frameCount > 2 ? 2 : 0;
+            if( char** symbols = backtrace_symbols( s.frames + skipped, s.frameCount - skipped ) )
+            {
+                for( int i = 0; i < s.frameCount - skipped; ++i )
+                    oss << "  " << symbols[i] << "\n";
+                free( symbols );
+            }
+            return oss.str();
+        }
+
+#elif defined( _MSC_VER )
+
+        ///////////////////////////////////////////////////////////////////////
+        // Suspends the thread to walk its stack, then names the frames once
+        // it has been resumed. Empty if the thread can't be suspended, or
+        // its stack can't be walked
+        static std::string getBacktrace
+        (
+            HANDLE thread
+        )
+        {
+            // dbghelp isn't thread safe
+            static Mutex mutex;
+            ScopedLock lock( mutex );
+
+            HANDLE process = GetCurrentProcess();
+            static bool symbolsLoaded = false;
+            if( !symbolsLoaded )
+            {
+                SymSetOptions( SYMOPT_UNDNAME | SYMOPT_DEFERRED_LOADS );
+                symbolsLoaded = SymInitialize( process, NULL, TRUE ) != FALSE;
+                if( !symbolsLoaded )
+                    return "";
+            }
+
+            DWORD64 frames[MaxFrames];
+            int frameCount = 0;
+            if( SuspendThread( thread ) == static_cast<DWORD>( -1 ) )
+                return "";
+            CONTEXT context;
+            ZeroMemory( &context, sizeof( context ) );
+            context.ContextFlags = CONTEXT_FULL;
+            if( GetThreadContext( thread, &context ) )
+            {
+                STACKFRAME64 frame;
+                ZeroMemory( &frame, sizeof( frame ) );
+                frame.AddrPC.Mode = AddrModeFlat;
+                frame.AddrFrame.Mode = AddrModeFlat;
+                frame.AddrStack.Mode = AddrModeFlat;
+#if defined( _M_X64 )
+                DWORD machine = IMAGE_FILE_MACHINE_AMD64;
+                frame.AddrPC.Offset = context.Rip;
+                frame.AddrFrame.Offset = context.Rbp;
+                frame.AddrStack.Offset = context.Rsp;
+#elif defined( _M_ARM64 )
+                DWORD machine = IMAGE_FILE_MACHINE_ARM64;
+                frame.AddrPC.Offset = context.Pc;
+                frame.AddrFrame.Offset = context.Fp;
+                frame.AddrStack.Offset = context.Sp;
+#else
+                DWORD machine = IMAGE_FILE_MACHINE_I386;
+                frame.AddrPC.Offset = context.Eip;
+                frame.AddrFrame.Offset = context.Ebp;
+                frame.AddrStack.Offset = context.Esp;
+#endif
+                while(  frameCount < MaxFrames &&
+                        StackWalk64( machine, process, thread, &frame, &context, NULL,
+                                     SymFunctionTableAccess64, SymGetModuleBase64, NULL ) &&
+                        frame.AddrPC.Offset != 0 )
+                    frames[frameCount++] = frame.AddrPC.Offset;
+            }
+            ResumeThread( thread );
+
+            ULONG64 buffer[( sizeof( SYMBOL_INFO ) + MAX_SYM_NAME + sizeof( ULONG64 ) - 1 ) / sizeof( ULONG64 )];
+            SYMBOL_INFO* symbol = reinterpret_cast<SYMBOL_INFO*>( buffer );
+            std::ostringstream oss;
+            for( int i = 0; i < frameCount; ++i )
+            {
+                ZeroMemory( buffer, sizeof( buffer ) );
+                symbol->SizeOfStruct = sizeof( SYMBOL_INFO );
+                symbol->MaxNameLen = MAX_SYM_NAME;
+                DWORD64 displacement = 0;
+                if( SymFromAddr( process, frames[i], &displacement, symbol ) )
+                    oss << "  " << symbol->Name << " + 0x" << std::hex << displacement << std::dec << "\n";
+                else
+                    oss << "  0x" << std::hex << frames[i] << std::dec << "\n";
+            }
+            return oss.str();
+        }
+
+#elif !defined( CATCH_PLATFORM_WINDOWS )
+
+        ///////////////////////////////////////////////////////////////////////
+        static std::string getBacktrace
+        (
+            pthread_t
+        )
+        {
+            return "";
+        }
+
+#endif
+
+    private:
+        ///////////////////////////////////////////////////////////////////////
+        static State& state
+        ()
+        {
+            static State s;
+            return s;
+        }
+
+#ifdef CATCH_WATCHDOG_HAS_BACKTRACE
+
+        ///////////////////////////////////////////////////////////////////////
+        static void captureFrames
+        (
+            int
+        )
+        {
+            State& s = state();
+            s.frameCount = backtrace( s.frames, MaxFrames );
+            s.framesCaptured = 1;
+        }
+
+#endif
+    };
+
+} // end namespace Catch
+
+#endif // TWOBLUECUBES_CATCH_WATCHDOG_HPP_INCLUDED
@@ -0,0 +1,262 @@
+/*
+ *  catch_worker_plan.hpp
+ *  Catch
+ *
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * Deals a test case's generator combinations, or a repeated run's
+ * repetitions, out to worker processes, and follows what the workers report
+ * as they go
+ */
+
+#ifndef TWOBLUECUBES_CATCH_WORKER_PLAN_HPP_INCLUDED
+#define TWOBLUECUBES_CATCH_WORKER_PLAN_HPP_INCLUDED
+
+#include "catch_config.hpp"
+#include "catch_event_stream.hpp"
+#include "catch_watchdog.hpp"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace Catch
+{
+    // The plan is made in the parent before the workers are forked, so each
+    // worker finds its share of the work in its copy of it
+    class WorkerPlan : NonCopyable
+    {
+    public:
+        ///////////////////////////////////////////////////////////////////////
+        explicit WorkerPlan
+        (
+            const Config& config
+        )
+        :   m_config( config ),
+            m_currentWorker( 0 ),
+            m_workerCount( 0 ),
+            m_isRepeating( false ),
+            m_repetitionLimit( 0 ),
+            m_timeout( 0 ),
+            m_failures( 0 ),
+            m_testCaseFailed( false )
+        {
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // Combinations 1 to combinations-1 are split into contiguous ranges,
+        // one per worker. Each worker has the timeout for every combination
+        // it runs, and the time for one that hangs to be stopped. Returns
+        // how many workers to run
+        std::size_t planCombinations
+        (
+            std::size_t combinations,
+            unsigned int timeout
+        )
+        {
+            m_workerCount = (std::min)( m_config.getWorkerCount(), combinations-1 );
+            m_isRepeating = false;
+            m_combinationStarts.clear();
+            for( std::size_t i = 0; i <= m_workerCount; ++i )
+                m_combinationStarts.push_back( 1 + i * ( combinations-1 ) / m_workerCount );
+
+            m_timeout = 0;
+            if( timeout != 0 )
+            {
+                std::size_t mostCombinations = ( combinations-1 + m_workerCount-1 ) / m_workerCount;
+                m_timeout = timeout * static_cast<unsigned int>( mostCombinations ) + 2 * Watchdog::CancelGraceMilliseconds;
+            }
+            startWatching();
+            return m_workerCount;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // Repetitions are dealt out to the workers in turn. 0 repeats until
+        // something fails. Returns how many workers to run
+        std::size_t planRepetitions
+        (
+            std::size_t repetitions
+        )
+        {
+            m_workerCount = m_config.getWorkerCount();
+            if( repetitions != 0 )
+                m_workerCount = (std::min)( m_workerCount, repetitions );
+            m_isRepeating = true;
+            m_repetitionLimit = repetitions;
+            m_timeout = 0;
+            startWatching();
+            return m_workerCount;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // Called in a worker as it starts (workerIndex counts from 0)
+        void enterWorker
+        (
+            std::size_t workerIndex
+        )
+        {
+            m_currentWorker = workerIndex + 1;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // Which worker this process is, from 1 - or 0 if it isn't one
+        std::size_t getCurrentWorker
+        ()
+        const
+        {
+            return m_currentWorker;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        bool isRepeating
+        ()
+        const
+        {
+            return m_isRepeating;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // A worker's first repetition is its index, and each one after that
+        // is as many workers on
+        std::size_t getNextRepetition
+        (
+            std::size_t repetition
+        )
+        const
+        {
+            return repetition + m_workerCount;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        bool hasRepetition
+        (
+            std::size_t repetition
+        )
+        const
+        {
+            return m_repetitionLimit == 0 || repetition < m_repetitionLimit;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        std::size_t getFirstCombination
+        (
+            std::size_t workerIndex
+        )
+        const
+        {
+            return m_combinationStarts[workerIndex];
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // One past the worker's last combination
+        std::size_t getEndCombination
+        (
+            std::size_t workerIndex
+        )
+        const
+        {
+            return m_combinationStarts[workerIndex+1];
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // How long a worker running combinations is given - 0 for as long
+        // as it takes
+        unsigned int getTimeout
+        ()
+        const
+        {
+            return m_timeout;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // Counts the failures the workers report as they go, so they can all
+        // be stopped as soon as the run is to be aborted (or, when repeating
+        // until something fails, as soon as a test case has failed), rather
+        // than after they have finished. failures is how many the run had
+        // before the workers started
+        bool shouldCancel
+        (
+            std::size_t workerIndex,
+            const std::string& output,
+            std::size_t failures
+        )
+        {
+            if( m_config.getAbortAfter() == 0 && !m_config.repeatUntilFail() )
+                return false;
+            EventReader reader( output, m_outputRead[workerIndex] );
+            Event event;
+            while( reader.next( event ) )
+            {
+                if( event.type == Event::Result && !event.result.ok() )
+                    m_failures++;
+                else if( event.type == Event::TestCaseEnded && event.failed > 0 )
+                    m_testCaseFailed = true;
+            }
+            m_outputRead[workerIndex] = reader.getPosition();
+            return ( m_config.getAbortAfter() != 0 && failures + m_failures >= m_config.getAbortAfter() )
+                || ( m_config.repeatUntilFail() && m_testCaseFailed );
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // Where the last event of this type ends
+        static std::size_t endOfLast
+        (
+            const std::string& output,
+            Event::Type type
+        )
+        {
+            EventReader reader( output );
+            Event event;
+            std::size_t end = 0;
+            while( reader.next( event ) )
+                if( event.type == type )
+                    end = reader.getPosition();
+            return end;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // Where each repetition starts in a worker's output
+        static std::vector<std::size_t> findRepetitions
+        (
+            const std::string& output
+        )
+        {
+            std::vector<std::size_t> starts;
+            EventReader reader( output );
+            Event event;
+            std::size_t start = 0;
+            while( reader.next( event ) )
+            {
+                if( event.type == Event::GroupStarted )
+                    starts.push_back( start );
+                start = reader.getPosition();
+            }
+            return starts;
+        }
+
+    private:
+        ///////////////////////////////////////////////////////////////////////
+        void startWatching
+        ()
+        {
+            m_outputRead.assign( m_workerCount, 0 );
+            m_failures = 0;
+            m_testCaseFailed = false;
+        }
+
+        const Config& m_config;
+        std::size_t m_currentWorker;
+        std::size_t m_workerCount;
+        bool m_isRepeating;
+        std::size_t m_repetitionLimit;
+        std::vector<std::size_t> m_combinationStarts;
+        unsigned int m_timeout;
+        std::vector<std::size_t> m_outputRead;
+        std::size_t m_failures;
+        bool m_testCaseFailed;
+    };
+
+} // end namespace Catch
+
+#endif // TWOBLUECUBES_CATCH_WORKER_PLAN_HPP_INCLUDED
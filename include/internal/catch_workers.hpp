@@ -0,0 +1,287 @@
+/*
+ *  catch_workers.hpp
+ *  Catch
+ *
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ *
+ * Runs work in forked child processes, collecting whatever each one writes.
+ * Processes, rather than threads, keep the (single threaded) Hub state and
+ * the tests themselves isolated from each other
+ */
+
+#ifndef TWOBLUECUBES_CATCH_WORKERS_HPP_INCLUDED
+#define TWOBLUECUBES_CATCH_WORKERS_HPP_INCLUDED
+
+#include "catch_debugger.hpp"
+#include "catch_stream.hpp"
+#include "catch_timer.hpp"
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+#ifndef CATCH_PLATFORM_WINDOWS
+    #include <errno.h>
+    #include <poll.h>
+    #include <signal.h>
+    #include <stdlib.h>
+    #include <sys/types.h>
+    #include <sys/wait.h>
+    #include <unistd.h>
+#endif
+
+namespace Catch
+{
+    struct IWorkerTask
+    {
+        virtual ~IWorkerTask
+        ()
+        {}
+
+        // Called in the child process. Anything written to os is returned
+        // to the parent
+        virtual void runWorker
+            (   std::size_t workerIndex,
+                std::ostream& os
+            ) = 0;
+
+        // Called in the parent as output arrives from a worker. Returning
+        // true cancels the workers that are still running
+        virtual bool shouldCancelWorkers
+        (
+            std::size_t /*workerIndex*/,
+            const std::string& /*output*/
+        )
+        {
+            return false;
+        }
+    };
+
+    struct WorkerResult
+    {
+        ///////////////////////////////////////////////////////////////////////
+        WorkerResult
+        ()
+        :   completed( false ),
+            timedOut( false ),
+            cancelled( false )
+        {
+        }
+
+        std::string output;
+        bool completed;
+        bool timedOut;
+        bool cancelled;
+    };
+
+#ifndef CATCH_PLATFORM_WINDOWS
+
+    ///////////////////////////////////////////////////////////////////////////
+    struct FileDescriptorWriter
+    {
+        ///////////////////////////////////////////////////////////////////////
+        explicit FileDescriptorWriter
+        (
+            int fd = -1
+        )
+        :   m_fd( fd )
+        {
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        void operator()
+        (
+            const std::string& str
+        )
+        {
+            const char* data = str.c_str();
+            std::size_t remaining = str.size();
+            while( remaining > 0 )
+            {
+                ssize_t written = ::write( m_fd, data, remaining );
+                if( written < 0 && errno == EINTR )
+                    continue;
+                if( written <= 0 )
+                    return;
+                data += written;
+                remaining -= static_cast<std::size_t>( written );
+            }
+        }
+
+        int m_fd;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    inline bool canRunWorkers
+    ()
+    {
+        return true;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Kills the workers that are still running, saying why in their results.
+    // Their pipes are closed once they have gone
+    inline void killWorkers
+    (
+        const std::vector<std::size_t>& runningWorkers,
+        const std::vector<pid_t>& pids,
+        std::vector<WorkerResult>& results,
+        bool WorkerResult::* reason
+    )
+    {
+        for( std::size_t i = 0; i < runningWorkers.size(); ++i )
+        {
+            WorkerResult& result = results[runningWorkers[i]];
+            if( !result.timedOut && !result.cancelled )
+                kill( pids[runningWorkers[i]], SIGKILL );
+            result.*reason = true;
+        }
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Forks workerCount children, each of which runs task.runWorker() then exits.
+    // Blocks until all have finished. Output is drained from all the children
+    // at once, so none of them stall on a full pipe. Children still running
+    // after timeout milliseconds (if not 0) are killed, as are all of them if
+    // the task asks for them to be cancelled
+    inline void runWorkers
+    (
+        std::size_t workerCount,
+        IWorkerTask& task,
+        std::vector<WorkerResult>& results,
+        unsigned int timeout = 0
+    )
+    {
+        uint64_t deadline = getCurrentMicroseconds() + static_cast<uint64_t>( timeout ) * 1000;
+        results.assign( workerCount, WorkerResult() );
+        std::vector<pid_t> pids( workerCount, -1 );
+        std::vector<int> fds( workerCount, -1 );
+
+        std::cout.flush();
+        std::cerr.flush();
+        for( std::size_t i = 0; i < workerCount; ++i )
+        {
+            int pipeFds[2];
+            if( pipe( pipeFds ) != 0 )
+                continue;
+            pids[i] = fork();
+            if( pids[i] == 0 )
+            {
+                ::close( pipeFds[0] );
+                int exitCode = 0;
+                {
+                    FileDescriptorWriter writer( pipeFds[1] );
+                    StreamBufImpl<FileDescriptorWriter, 4096> buf( writer );
+                    std::ostream os( &buf );
+                    try
+                    {
+                        task.runWorker( i, os );
+                    }
+                    catch(...)
+                    {
+                        exitCode = 1;
+                    }
+                    os.flush();
+                }
+                // Skip static destructors and atexit handlers - they belong to the parent
+                _exit( exitCode );
+            }
+            ::close( pipeFds[1] );
+            if( pids[i] < 0 )
+                ::close( pipeFds[0] );
+            else
+                fds[i] = pipeFds[0];
+        }
+
+        std::vector<pollfd> pollFds;
+        std::vector<std::size_t> pollWorkers;
+        for( std::size_t i = 0; i < workerCount; ++i )
+        {
+            if( fds[i] >= 0 )
+            {
+                pollfd pfd = { fds[i], POLLIN, 0 };
+                pollFds.push_back( pfd );
+                pollWorkers.push_back( i );
+            }
+        }
+        char buffer[4096];
+        while( !pollFds.empty() )
+        {
+            int pollTimeout = -1;
+            if( timeout != 0 )
+            {
+                uint64_t now = getCurrentMicroseconds();
+                if( now >= deadline )
+                {
+                    killWorkers( pollWorkers, pids, results, &WorkerResult::timedOut );
+                }
+                else
+                {
+                    pollTimeout = static_cast<int>( ( deadline - now + 999 ) / 1000 );
+                }
+            }
+            if( poll( &pollFds[0], pollFds.size(), pollTimeout ) < 0 )
+            {
+                if( errno == EINTR )
+                    continue;
+                break;
+            }
+            for( std::size_t p = pollFds.size(); p > 0; --p )
+            {
+                if( pollFds[p-1].revents == 0 )
+                    continue;
+                ssize_t bytesRead = ::read( pollFds[p-1].fd, buffer, sizeof( buffer ) );
+                if( bytesRead > 0 )
+                {
+                    std::size_t worker = pollWorkers[p-1];
+                    results[worker].output.append( buffer, static_cast<std::size_t>( bytesRead ) );
+                    if( !results[worker].cancelled && task.shouldCancelWorkers( worker, results[worker].output ) )
+                        killWorkers( pollWorkers, pids, results, &WorkerResult::cancelled );
+                }
+                else if( bytesRead == 0 || errno != EINTR )
+                {
+                    ::close( pollFds[p-1].fd );
+                    pollFds.erase( pollFds.begin() + static_cast<std::ptrdiff_t>( p-1 ) );
+                    pollWorkers.erase( pollWorkers.begin() + static_cast<std::ptrdiff_t>( p-1 ) );
+                }
+            }
+        }
+        for( std::size_t i = 0; i < workerCount; ++i )
+        {
+            int status = 0;
+            if( pids[i] > 0 && waitpid( pids[i], &status, 0 ) == pids[i] )
+                results[i].completed = WIFEXITED( status ) && WEXITSTATUS( status ) == 0;
+            // It may have finished just as it was killed
+            results[i].timedOut = results[i].timedOut && !results[i].completed;
+            results[i].cancelled = results[i].cancelled && !results[i].completed;
+        }
+    }
+
+#else // CATCH_PLATFORM_WINDOWS
+
+    ///////////////////////////////////////////////////////////////////////////
+    // !TBD: no fork() on Windows - callers fall back to running serially
+    inline bool canRunWorkers
+    ()
+    {
+        return false;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    inline void runWorkers
+    (
+        std::size_t workerCount,
+        IWorkerTask&,
+        std::vector<WorkerResult>& results,
+        unsigned int = 0
+    )
+    {
+        results.assign( workerCount, WorkerResult() );
+    }
+
+#endif // CATCH_PLATFORM_WINDOWS
+
+} // end namespace Catch
+
+#endif // TWOBLUECUBES_CATCH_WORKERS_HPP_INCLUDED
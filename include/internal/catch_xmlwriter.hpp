@@ -11,6 +11,7 @@
 #ifndef TWOBLUECUBES_CATCH_XMLWRITER_HPP_INCLUDED
 #define TWOBLUECUBES_CATCH_XMLWRITER_HPP_INCLUDED
 
+#include <algorithm>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -127,7 +128,6 @@ namespace Catch
             std::swap( m_tagIsOpen, other.m_tagIsOpen );
             std::swap( m_needsNewline, other.m_needsNewline );
             std::swap( m_tags, other.m_tags );
-            std::swap( m_indent, other.m_indent );
             std::swap( m_os, other.m_os );
         }
         
@@ -139,9 +139,9 @@ namespace Catch
         {
             ensureTagClosed();
             newlineIfNecessary();
-            stream() << m_indent << "<" << name;
+            writeIndent( m_tags.size() );
+            stream() << "<" << name;
             m_tags.push_back( name );
-            m_indent += "  ";
             m_tagIsOpen = true;
             return *this;
         }
@@ -162,7 +162,6 @@ namespace Catch
         ()
         {
             newlineIfNecessary();
-            m_indent = m_indent.substr( 0, m_indent.size()-2 );
             if( m_tagIsOpen )
             {
                 stream() << "/>\n";
@@ -170,8 +169,9 @@ namespace Catch
             }
             else
             {
-                stream() << m_indent << "</" << m_tags.back() << ">\n";
-            } 
+                writeIndent( m_tags.size()-1 );
+                stream() << "</" << m_tags.back() << ">\n";
+            }
             m_tags.pop_back();
             return *this;
         }
@@ -192,6 +192,17 @@ namespace Catch
             return *this;
         }
 
+        ///////////////////////////////////////////////////////////////////////
+        // Otherwise string literals would be streamed, unencoded, by the template
+        XmlWriter& writeAttribute
+        (
+            const std::string& name, 
+            const char* attribute
+        )
+        {
+            return writeAttribute( name, std::string( attribute ) );
+        }
+
         ///////////////////////////////////////////////////////////////////////
         XmlWriter& writeAttribute
         (
@@ -229,7 +240,7 @@ namespace Catch
                 bool tagWasOpen = m_tagIsOpen;
                 ensureTagClosed();
                 if( tagWasOpen )
-                    stream() << m_indent;
+                    writeIndent( m_tags.size() );
                 writeEncodedText( text );
                 m_needsNewline = true;
             }
@@ -243,7 +254,8 @@ namespace Catch
         )
         {
             ensureTagClosed();
-            stream() << m_indent << "<!--" << text << "-->";
+            writeIndent( m_tags.size() );
+            stream() << "<!--" << text << "-->";
             m_needsNewline = true;
             return *this;
         }
@@ -289,42 +301,97 @@ namespace Catch
         }
         
         ///////////////////////////////////////////////////////////////////////
-        void writeEncodedText
+        // Indentation is written from a cached run of spaces, which only
+        // grows, rather than being rebuilt at each level
+        void writeIndent
         (
-            const std::string& text
+            std::size_t depth
         )
         {
-            // !TBD finish this
-            if( !findReplaceableString( text, "<", "&lt;" ) &&
-               !findReplaceableString( text, "&", "&amp;" ) &&
-               !findReplaceableString( text, "\"", "&quote;" ) )
+            std::size_t width = depth * 2;
+            if( m_spaces.size() < width )
+                m_spaces.resize( width * 2, ' ' );
+            stream().write( m_spaces.data(), static_cast<std::streamsize>( width ) );
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // Non-zero for characters that can't be written as they are: markup,
+        // and the control characters XML 1.0 doesn't allow at all
+        static unsigned char needsEncoding
+        (
+            unsigned char c
+        )
+        {
+            static const unsigned char table[256] =
             {
-                stream() << text;
-            }
+                1,1,1,1,1,1,1,1, 1,0,0,1,1,0,1,1, 1,1,1,1,1,1,1,1, 1,1,1,1,1,1,1,1,
+                0,0,1,0,0,0,1,0, 0,0,0,0,0,0,0,0, 0,0,0,0,0,0,0,0, 0,0,0,0,1,0,1,0,
+                0,0,0,0,0,0,0,0, 0,0,0,0,0,0,0,0, 0,0,0,0,0,0,0,0, 0,0,0,0,0,0,0,0,
+                0,0,0,0,0,0,0,0, 0,0,0,0,0,0,0,0, 0,0,0,0,0,0,0,0, 0,0,0,0,0,0,0,0,
+                0,0,0,0,0,0,0,0, 0,0,0,0,0,0,0,0, 0,0,0,0,0,0,0,0, 0,0,0,0,0,0,0,0,
+                0,0,0,0,0,0,0,0, 0,0,0,0,0,0,0,0, 0,0,0,0,0,0,0,0, 0,0,0,0,0,0,0,0,
+                0,0,0,0,0,0,0,0, 0,0,0,0,0,0,0,0, 0,0,0,0,0,0,0,0, 0,0,0,0,0,0,0,0,
+                0,0,0,0,0,0,0,0, 0,0,0,0,0,0,0,0, 0,0,0,0,0,0,0,0, 0,0,0,0,0,0,0,0
+            };
+            return table[c];
         }
-        
+
         ///////////////////////////////////////////////////////////////////////
-        bool findReplaceableString
+        // Text with nothing to encode (the usual case) goes straight to the
+        // stream. Otherwise runs of plain characters are copied in bulk into
+        // a buffer, which is reused between calls, and written in one go
+        void writeEncodedText
         (
-            const std::string& text, 
-            const std::string& replaceWhat, 
-            const std::string& replaceWith
+            const std::string& text
         )
         {
-            std::string::size_type pos = text.find_first_of( replaceWhat );
-            if( pos != std::string::npos )
+            const char* data = text.data();
+            std::size_t size = text.size();
+            std::size_t pos = 0;
+            while( pos < size && !needsEncoding( static_cast<unsigned char>( data[pos] ) ) )
+                ++pos;
+            if( pos == size )
+            {
+                stream().write( data, static_cast<std::streamsize>( size ) );
+                return;
+            }
+
+            m_buffer.clear();
+            std::size_t runStart = 0;
+            for(; pos < size; ++pos )
             {
-                stream() << text.substr( 0, pos ) << replaceWith;
-                writeEncodedText( text.substr( pos+1 ) );
-                return true;
+                unsigned char c = static_cast<unsigned char>( data[pos] );
+                if( !needsEncoding( c ) )
+                    continue;
+                m_buffer.append( data + runStart, pos - runStart );
+                runStart = pos+1;
+                switch( c )
+                {
+                    case '<':   m_buffer += "&lt;";     break;
+                    case '>':   m_buffer += "&gt;";     break;
+                    case '&':   m_buffer += "&amp;";    break;
+                    case '"':   m_buffer += "&quot;";   break;
+                    default:
+                        {
+                            // Can't be represented, even as a character reference,
+                            // so write something readable instead
+                            static const char hexDigits[] = "0123456789ABCDEF";
+                            m_buffer += "\\x";
+                            m_buffer += hexDigits[c >> 4];
+                            m_buffer += hexDigits[c & 0xf];
+                        }
+                        break;
+                }
             }
-            return false;
+            m_buffer.append( data + runStart, size - runStart );
+            stream().write( m_buffer.data(), static_cast<std::streamsize>( m_buffer.size() ) );
         }
-        
+
         bool m_tagIsOpen;
         bool m_needsNewline;
         std::vector<std::string> m_tags;
-        std::string m_indent;
+        std::string m_spaces;
+        std::string m_buffer;
         std::ostream* m_os;
     };
     
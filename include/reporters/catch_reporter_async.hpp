@@ -0,0 +1,650 @@
+/*
+ *  catch_reporter_async.hpp
+ *  Catch
+ *
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ *
+ */
+#ifndef TWOBLUECUBES_CATCH_REPORTER_ASYNC_HPP_INCLUDED
+#define TWOBLUECUBES_CATCH_REPORTER_ASYNC_HPP_INCLUDED
+
+#include "../internal/catch_interfaces_reporter.h"
+#include "../internal/catch_resultinfo.hpp"
+#include "../internal/catch_test_case_info.hpp"
+#include "../internal/catch_threading.hpp"
+
+#include <exception>
+#include <signal.h>
+#include <streambuf>
+#include <vector>
+
+namespace Catch
+{
+    // Collects whatever is written into large blocks. Flushes from the reporter
+    // (e.g. std::endl) are ignored - the owner decides when a block is written
+    class BatchingStreamBuf : public std::streambuf
+    {
+    public:
+        ///////////////////////////////////////////////////////////////////////
+        explicit BatchingStreamBuf
+        (
+            std::size_t size
+        )
+        :   m_target( NULL ),
+            m_data( size )
+        {
+            setp( &m_data[0], &m_data[0] + m_data.size() );
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        void setTarget
+        (
+            std::streambuf* target
+        )
+        {
+            m_target = target;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        void flushBatch
+        ()
+        {
+            writeBlock();
+            if( m_target )
+                m_target->pubsync();
+        }
+
+    private:
+        ///////////////////////////////////////////////////////////////////////
+        void writeBlock
+        ()
+        {
+            if( pptr() != pbase() && m_target )
+            {
+                m_target->sputn( pbase(), pptr() - pbase() );
+                setp( pbase(), epptr() );
+            }
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        virtual int overflow
+        (
+            int c
+        )
+        {
+            writeBlock();
+            if( c != EOF )
+                sputc( static_cast<char>( c ) );
+            return 0;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        virtual std::streamsize xsputn
+        (
+            const char* s,
+            std::streamsize n
+        )
+        {
+            if( n > epptr() - pptr() )
+            {
+                writeBlock();
+                if( n >= epptr() - pbase() )
+                    return m_target->sputn( s, n );
+            }
+            std::copy( s, s+n, pptr() );
+            pbump( static_cast<int>( n ) );
+            return n;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        virtual int sync
+        ()
+        {
+            return 0;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // Seeking writes out what has been collected so far, so positions
+        // are those of the target
+        virtual pos_type seekoff
+        (
+            off_type off,
+            std::ios_base::seekdir dir,
+            std::ios_base::openmode which
+        )
+        {
+            if( !m_target )
+                return pos_type( off_type( -1 ) );
+            writeBlock();
+            return m_target->pubseekoff( off, dir, which );
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        virtual pos_type seekpos
+        (
+            pos_type pos,
+            std::ios_base::openmode which
+        )
+        {
+            if( !m_target )
+                return pos_type( off_type( -1 ) );
+            writeBlock();
+            return m_target->pubseekpos( pos, which );
+        }
+
+        std::streambuf* m_target;
+        std::vector<char> m_data;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Wraps another reporter so that formatting and writing happen on a
+    // dedicated thread. The test thread only copies each event into a queue,
+    // which the writer takes as a whole, so they rarely contend for the lock.
+    // If the queue holds more than maxQueuedBytes the test thread waits for it
+    // to drain, so a slow output can't use unbounded memory.
+    // Whatever is queued is written at EndTesting, or on SIGTERM or
+    // std::terminate (best effort - the process is going down anyway).
+    // Nothing unsafe happens in the signal handler: it just notes the
+    // signal, and the writer thread, which checks for one at least every
+    // 50ms, writes out the queue and then raises it again. Signals that
+    // mean the process is already broken (SIGSEGV, SIGABRT, SIGBUS...) and
+    // SIGKILL aren't handled, so what is still queued then is lost
+    class AsyncReporter : public IReporter, private IRunnable
+    {
+        struct Event
+        {
+            enum Type
+            {
+                StartTesting,
+                EndTesting,
+                StartGroup,
+                EndGroup,
+                StartSection,
+                EndSection,
+                EndGeneratorCombination,
+                StartTestCase,
+                EndTestCase,
+                Result,
+                TestCaseRepeated
+            };
+
+            ///////////////////////////////////////////////////////////////////
+            explicit Event
+            (
+                Type type_,
+                const std::string& name_ = "",
+                std::size_t succeeded_ = 0,
+                std::size_t failed_ = 0
+            )
+            :   type( type_ ),
+                name( name_ ),
+                succeeded( succeeded_ ),
+                failed( failed_ ),
+                combination( 0 )
+            {
+            }
+
+            ///////////////////////////////////////////////////////////////////
+            std::size_t approximateSize
+            ()
+            const
+            {
+                return  sizeof( Event ) + name.size() + text.size() + stdErr.size() +
+                        result.getExpression().size() + result.getMessage().size();
+            }
+
+            Type type;
+            std::string name;
+            std::string text;
+            std::string stdErr;
+            std::size_t succeeded;
+            std::size_t failed;
+            std::size_t combination;
+            ResourceUsage usage;
+            TestCaseInfo testInfo;
+            ResultInfo result;
+            RepeatStats repeatStats;
+        };
+
+    public:
+        ///////////////////////////////////////////////////////////////////////
+        AsyncReporter
+        (
+            const IReporterConfig& config,
+            IReporter* reporter,
+            std::size_t maxQueuedBytes = 16 * 1024 * 1024
+        )
+        :   m_config( config ),
+            m_reporter( reporter ),
+            m_originalBuf( NULL ),
+            m_batchBuf( 64 * 1024 ),
+            m_isActive( false ),
+            m_maxQueuedBytes( maxQueuedBytes ),
+            m_queuedBytes( 0 ),
+            m_stopping( false ),
+            m_isHandlingSigTerm( false ),
+            m_previousSigTerm( SIG_DFL ),
+            m_previousTerminate( NULL )
+        {
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        ~AsyncReporter
+        ()
+        {
+            stop();
+        }
+
+    private: // IReporter
+
+        ///////////////////////////////////////////////////////////////////////
+        virtual void StartTesting
+        ()
+        {
+            if( !m_isActive )
+            {
+                // The wrapped reporter writes to the config's stream, so
+                // batch that up until the writer thread decides to write
+                m_originalBuf = m_config.stream().rdbuf();
+                m_batchBuf.setTarget( m_originalBuf );
+                m_config.stream().rdbuf( &m_batchBuf );
+
+                m_stopping = false;
+                m_thread.start( *this );
+                installCrashHandlers();
+                m_isActive = true;
+            }
+            enqueue( Event( Event::StartTesting ) );
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        virtual void EndTesting
+        (
+            std::size_t succeeded,
+            std::size_t failed
+        )
+        {
+            enqueue( Event( Event::EndTesting, "", succeeded, failed ) );
+            stop();
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        virtual void StartGroup
+        (
+            const std::string& groupName
+        )
+        {
+            enqueue( Event( Event::StartGroup, groupName ) );
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        virtual void EndGroup
+        (
+            const std::string& groupName,
+            std::size_t succeeded,
+            std::size_t failed
+        )
+        {
+            enqueue( Event( Event::EndGroup, groupName, succeeded, failed ) );
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        virtual void StartSection
+        (
+            const std::string& sectionName,
+            const std::string description
+        )
+        {
+            Event event( Event::StartSection, sectionName );
+            event.text = description;
+            enqueue( event );
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        virtual void EndSection
+        (
+            const std::string& sectionName,
+            std::size_t succeeded,
+            std::size_t failed,
+            const std::string& stdOut,
+            const std::string& stdErr,
+            const ResourceUsage& usage
+        )
+        {
+            Event event( Event::EndSection, sectionName, succeeded, failed );
+            event.text = stdOut;
+            event.stdErr = stdErr;
+            event.usage = usage;
+            enqueue( event );
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        virtual void EndGeneratorCombination
+        (
+            std::size_t combination,
+            std::size_t succeeded,
+            std::size_t failed,
+            const ResourceUsage& usage
+        )
+        {
+            Event event( Event::EndGeneratorCombination, "", succeeded, failed );
+            event.combination = combination;
+            event.usage = usage;
+            enqueue( event );
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        virtual void StartTestCase
+        (
+            const TestCaseInfo& testInfo
+        )
+        {
+            Event event( Event::StartTestCase );
+            event.testInfo = testInfo;
+            enqueue( event );
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        virtual void EndTestCase
+        (
+            const TestCaseInfo& testInfo,
+            std::size_t succeeded,
+            std::size_t failed,
+            const std::string& stdOut,
+            const std::string& stdErr,
+            const ResourceUsage& usage
+        )
+        {
+            Event event( Event::EndTestCase, "", succeeded, failed );
+            event.testInfo = testInfo;
+            event.text = stdOut;
+            event.stdErr = stdErr;
+            event.usage = usage;
+            enqueue( event );
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        virtual void Result
+        (
+            const ResultInfo& result
+        )
+        {
+            Event event( Event::Result );
+            event.result = result;
+            enqueue( event );
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        virtual void TestCaseRepeated
+        (
+            const RepeatStats& stats
+        )
+        {
+            Event event( Event::TestCaseRepeated );
+            event.repeatStats = stats;
+            enqueue( event );
+        }
+
+    private: // IRunnable
+
+        ///////////////////////////////////////////////////////////////////////
+        // The writer thread
+        virtual void run
+        ()
+        {
+            std::vector<Event> batch;
+            for(;;)
+            {
+                {
+                    ScopedLock lock( m_queueMutex );
+                    while( m_queue.empty() && !m_stopping && !pendingSignal() )
+                        m_queueChanged.waitFor( m_queueMutex, 50 );
+                    if( m_queue.empty() && !pendingSignal() )
+                        return;
+                    batch.swap( m_queue );
+                    m_queuedBytes = 0;
+                    m_queueChanged.notifyAll();
+                }
+                {
+                    ScopedLock lock( m_writeMutex );
+                    dispatch( batch );
+                }
+                batch.clear();
+
+                // Anything queued since the signal arrived is lost, but the
+                // process shouldn't outlive it by more than a batch
+                if( int sig = pendingSignal() )
+                {
+                    pendingSignal() = 0;
+                    signal( sig, SIG_DFL );
+                    raise( sig );
+                }
+            }
+        }
+
+    private:
+
+        ///////////////////////////////////////////////////////////////////////
+        void enqueue
+        (
+            const Event& event
+        )
+        {
+            if( !m_thread.isStarted() )
+            {
+                // No writer thread - so report synchronously
+                ScopedLock lock( m_writeMutex );
+                dispatch( std::vector<Event>( 1, event ) );
+                return;
+            }
+
+            ScopedLock lock( m_queueMutex );
+            while( m_queuedBytes >= m_maxQueuedBytes && !m_queue.empty() )
+                m_queueChanged.wait( m_queueMutex );
+            m_queue.push_back( event );
+            m_queuedBytes += event.approximateSize();
+            if( m_queue.size() == 1 )
+                m_queueChanged.notifyAll();
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // m_writeMutex must be held
+        void dispatch
+        (
+            const std::vector<Event>& events
+        )
+        {
+            std::vector<Event>::const_iterator it = events.begin();
+            std::vector<Event>::const_iterator itEnd = events.end();
+            for(; it != itEnd; ++it )
+            {
+                switch( it->type )
+                {
+                    case Event::StartTesting:
+                        m_reporter->StartTesting();
+                        break;
+                    case Event::EndTesting:
+                        m_reporter->EndTesting( it->succeeded, it->failed );
+                        break;
+                    case Event::StartGroup:
+                        m_reporter->StartGroup( it->name );
+                        break;
+                    case Event::EndGroup:
+                        m_reporter->EndGroup( it->name, it->succeeded, it->failed );
+                        break;
+                    case Event::StartSection:
+                        m_reporter->StartSection( it->name, it->text );
+                        break;
+                    case Event::EndSection:
+                        m_reporter->EndSection( it->name, it->succeeded, it->failed, it->text, it->stdErr, it->usage );
+                        break;
+                    case Event::EndGeneratorCombination:
+                        m_reporter->EndGeneratorCombination( it->combination, it->succeeded, it->failed, it->usage );
+                        break;
+                    case Event::StartTestCase:
+                        m_reporter->StartTestCase( it->testInfo );
+                        break;
+                    case Event::EndTestCase:
+                        m_reporter->EndTestCase( it->testInfo, it->succeeded, it->failed, it->text, it->stdErr, it->usage );
+                        break;
+                    case Event::Result:
+                        m_reporter->Result( it->result );
+                        break;
+                    case Event::TestCaseRepeated:
+                        m_reporter->TestCaseRepeated( it->repeatStats );
+                        break;
+                }
+            }
+            m_batchBuf.flushBatch();
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        void stop
+        ()
+        {
+            if( !m_isActive )
+                return;
+            if( m_thread.isStarted() )
+            {
+                {
+                    ScopedLock lock( m_queueMutex );
+                    m_stopping = true;
+                    m_queueChanged.notifyAll();
+                }
+                m_thread.join();
+            }
+            restoreCrashHandlers();
+            m_config.stream().rdbuf( m_originalBuf );
+            m_isActive = false;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // Called by std::terminate, as the process is dying. The writer
+        // thread may be part way through a batch, so give it a moment, then
+        // write whatever is left
+        void flushForCrash
+        ()
+        {
+            for( int attempt = 0; attempt < 100; ++attempt )
+            {
+                if( m_writeMutex.tryLock() )
+                {
+                    if( m_queueMutex.tryLock() )
+                    {
+                        std::vector<Event> batch;
+                        batch.swap( m_queue );
+                        m_queueMutex.unlock();
+                        dispatch( batch );
+                        m_writeMutex.unlock();
+                        return;
+                    }
+                    m_writeMutex.unlock();
+                }
+                sleepFor( 10 );
+            }
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        static AsyncReporter*& current
+        ()
+        {
+            static AsyncReporter* reporter = NULL;
+            return reporter;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // Set by the signal handler, for the writer thread to act on
+        static volatile sig_atomic_t& pendingSignal
+        ()
+        {
+            static volatile sig_atomic_t sig = 0;
+            return sig;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // Only does what is safe in a signal handler
+        static void onSigTerm
+        (
+            int sig
+        )
+        {
+            pendingSignal() = sig;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        static void onTerminate
+        ()
+        {
+            std::terminate_handler previous = NULL;
+            if( AsyncReporter* reporter = current() )
+            {
+                previous = reporter->m_previousTerminate;
+                current() = NULL;
+                reporter->flushForCrash();
+            }
+            if( previous )
+                previous();
+            abort();
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        void installCrashHandlers
+        ()
+        {
+            current() = this;
+            // Without a writer thread there would be nothing to act on it
+            m_isHandlingSigTerm = m_thread.isStarted();
+            if( m_isHandlingSigTerm )
+                m_previousSigTerm = signal( SIGTERM, onSigTerm );
+            m_previousTerminate = std::set_terminate( onTerminate );
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        void restoreCrashHandlers
+        ()
+        {
+            if( current() != this )
+                return;
+            if( m_isHandlingSigTerm )
+            {
+                signal( SIGTERM, m_previousSigTerm == SIG_ERR ? SIG_DFL : m_previousSigTerm );
+                m_isHandlingSigTerm = false;
+
+                // Arrived once the writer thread had finished
+                if( int sig = pendingSignal() )
+                {
+                    pendingSignal() = 0;
+                    raise( sig );
+                }
+            }
+            std::set_terminate( m_previousTerminate );
+            current() = NULL;
+        }
+
+    private:
+        const IReporterConfig& m_config;
+        std::auto_ptr<IReporter> m_reporter;
+        std::streambuf* m_originalBuf;
+        BatchingStreamBuf m_batchBuf;
+        bool m_isActive;
+
+        Thread m_thread;
+        Mutex m_queueMutex;
+        Mutex m_writeMutex;
+        ConditionVariable m_queueChanged;
+        std::vector<Event> m_queue;
+        std::size_t m_maxQueuedBytes;
+        std::size_t m_queuedBytes;
+        bool m_stopping;
+
+        bool m_isHandlingSigTerm;
+        void (*m_previousSigTerm)( int );
+        std::terminate_handler m_previousTerminate;
+    };
+
+} // end namespace Catch
+
+#endif // TWOBLUECUBES_CATCH_REPORTER_ASYNC_HPP_INCLUDED
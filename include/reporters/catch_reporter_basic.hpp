@@ -46,7 +46,8 @@ namespace Catch
         (
             const IReporterConfig& config
         )
-        :   m_config( config )
+        :   m_config( config ),
+            m_firstSectionInTestCase( true )
         {
         }
 
@@ -95,6 +96,7 @@ namespace Catch
             // Output the overall test results even if "Started Testing" was not emitted
             m_config.stream() << "[Testing completed. ";
             ReportCounts( succeeded, failed );
+            ReportRngSeed();
             m_config.stream() << "]\n" << std::endl;
         }
         
@@ -131,6 +133,7 @@ namespace Catch
         )
         {
             m_testSpan = testInfo.getName();
+            m_firstSectionInTestCase = true;
         }
         
         ///////////////////////////////////////////////////////////////////////////
@@ -148,7 +151,10 @@ namespace Catch
         (
             const std::string& sectionName, 
             std::size_t succeeded, 
-            std::size_t failed
+            std::size_t failed,
+            const std::string& /*stdOut*/,
+            const std::string& /*stdErr*/,
+            const ResourceUsage& /*usage*/
         )
         {
             SpanInfo& sectionSpan = m_sectionSpans.back();
@@ -160,6 +166,17 @@ namespace Catch
             }
             m_sectionSpans.pop_back();
         }
+
+        ///////////////////////////////////////////////////////////////////////////
+        virtual void EndGeneratorCombination
+        (
+            std::size_t /*combination*/,
+            std::size_t /*succeeded*/,
+            std::size_t /*failed*/,
+            const ResourceUsage& /*usage*/
+        )
+        {
+        }
         
         ///////////////////////////////////////////////////////////////////////////
         virtual void Result
@@ -236,7 +253,8 @@ namespace Catch
             std::size_t succeeded, 
             std::size_t failed, 
             const std::string& stdOut, 
-            const std::string& stdErr
+            const std::string& stdErr,
+            const ResourceUsage& /*usage*/
         )
         {
             if( !stdOut.empty() )
@@ -259,17 +277,56 @@ namespace Catch
             }
         }    
 
+        ///////////////////////////////////////////////////////////////////////////
+        // Only reported for test cases that failed at least once, unless
+        // successful results are being reported too
+        virtual void TestCaseRepeated
+        (
+            const RepeatStats& stats
+        )
+        {
+            if( stats.getFailedRuns() == 0 && !m_config.includeSuccessfulResults() )
+                return;
+
+            m_config.stream() << "[Repeated: " << stats.name << " - passed "
+                << stats.runs - stats.getFailedRuns() << " of " << stats.runs << " run(s) ("
+                << stats.getPassRate() * 100 << "%), taking "
+                << stats.minMicroseconds / 1000.0 << " ms min, "
+                << stats.medianMicroseconds / 1000.0 << " ms median, "
+                << stats.maxMicroseconds / 1000.0 << " ms max";
+            if( stats.getFailedRuns() > 0 )
+            {
+                m_config.stream() << ". Failed in repetition(s) ";
+                for( std::size_t i = 0; i < stats.getFailedRuns(); ++i )
+                {
+                    m_config.stream() << ( i == 0 ? "" : ", " ) << stats.failedRepetitions[i];
+                    if( stats.failedRngSeeds[i] != 0 )
+                        m_config.stream() << " (--rng-seed " << stats.failedRngSeeds[i] << ")";
+                }
+            }
+            m_config.stream() << "]" << std::endl;
+        }
+
     private: // helpers
         
+        ///////////////////////////////////////////////////////////////////////////
+        void ReportRngSeed()
+        {
+            if( unsigned int rngSeed = m_config.getRngSeed() )
+                m_config.stream() << " (in random order, --rng-seed " << rngSeed << ")";
+        }
+
         ///////////////////////////////////////////////////////////////////////////
         void StartSpansLazily()
         {
             if( !m_testingSpan.emitted )
             {
                 if( m_config.getName().empty() )
-                    m_config.stream() << "[Started testing]" << std::endl;
+                    m_config.stream() << "[Started testing";
                 else
-                    m_config.stream() << "[Started testing: " << m_config.getName() << "]" << std::endl;
+                    m_config.stream() << "[Started testing: " << m_config.getName();
+                ReportRngSeed();
+                m_config.stream() << "]" << std::endl;
                 m_testingSpan.emitted = true;
             }
             
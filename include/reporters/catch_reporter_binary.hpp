@@ -0,0 +1,367 @@
+/*
+ *  catch_reporter_binary.hpp
+ *  Catch
+ *
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ *
+ */
+#ifndef TWOBLUECUBES_CATCH_REPORTER_BINARY_HPP_INCLUDED
+#define TWOBLUECUBES_CATCH_REPORTER_BINARY_HPP_INCLUDED
+
+#include "../internal/catch_binary_log.hpp"
+#include "../internal/catch_interfaces_reporter.h"
+#include "../internal/catch_reporter_registrars.hpp"
+#include "../internal/catch_timer.hpp"
+
+#include <map>
+
+namespace Catch
+{
+    // Writes the events as they happen to a BinaryLog, doing no formatting at
+    // all. When reporting to a file the file is memory mapped (where that is
+    // supported), otherwise records are written to the stream and it is
+    // flushed at the end of each test case
+    class BinaryReporter : public Catch::IReporter
+    {
+    public:
+        ///////////////////////////////////////////////////////////////////////////
+        BinaryReporter
+        (
+            const IReporterConfig& config
+        )
+        :   m_config( config )
+        {
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        static std::string getDescription
+        ()
+        {
+            return "Writes a compact binary log, which --convert can turn into any other report";
+        }
+
+    private: // IReporter
+
+        ///////////////////////////////////////////////////////////////////////////
+        virtual void StartTesting
+        ()
+        {
+            m_strings.clear();
+            m_timer.restart();
+            if( !m_config.getFilename().empty() )
+                m_file.open( m_config.getFilename() );
+
+            BinaryLog::Header header;
+            std::memset( &header, 0, sizeof( header ) );
+            std::memcpy( header.magic, BinaryLog::getMagic(), sizeof( header.magic ) );
+            header.version = BinaryLog::Version;
+            header.byteOrderMark = BinaryLog::ByteOrderMark;
+            header.rngSeed = m_config.getRngSeed();
+            write( reinterpret_cast<const char*>( &header ), sizeof( header ) );
+
+            writeRecord( BinaryLog::StartTesting );
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        virtual void EndTesting
+        (
+            std::size_t succeeded,
+            std::size_t failed
+        )
+        {
+            writeRecord( BinaryLog::EndTesting, count( succeeded ), count( failed ) );
+            if( m_file.isOpen() )
+                m_file.close();
+            else
+                m_config.stream().flush();
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        virtual void StartGroup
+        (
+            const std::string& groupName
+        )
+        {
+            writeRecord( BinaryLog::StartGroup, intern( groupName ) );
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        virtual void EndGroup
+        (
+            const std::string& groupName,
+            std::size_t succeeded,
+            std::size_t failed
+        )
+        {
+            writeRecord( BinaryLog::EndGroup, intern( groupName ), count( succeeded ), count( failed ) );
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        virtual void StartSection
+        (
+            const std::string& sectionName,
+            const std::string description
+        )
+        {
+            writeRecord( BinaryLog::StartSection, intern( sectionName ), intern( description ) );
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        virtual void EndSection
+        (
+            const std::string& sectionName,
+            std::size_t succeeded,
+            std::size_t failed,
+            const std::string& stdOut,
+            const std::string& stdErr,
+            const ResourceUsage& usage
+        )
+        {
+            writeUsage( usage );
+            uint32_t fields[BinaryLog::FieldCount] =
+            {
+                intern( sectionName ), count( succeeded ), count( failed ), intern( stdOut ), intern( stdErr )
+            };
+            writeRecord( BinaryLog::EndSection, fields );
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        virtual void EndGeneratorCombination
+        (
+            std::size_t combination,
+            std::size_t succeeded,
+            std::size_t failed,
+            const ResourceUsage& usage
+        )
+        {
+            writeUsage( usage );
+            writeRecord( BinaryLog::EndGeneratorCombination, count( combination ), count( succeeded ), count( failed ), count( usage.worker ) );
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        virtual void StartTestCase
+        (
+            const TestCaseInfo& testInfo
+        )
+        {
+            writeRecord( BinaryLog::StartTestCase,
+                         intern( testInfo.getName() ),
+                         intern( testInfo.getDescription() ),
+                         intern( testInfo.getFilename() ),
+                         count( testInfo.getLine() ) );
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        virtual void EndTestCase
+        (
+            const TestCaseInfo& testInfo,
+            std::size_t succeeded,
+            std::size_t failed,
+            const std::string& stdOut,
+            const std::string& stdErr,
+            const ResourceUsage& usage
+        )
+        {
+            writeUsage( usage );
+            uint32_t fields[BinaryLog::FieldCount] =
+            {
+                intern( testInfo.getName() ), count( succeeded ), count( failed ), intern( stdOut ), intern( stdErr )
+            };
+            writeRecord( BinaryLog::EndTestCase, fields );
+            if( !m_file.isOpen() )
+                m_config.stream().flush();
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        virtual void Result
+        (
+            const ResultInfo& result
+        )
+        {
+            uint32_t fields[BinaryLog::FieldCount] =
+            {
+                intern( result.m_macroName ),
+                intern( result.m_filename ),
+                count( result.m_line ),
+                intern( result.m_expr ),
+                intern( result.m_lhs ),
+                intern( result.m_rhs ),
+                intern( result.m_op ),
+                intern( result.m_message ),
+                static_cast<uint32_t>( result.m_result ),
+                result.m_isNot ? 1u : 0u
+            };
+            writeRecord( BinaryLog::Result, fields );
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        virtual void TestCaseRepeated
+        (
+            const RepeatStats& stats
+        )
+        {
+            for( std::size_t i = 0; i < stats.getFailedRuns(); ++i )
+                writeRecord( BinaryLog::FailedRepetition, count( stats.failedRepetitions[i] ), stats.failedRngSeeds[i] );
+            uint32_t fields[BinaryLog::FieldCount] =
+            {
+                intern( stats.name ),
+                count( stats.runs ),
+                low( stats.minMicroseconds ), high( stats.minMicroseconds ),
+                low( stats.medianMicroseconds ), high( stats.medianMicroseconds ),
+                low( stats.maxMicroseconds ), high( stats.maxMicroseconds )
+            };
+            writeRecord( BinaryLog::TestCaseRepeated, fields );
+        }
+
+    private:
+
+        ///////////////////////////////////////////////////////////////////////////
+        void writeRecord
+        (
+            BinaryLog::RecordType type,
+            uint32_t field0 = 0,
+            uint32_t field1 = 0,
+            uint32_t field2 = 0,
+            uint32_t field3 = 0
+        )
+        {
+            uint32_t fields[BinaryLog::FieldCount] = { field0, field1, field2, field3 };
+            writeRecord( type, fields );
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        void writeRecord
+        (
+            BinaryLog::RecordType type,
+            const uint32_t ( &fields )[BinaryLog::FieldCount]
+        )
+        {
+            uint64_t microseconds = m_timer.getElapsedMicroseconds();
+
+            BinaryLog::Record record;
+            record.type = type;
+            std::memcpy( record.fields, fields, sizeof( record.fields ) );
+            record.microsecondsLow = static_cast<uint32_t>( microseconds );
+            record.microsecondsHigh = static_cast<uint32_t>( microseconds >> 32 );
+            write( reinterpret_cast<const char*>( &record ), sizeof( record ) );
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        void writeUsage
+        (
+            const ResourceUsage& usage
+        )
+        {
+            if( usage.allocationsCounted )
+            {
+                uint32_t fields[BinaryLog::FieldCount] =
+                {
+                    count( usage.allocations ),
+                    count( usage.deallocations ),
+                    low( usage.bytesAllocated ), high( usage.bytesAllocated ),
+                    low( usage.bytesFreed ), high( usage.bytesFreed ),
+                    low( usage.peakBytes ), high( usage.peakBytes )
+                };
+                writeRecord( BinaryLog::Usage, fields );
+            }
+            if( usage.processUsageRecorded )
+            {
+                uint32_t fields[BinaryLog::FieldCount] =
+                {
+                    low( usage.peakRssGrowth ), high( usage.peakRssGrowth ),
+                    count( usage.minorFaults ),
+                    count( usage.majorFaults ),
+                    count( usage.voluntarySwitches ),
+                    count( usage.involuntarySwitches ),
+                    count( usage.descriptorsLeaked )
+                };
+                writeRecord( BinaryLog::ProcessUsage, fields );
+            }
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        // Writes the string the first time it is seen
+        uint32_t intern
+        (
+            const std::string& str
+        )
+        {
+            if( str.empty() )
+                return 0;
+
+            std::map<std::string, uint32_t>::const_iterator it = m_strings.find( str );
+            if( it != m_strings.end() )
+                return it->second;
+
+            uint32_t id = static_cast<uint32_t>( m_strings.size() + 1 );
+            m_strings.insert( std::make_pair( str, id ) );
+
+            BinaryLog::Record record;
+            std::memset( &record, 0, sizeof( record ) );
+            record.type = BinaryLog::String;
+            record.fields[0] = id;
+            record.fields[1] = count( str.size() );
+
+            // The record and its bytes are written in one go, so the type
+            // is the last thing to land
+            m_buffer.assign( reinterpret_cast<const char*>( &record ), sizeof( record ) );
+            m_buffer += str;
+            m_buffer.append( ( 4 - str.size() % 4 ) % 4, '\0' );
+            write( m_buffer.data(), m_buffer.size() );
+            return id;
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        void write
+        (
+            const char* data,
+            std::size_t size
+        )
+        {
+            if( m_file.isOpen() )
+                m_file.append( data, size );
+            else
+                m_config.stream().write( data, static_cast<std::streamsize>( size ) );
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        static uint32_t count
+        (
+            std::size_t value
+        )
+        {
+            return static_cast<uint32_t>( value );
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        static uint32_t low
+        (
+            std::size_t value
+        )
+        {
+            return static_cast<uint32_t>( value );
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        static uint32_t high
+        (
+            std::size_t value
+        )
+        {
+            return static_cast<uint32_t>( static_cast<uint64_t>( value ) >> 32 );
+        }
+
+    private:
+        const IReporterConfig& m_config;
+        MappedFile m_file;
+        std::map<std::string, uint32_t> m_strings;
+        std::string m_buffer;
+        Timer m_timer;
+    };
+
+    INTERNAL_CATCH_REGISTER_REPORTER( "binary", BinaryReporter )
+
+} // end namespace Catch
+
+#endif // TWOBLUECUBES_CATCH_REPORTER_BINARY_HPP_INCLUDED
@@ -0,0 +1,322 @@
+/*
+ *  catch_reporter_jsonl.hpp
+ *  Catch
+ *
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ *
+ */
+#ifndef TWOBLUECUBES_CATCH_REPORTER_JSONL_HPP_INCLUDED
+#define TWOBLUECUBES_CATCH_REPORTER_JSONL_HPP_INCLUDED
+
+#include "../internal/catch_capture.hpp"
+#include "../internal/catch_interfaces_reporter.h"
+#include "../internal/catch_jsonwriter.hpp"
+#include "../internal/catch_reporter_registrars.hpp"
+#include "../internal/catch_timer.hpp"
+
+#include <vector>
+
+namespace Catch
+{
+    // One JSON object per event, one per line. Every object has an "event"
+    // field; the ends of testing, groups, test cases and sections carry their
+    // counts and how long they took, in seconds - and, with --allocations, the
+    // heap allocations made by test cases and sections, and with --resources
+    // the process resources used by test cases. The stream is flushed
+    // as each test case ends, so the output can be consumed while the tests
+    // run
+    class JsonLinesReporter : public Catch::IReporter
+    {
+    public:
+        ///////////////////////////////////////////////////////////////////////////
+        JsonLinesReporter
+        (
+            const IReporterConfig& config
+        )
+        :   m_config( config )
+        {
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        static std::string getDescription
+        ()
+        {
+            return "Reports each event as a line of JSON (JSON Lines)";
+        }
+
+    private: // IReporter
+
+        ///////////////////////////////////////////////////////////////////////////
+        virtual void StartTesting
+        ()
+        {
+            m_json = JsonLineWriter( m_config.stream() );
+            m_testingTimer.restart();
+            m_json.startObject()
+                .writeField( "event", "testingStarted" );
+            if( !m_config.getName().empty() )
+                m_json.writeField( "name", m_config.getName() );
+            if( unsigned int rngSeed = m_config.getRngSeed() )
+                m_json.writeField( "rngSeed", static_cast<std::size_t>( rngSeed ) );
+            m_json.endObject();
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        virtual void EndTesting
+        (
+            std::size_t succeeded,
+            std::size_t failed
+        )
+        {
+            m_json.startObject()
+                .writeField( "event", "testingEnded" )
+                .writeField( "succeeded", succeeded )
+                .writeField( "failed", failed )
+                .writeField( "duration", m_testingTimer.getElapsedSeconds() )
+                .endObject();
+            m_config.stream().flush();
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        virtual void StartGroup
+        (
+            const std::string& groupName
+        )
+        {
+            m_groupTimer.restart();
+            m_json.startObject()
+                .writeField( "event", "groupStarted" )
+                .writeField( "name", groupName )
+                .endObject();
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        virtual void EndGroup
+        (
+            const std::string& groupName,
+            std::size_t succeeded,
+            std::size_t failed
+        )
+        {
+            m_json.startObject()
+                .writeField( "event", "groupEnded" )
+                .writeField( "name", groupName )
+                .writeField( "succeeded", succeeded )
+                .writeField( "failed", failed )
+                .writeField( "duration", m_groupTimer.getElapsedSeconds() )
+                .endObject();
+            m_config.stream().flush();
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        virtual void StartSection
+        (
+            const std::string& sectionName,
+            const std::string description
+        )
+        {
+            m_sectionTimers.push_back( Timer() );
+            m_json.startObject()
+                .writeField( "event", "sectionStarted" )
+                .writeField( "name", sectionName )
+                .writeField( "description", description )
+                .endObject();
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        virtual void EndSection
+        (
+            const std::string& sectionName,
+            std::size_t succeeded,
+            std::size_t failed,
+            const std::string& stdOut,
+            const std::string& stdErr,
+            const ResourceUsage& usage
+        )
+        {
+            double duration = 0;
+            if( !m_sectionTimers.empty() )
+            {
+                duration = m_sectionTimers.back().getElapsedSeconds();
+                m_sectionTimers.pop_back();
+            }
+            m_json.startObject()
+                .writeField( "event", "sectionEnded" )
+                .writeField( "name", sectionName )
+                .writeField( "succeeded", succeeded )
+                .writeField( "failed", failed )
+                .writeField( "duration", duration );
+            if( !stdOut.empty() )
+                m_json.writeField( "stdout", stdOut );
+            if( !stdErr.empty() )
+                m_json.writeField( "stderr", stdErr );
+            writeUsage( usage );
+            m_json.endObject();
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        // Timed where the combination ran, which may have been a worker
+        virtual void EndGeneratorCombination
+        (
+            std::size_t combination,
+            std::size_t succeeded,
+            std::size_t failed,
+            const ResourceUsage& usage
+        )
+        {
+            m_json.startObject()
+                .writeField( "event", "generatorCombinationEnded" )
+                .writeField( "combination", combination )
+                .writeField( "succeeded", succeeded )
+                .writeField( "failed", failed )
+                .writeField( "duration", static_cast<double>( usage.durationMicroseconds ) / 1000000.0 )
+                .writeField( "worker", usage.worker );
+            writeUsage( usage );
+            m_json.endObject();
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        virtual void StartTestCase
+        (
+            const Catch::TestCaseInfo& testInfo
+        )
+        {
+            m_testCaseTimer.restart();
+            m_sectionTimers.clear();
+            m_json.startObject()
+                .writeField( "event", "testCaseStarted" )
+                .writeField( "name", testInfo.getName() )
+                .writeField( "description", testInfo.getDescription() )
+                .writeField( "filename", testInfo.getFilename() )
+                .writeField( "line", testInfo.getLine() )
+                .endObject();
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        virtual void Result
+        (
+            const Catch::ResultInfo& resultInfo
+        )
+        {
+            if( !m_config.includeSuccessfulResults() && resultInfo.getResultType() == ResultWas::Ok )
+                return;
+
+            m_json.startObject()
+                .writeField( "event", "result" )
+                .writeField( "type", toString( resultInfo.getResultType() ) )
+                .writeField( "success", resultInfo.ok() )
+                .writeField( "filename", resultInfo.getFilename() )
+                .writeField( "line", resultInfo.getLine() )
+                .writeField( "macro", resultInfo.getTestMacroName() );
+            if( resultInfo.hasExpression() )
+                m_json.writeField( "expression", resultInfo.getExpression() )
+                    .writeField( "expanded", resultInfo.getExpandedExpression() );
+            if( resultInfo.hasMessage() )
+                m_json.writeField( "message", resultInfo.getMessage() );
+            m_json.endObject();
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        virtual void EndTestCase
+        (
+            const Catch::TestCaseInfo& testInfo,
+            std::size_t succeeded,
+            std::size_t failed,
+            const std::string& stdOut,
+            const std::string& stdErr,
+            const ResourceUsage& usage
+        )
+        {
+            m_json.startObject()
+                .writeField( "event", "testCaseEnded" )
+                .writeField( "name", testInfo.getName() )
+                .writeField( "succeeded", succeeded )
+                .writeField( "failed", failed )
+                .writeField( "duration", m_testCaseTimer.getElapsedSeconds() );
+            if( !stdOut.empty() )
+                m_json.writeField( "stdout", stdOut );
+            if( !stdErr.empty() )
+                m_json.writeField( "stderr", stdErr );
+            writeUsage( usage );
+            m_json.endObject();
+            m_config.stream().flush();
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        // Durations are in seconds, like the rest
+        virtual void TestCaseRepeated
+        (
+            const RepeatStats& stats
+        )
+        {
+            m_json.startObject()
+                .writeField( "event", "testCaseRepeated" )
+                .writeField( "name", stats.name )
+                .writeField( "runs", stats.runs )
+                .writeField( "failedRuns", stats.getFailedRuns() )
+                .writeField( "passRate", stats.getPassRate() )
+                .writeField( "minDuration", static_cast<double>( stats.minMicroseconds ) / 1000000.0 )
+                .writeField( "medianDuration", static_cast<double>( stats.medianMicroseconds ) / 1000000.0 )
+                .writeField( "maxDuration", static_cast<double>( stats.maxMicroseconds ) / 1000000.0 )
+                .writeField( "failedRepetitions", stats.failedRepetitions )
+                .writeField( "failedRngSeeds", stats.failedRngSeeds )
+                .endObject();
+        }
+
+    private:
+
+        ///////////////////////////////////////////////////////////////////////////
+        void writeUsage
+        (
+            const ResourceUsage& usage
+        )
+        {
+            if( usage.allocationsCounted )
+                m_json.writeField( "allocations", usage.allocations )
+                    .writeField( "deallocations", usage.deallocations )
+                    .writeField( "bytesAllocated", usage.bytesAllocated )
+                    .writeField( "bytesFreed", usage.bytesFreed )
+                    .writeField( "peakBytes", usage.peakBytes );
+            if( usage.processUsageRecorded )
+                m_json.writeField( "peakRssGrowth", usage.peakRssGrowth )
+                    .writeField( "minorFaults", usage.minorFaults )
+                    .writeField( "majorFaults", usage.majorFaults )
+                    .writeField( "voluntarySwitches", usage.voluntarySwitches )
+                    .writeField( "involuntarySwitches", usage.involuntarySwitches )
+                    .writeField( "descriptorsLeaked", usage.descriptorsLeaked );
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        static const char* toString
+        (
+            ResultWas::OfType resultType
+        )
+        {
+            switch( resultType )
+            {
+                case ResultWas::Ok:                     return "ok";
+                case ResultWas::Info:                   return "info";
+                case ResultWas::Warning:                return "warning";
+                case ResultWas::ExpressionFailed:       return "expressionFailed";
+                case ResultWas::ExplicitFailure:        return "explicitFailure";
+                case ResultWas::ThrewException:         return "threwException";
+                case ResultWas::DidntThrowException:    return "didntThrowException";
+                default:                                return "unknown";
+            }
+        }
+
+    private:
+        const IReporterConfig& m_config;
+        JsonLineWriter m_json;
+        Timer m_testingTimer;
+        Timer m_groupTimer;
+        Timer m_testCaseTimer;
+        std::vector<Timer> m_sectionTimers;
+    };
+
+    INTERNAL_CATCH_REGISTER_REPORTER( "jsonl", JsonLinesReporter )
+
+} // end namespace Catch
+
+#endif // TWOBLUECUBES_CATCH_REPORTER_JSONL_HPP_INCLUDED
@@ -106,7 +106,12 @@ namespace Catch
         {
         }
 
-        virtual void EndSection( const std::string& /*sectionName*/, std::size_t /*succeeded*/, std::size_t /*failed*/ )
+        virtual void EndSection( const std::string& /*sectionName*/, std::size_t /*succeeded*/, std::size_t /*failed*/, const std::string& /*stdOut*/, const std::string& /*stdErr*/, const ResourceUsage& /*usage*/ )
+        {
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        virtual void EndGeneratorCombination( std::size_t /*combination*/, std::size_t /*succeeded*/, std::size_t /*failed*/, const ResourceUsage& /*usage*/ )
         {
         }
         
@@ -166,7 +171,7 @@ namespace Catch
         }
         
         ///////////////////////////////////////////////////////////////////////////
-        virtual void EndTestCase( const Catch::TestCaseInfo&, std::size_t /* succeeded */, std::size_t /* failed */, const std::string& stdOut, const std::string& stdErr )
+        virtual void EndTestCase( const Catch::TestCaseInfo&, std::size_t /* succeeded */, std::size_t /* failed */, const std::string& stdOut, const std::string& stdErr, const ResourceUsage& /*usage*/ )
         {
             if( !stdOut.empty() )
                 m_stdOut << stdOut << "\n";
@@ -174,6 +179,12 @@ namespace Catch
                 m_stdErr << stdErr << "\n";
         }    
 
+        ///////////////////////////////////////////////////////////////////////////
+        // JUnit has nowhere for these - each repetition is a testsuite of its own
+        virtual void TestCaseRepeated( const RepeatStats& /*stats*/ )
+        {
+        }
+
         ///////////////////////////////////////////////////////////////////////////
         virtual void EndTesting( std::size_t /* succeeded */, std::size_t /* failed */ )
         {
@@ -197,6 +208,14 @@ namespace Catch
                     xml.writeAttribute( "hostname", "tbd" );
                     xml.writeAttribute( "time", "tbd" );
                     xml.writeAttribute( "timestamp", "tbd" );
+
+                    if( unsigned int rngSeed = m_config.getRngSeed() )
+                    {
+                        XmlWriter::ScopedElement properties = xml.scopedElement( "properties" );
+                        xml.scopedElement( "property" )
+                            .writeAttribute( "name", "random-seed" )
+                            .writeAttribute( "value", rngSeed );
+                    }
                     
                     OutputTestCases( xml, *it );
                 }
@@ -0,0 +1,344 @@
+/*
+ *  catch_reporter_junit_streaming.hpp
+ *  Catch
+ *
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ *
+ */
+#ifndef TWOBLUECUBES_CATCH_REPORTER_JUNIT_STREAMING_HPP_INCLUDED
+#define TWOBLUECUBES_CATCH_REPORTER_JUNIT_STREAMING_HPP_INCLUDED
+
+#include "../internal/catch_capture.hpp"
+#include "../internal/catch_interfaces_reporter.h"
+#include "../internal/catch_reporter_registrars.hpp"
+#include "../internal/catch_xmlwriter.hpp"
+
+#include <iomanip>
+
+namespace Catch
+{
+    // Writes the same elements as the junit reporter, but as each test case
+    // finishes, so memory use doesn't grow with the run and a crash only loses
+    // the test case in flight.
+    // A testsuite's counts aren't known until it ends. If the output can be
+    // seeked (e.g. with -o) they are written as fixed width placeholders then
+    // filled in. Otherwise they go in a trailing testsuite-summary element
+    class StreamingJunitReporter : public Catch::IReporter
+    {
+        enum { CountWidth = 10 };
+
+    public:
+        ///////////////////////////////////////////////////////////////////////////
+        StreamingJunitReporter
+        (
+            const IReporterConfig& config
+        )
+        :   m_config( config ),
+            m_inSuite( false ),
+            m_inTestCase( false ),
+            m_countsPos( -1 ),
+            m_errorsCount( 0 ),
+            m_failuresCount( 0 )
+        {
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        static std::string getDescription
+        ()
+        {
+            return "Reports test results in the junit format, writing each test case as it finishes";
+        }
+
+    private: // IReporter
+
+        ///////////////////////////////////////////////////////////////////////////
+        virtual void StartTesting
+        ()
+        {
+            m_xml = XmlWriter( m_config.stream() );
+            m_xml.startElement( "testsuites" );
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        virtual void EndTesting
+        (
+            std::size_t succeeded,
+            std::size_t failed
+        )
+        {
+            // Test cases run outside of any group (e.g. by an embedded runner)
+            // were collected into an implicit suite
+            if( m_inSuite )
+                endSuite( succeeded + failed );
+            m_xml.endElement();
+            m_config.stream().flush();
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        virtual void StartGroup
+        (
+            const std::string& groupName
+        )
+        {
+            if( m_inSuite )
+                endSuite( 0 );
+            startSuite( groupName );
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        virtual void EndGroup
+        (
+            const std::string&,
+            std::size_t succeeded,
+            std::size_t failed
+        )
+        {
+            if( m_inSuite )
+                endSuite( succeeded + failed );
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        virtual void StartSection
+        (
+            const std::string&,
+            const std::string
+        )
+        {
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        virtual void EndSection
+        (
+            const std::string&,
+            std::size_t,
+            std::size_t,
+            const std::string&,
+            const std::string&,
+            const ResourceUsage&
+        )
+        {
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        virtual void EndGeneratorCombination
+        (
+            std::size_t,
+            std::size_t,
+            std::size_t,
+            const ResourceUsage&
+        )
+        {
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        virtual void StartTestCase
+        (
+            const Catch::TestCaseInfo& testInfo
+        )
+        {
+            if( !m_inSuite )
+                startSuite( "AllTests" );
+
+            m_xml.writeBlankLine();
+            m_xml.writeComment( "Test case" );
+            m_xml.startElement( "testcase" )
+                .writeAttribute( "name", testInfo.getName() )
+                .writeAttribute( "time", "tbd" );
+            m_inTestCase = true;
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        virtual void Result
+        (
+            const Catch::ResultInfo& resultInfo
+        )
+        {
+            if( !m_inTestCase )
+                return;
+
+            std::string element;
+            switch( resultInfo.getResultType() )
+            {
+                case ResultWas::ThrewException:
+                    element = "error";
+                    m_errorsCount++;
+                    break;
+                case ResultWas::Info:
+                    element = "info"; // !TBD ?
+                    break;
+                case ResultWas::Warning:
+                    element = "warning"; // !TBD ?
+                    break;
+                case ResultWas::ExplicitFailure:
+                case ResultWas::ExpressionFailed:
+                    element = "failure";
+                    m_failuresCount++;
+                    break;
+                case ResultWas::Ok:
+                    // The junit format has nowhere to put successes
+                    return;
+                default:
+                    element = "unknown";
+                    break;
+            }
+
+            std::ostringstream oss;
+            if( !resultInfo.getMessage().empty() )
+                oss << resultInfo.getMessage() << " at ";
+            oss << resultInfo.getFilename() << ":" << resultInfo.getLine();
+
+            m_xml.scopedElement( element )
+                .writeAttribute( "message", resultInfo.getExpandedExpression() )
+                .writeAttribute( "type", resultInfo.getTestMacroName() )
+                .writeText( oss.str() );
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        virtual void EndTestCase
+        (
+            const Catch::TestCaseInfo&,
+            std::size_t,
+            std::size_t,
+            const std::string& stdOut,
+            const std::string& stdErr,
+            const ResourceUsage& /*usage*/
+        )
+        {
+            if( !m_inTestCase )
+                return;
+            if( !trim( stdOut ).empty() )
+                m_xml.scopedElement( "system-out" ).writeText( trim( stdOut ) );
+            if( !trim( stdErr ).empty() )
+                m_xml.scopedElement( "system-err" ).writeText( trim( stdErr ) );
+            m_xml.endElement();
+            m_inTestCase = false;
+
+            m_config.stream().flush();
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        // JUnit has nowhere for these - each repetition is a testsuite of its own
+        virtual void TestCaseRepeated
+        (
+            const RepeatStats& /*stats*/
+        )
+        {
+        }
+
+    private:
+
+        ///////////////////////////////////////////////////////////////////////////
+        void startSuite
+        (
+            const std::string& name
+        )
+        {
+            std::ostream& os = m_config.stream();
+
+            m_errorsCount = 0;
+            m_failuresCount = 0;
+            m_xml.startElement( "testsuite" )
+                .writeAttribute( "name", name );
+
+            // The placeholders are zero padded so they can be overwritten in place
+            // with any count, and still read as that number
+            m_countsPos = os.tellp();
+            if( m_countsPos != std::streampos( -1 ) )
+            {
+                std::string placeholder( CountWidth, '0' );
+                m_xml.writeAttribute( "errors", placeholder )
+                    .writeAttribute( "failures", placeholder )
+                    .writeAttribute( "tests", placeholder );
+            }
+            m_xml.writeAttribute( "hostname", "tbd" )
+                .writeAttribute( "time", "tbd" )
+                .writeAttribute( "timestamp", "tbd" );
+
+            if( unsigned int rngSeed = m_config.getRngSeed() )
+            {
+                XmlWriter::ScopedElement properties = m_xml.scopedElement( "properties" );
+                m_xml.scopedElement( "property" )
+                    .writeAttribute( "name", "random-seed" )
+                    .writeAttribute( "value", rngSeed );
+            }
+            m_inSuite = true;
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        void endSuite
+        (
+            std::size_t testsCount
+        )
+        {
+            std::ostream& os = m_config.stream();
+
+            if( m_inTestCase )
+            {
+                m_xml.endElement();
+                m_inTestCase = false;
+            }
+            if( !fixUpCounts( os, testsCount ) )
+            {
+                m_xml.writeBlankLine();
+                m_xml.scopedElement( "testsuite-summary" )
+                    .writeAttribute( "errors", m_errorsCount )
+                    .writeAttribute( "failures", m_failuresCount )
+                    .writeAttribute( "tests", testsCount );
+            }
+            m_xml.endElement();
+            m_inSuite = false;
+            os.flush();
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        bool fixUpCounts
+        (
+            std::ostream& os,
+            std::size_t testsCount
+        )
+        {
+            if( m_countsPos == std::streampos( -1 ) )
+                return false;
+
+            std::streampos endPos = os.tellp();
+            if( endPos == std::streampos( -1 ) || !os.seekp( m_countsPos ) )
+            {
+                os.clear();
+                return false;
+            }
+            writeCount( os, "errors", m_errorsCount );
+            writeCount( os, "failures", m_failuresCount );
+            writeCount( os, "tests", testsCount );
+            os.seekp( endPos );
+            return true;
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        static void writeCount
+        (
+            std::ostream& os,
+            const std::string& name,
+            std::size_t count
+        )
+        {
+            os  << " " << name << "=\""
+                << std::setw( CountWidth ) << std::setfill( '0' ) << count
+                << std::setfill( ' ' ) << "\"";
+        }
+
+    private:
+        const IReporterConfig& m_config;
+        XmlWriter m_xml;
+        bool m_inSuite;
+        bool m_inTestCase;
+        std::streampos m_countsPos;
+        std::size_t m_errorsCount;
+        std::size_t m_failuresCount;
+    };
+
+    INTERNAL_CATCH_REGISTER_REPORTER( "junit-streaming", StreamingJunitReporter )
+
+} // end namespace Catch
+
+#endif // TWOBLUECUBES_CATCH_REPORTER_JUNIT_STREAMING_HPP_INCLUDED
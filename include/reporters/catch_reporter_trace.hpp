@@ -0,0 +1,286 @@
+/*
+ *  catch_reporter_trace.hpp
+ *  Catch
+ *
+ *  Distributed under the Boost Software License, Version 1.0. (See accompanying
+ *  file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+ *
+ */
+#ifndef TWOBLUECUBES_CATCH_REPORTER_TRACE_HPP_INCLUDED
+#define TWOBLUECUBES_CATCH_REPORTER_TRACE_HPP_INCLUDED
+
+#include "../internal/catch_interfaces_reporter.h"
+#include "../internal/catch_jsonwriter.hpp"
+#include "../internal/catch_reporter_registrars.hpp"
+#include "../internal/catch_test_case_info.hpp"
+#include "../internal/catch_timer.hpp"
+
+#include <set>
+#include <sstream>
+#include <vector>
+
+namespace Catch
+{
+    // Writes the run as a timeline, in the Trace Event format that
+    // chrome://tracing and Perfetto load. Groups, test cases, sections and
+    // generator combinations are complete ("X") events, on a thread per
+    // worker: 0 for this process, and from 1 for each worker process. Spans
+    // are timed where they ran, so those from workers are in the right place
+    // even though they are reported later. The format doesn't need the
+    // array to be closed, so the trace of a run that is cut short still loads
+    class TraceReporter : public Catch::IReporter
+    {
+        struct Span
+        {
+            ///////////////////////////////////////////////////////////////////
+            Span
+            (
+                const std::string& name_,
+                uint64_t start_
+            )
+            :   name( name_ ),
+                start( start_ )
+            {
+            }
+
+            std::string name;
+            uint64_t start;
+        };
+
+    public:
+        ///////////////////////////////////////////////////////////////////////////
+        TraceReporter
+        (
+            const IReporterConfig& config
+        )
+        :   m_config( config ),
+            m_start( 0 ),
+            m_isFirstEvent( true )
+        {
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        static std::string getDescription
+        ()
+        {
+            return "Reports a timeline of the run as trace events, for chrome://tracing or Perfetto";
+        }
+
+    private: // IReporter
+
+        ///////////////////////////////////////////////////////////////////////////
+        virtual void StartTesting
+        ()
+        {
+            m_json = JsonLineWriter( m_config.stream() );
+            m_start = getCurrentMicroseconds();
+            m_isFirstEvent = true;
+            m_workers.clear();
+            m_config.stream() << "[\n";
+            // The seed goes with the process's name, so a trace says how to
+            // run its tests in the same order again
+            JsonLineWriter& metadata = startEvent( "process_name", "M", 0 )
+                .startObjectField( "args" )
+                    .writeField( "name", m_config.getName().empty() ? std::string( "Catch" ) : m_config.getName() );
+            if( unsigned int rngSeed = m_config.getRngSeed() )
+                metadata.writeField( "rngSeed", static_cast<std::size_t>( rngSeed ) );
+            metadata.endObjectField()
+                .endObject();
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        virtual void EndTesting
+        (
+            std::size_t /*succeeded*/,
+            std::size_t /*failed*/
+        )
+        {
+            for( std::set<std::size_t>::const_iterator it = m_workers.begin(); it != m_workers.end(); ++it )
+            {
+                std::ostringstream oss;
+                if( *it == 0 )
+                    oss << "main";
+                else
+                    oss << "worker " << *it;
+                startEvent( "thread_name", "M", *it )
+                    .startObjectField( "args" )
+                        .writeField( "name", oss.str() )
+                    .endObjectField()
+                    .endObject();
+            }
+            m_config.stream() << "]\n";
+            m_config.stream().flush();
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        virtual void StartGroup
+        (
+            const std::string& groupName
+        )
+        {
+            m_spans.push_back( Span( groupName, getCurrentMicroseconds() ) );
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        virtual void EndGroup
+        (
+            const std::string& /*groupName*/,
+            std::size_t succeeded,
+            std::size_t failed
+        )
+        {
+            endSpan( "group", succeeded, failed, ResourceUsage() );
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        virtual void StartSection
+        (
+            const std::string& sectionName,
+            const std::string /*description*/
+        )
+        {
+            m_spans.push_back( Span( sectionName, getCurrentMicroseconds() ) );
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        virtual void EndSection
+        (
+            const std::string& /*sectionName*/,
+            std::size_t succeeded,
+            std::size_t failed,
+            const std::string& /*stdOut*/,
+            const std::string& /*stdErr*/,
+            const ResourceUsage& usage
+        )
+        {
+            endSpan( "section", succeeded, failed, usage );
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        virtual void EndGeneratorCombination
+        (
+            std::size_t combination,
+            std::size_t succeeded,
+            std::size_t failed,
+            const ResourceUsage& usage
+        )
+        {
+            std::ostringstream oss;
+            oss << "combination " << combination;
+            m_spans.push_back( Span( oss.str(), getCurrentMicroseconds() ) );
+            endSpan( "generator", succeeded, failed, usage );
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        virtual void StartTestCase
+        (
+            const Catch::TestCaseInfo& testInfo
+        )
+        {
+            m_spans.push_back( Span( testInfo.getName(), getCurrentMicroseconds() ) );
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        virtual void Result
+        (
+            const Catch::ResultInfo& /*resultInfo*/
+        )
+        {
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        virtual void EndTestCase
+        (
+            const Catch::TestCaseInfo& /*testInfo*/,
+            std::size_t succeeded,
+            std::size_t failed,
+            const std::string& /*stdOut*/,
+            const std::string& /*stdErr*/,
+            const ResourceUsage& usage
+        )
+        {
+            endSpan( "testCase", succeeded, failed, usage );
+            m_config.stream().flush();
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        // Each repetition is already on the timeline, as a group
+        virtual void TestCaseRepeated
+        (
+            const RepeatStats& /*stats*/
+        )
+        {
+        }
+
+    private:
+
+        ///////////////////////////////////////////////////////////////////////////
+        // Spans that weren't timed where they ran (such as those converted
+        // from a binary log) are timed here
+        void endSpan
+        (
+            const char* category,
+            std::size_t succeeded,
+            std::size_t failed,
+            const ResourceUsage& usage
+        )
+        {
+            if( m_spans.empty() )
+                return;
+            const Span& span = m_spans.back();
+            uint64_t start = usage.timed ? usage.startMicroseconds : span.start;
+            uint64_t duration = usage.timed ? usage.durationMicroseconds : getCurrentMicroseconds() - span.start;
+            startEvent( span.name, "X", usage.worker )
+                .writeField( "cat", category )
+                .writeField( "ts", toSize( start > m_start ? start - m_start : 0 ) )
+                .writeField( "dur", toSize( duration ) )
+                .startObjectField( "args" )
+                    .writeField( "succeeded", succeeded )
+                    .writeField( "failed", failed )
+                .endObjectField()
+                .endObject();
+            m_spans.pop_back();
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        JsonLineWriter& startEvent
+        (
+            const std::string& name,
+            const char* phase,
+            std::size_t worker
+        )
+        {
+            if( !m_isFirstEvent )
+                m_config.stream() << ',';
+            m_isFirstEvent = false;
+            m_workers.insert( worker );
+            return m_json.startObject()
+                .writeField( "name", name )
+                .writeField( "ph", phase )
+                .writeField( "pid", static_cast<std::size_t>( 1 ) )
+                .writeField( "tid", worker );
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        static std::size_t toSize
+        (
+            uint64_t value
+        )
+        {
+            return static_cast<std::size_t>( value );
+        }
+
+    private:
+        const IReporterConfig& m_config;
+        JsonLineWriter m_json;
+        uint64_t m_start;
+        bool m_isFirstEvent;
+        std::vector<Span> m_spans;
+        std::set<std::size_t> m_workers;
+    };
+
+    INTERNAL_CATCH_REGISTER_REPORTER( "trace", TraceReporter )
+
+} // end namespace Catch
+
+#endif // TWOBLUECUBES_CATCH_REPORTER_TRACE_HPP_INCLUDED
@@ -48,6 +48,8 @@ namespace Catch
             m_xml.startElement( "Catch" );
             if( !m_config.getName().empty() )
                 m_xml.writeAttribute( "name", m_config.getName() );
+            if( unsigned int rngSeed = m_config.getRngSeed() )
+                m_xml.writeAttribute( "rng-seed", rngSeed );
         }
         
         ///////////////////////////////////////////////////////////////////////////
@@ -96,13 +98,18 @@ namespace Catch
         }
 
         ///////////////////////////////////////////////////////////////////////////
-        virtual void EndSection( const std::string& /*sectionName*/, std::size_t succeeded, std::size_t failed )
+        virtual void EndSection( const std::string& /*sectionName*/, std::size_t succeeded, std::size_t failed, const std::string& /*stdOut*/, const std::string& /*stdErr*/, const ResourceUsage& /*usage*/ )
         {
             m_xml.scopedElement( "OverallResults" )
                 .writeAttribute( "successes", succeeded )
                 .writeAttribute( "failures", failed );            
             m_xml.endElement();
         }
+
+        ///////////////////////////////////////////////////////////////////////////
+        virtual void EndGeneratorCombination( std::size_t /*combination*/, std::size_t /*succeeded*/, std::size_t /*failed*/, const ResourceUsage& /*usage*/ )
+        {
+        }
         
         ///////////////////////////////////////////////////////////////////////////
         virtual void StartTestCase( const Catch::TestCaseInfo& testInfo )
@@ -161,11 +168,33 @@ namespace Catch
         }
         
         ///////////////////////////////////////////////////////////////////////////
-        virtual void EndTestCase( const Catch::TestCaseInfo&, std::size_t /* succeeded */, std::size_t /* failed */, const std::string& /*stdOut*/, const std::string& /*stdErr*/ )
+        virtual void EndTestCase( const Catch::TestCaseInfo&, std::size_t /* succeeded */, std::size_t /* failed */, const std::string& /*stdOut*/, const std::string& /*stdErr*/, const ResourceUsage& /*usage*/ )
         {
             m_xml.scopedElement( "OverallResult" ).writeAttribute( "success", m_currentTestSuccess );
             m_xml.endElement();
         }    
+
+        ///////////////////////////////////////////////////////////////////////////
+        virtual void TestCaseRepeated( const RepeatStats& stats )
+        {
+            m_xml.startElement( "RepeatedTestCase" )
+                .writeAttribute( "name", stats.name )
+                .writeAttribute( "runs", stats.runs )
+                .writeAttribute( "failures", stats.getFailedRuns() )
+                .writeAttribute( "passRate", stats.getPassRate() )
+                .writeAttribute( "minMicroseconds", stats.minMicroseconds )
+                .writeAttribute( "medianMicroseconds", stats.medianMicroseconds )
+                .writeAttribute( "maxMicroseconds", stats.maxMicroseconds );
+            for( std::size_t i = 0; i < stats.getFailedRuns(); ++i )
+            {
+                m_xml.startElement( "FailedRepetition" )
+                    .writeAttribute( "repetition", stats.failedRepetitions[i] );
+                if( stats.failedRngSeeds[i] != 0 )
+                    m_xml.writeAttribute( "rng-seed", stats.failedRngSeeds[i] );
+                m_xml.endElement();
+            }
+            m_xml.endElement();
+        }
                 
     private:
         const IReporterConfig& m_config;
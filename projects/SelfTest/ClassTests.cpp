@@ -59,3 +59,78 @@ namespace Inner
         REQUIRE( m_a == 2 );        
     }
 }
+
+// Counted by ResettableFixture, for meta/Misc/FixturePool
+int resettableFixtureConstructions = 0;
+int resettableFixtureResets = 0;
+
+// Constructed once, then reset between invocations (one for each section)
+struct ResettableFixture
+{
+    ResettableFixture() : m_a( 1 )
+    {
+        ++resettableFixtureConstructions;
+    }
+
+    void reset()
+    {
+        m_a = 1;
+        ++resettableFixtureResets;
+    }
+
+    int m_a;
+};
+
+TEST_CASE_METHOD( ResettableFixture, "./succeeding/Fixture/resetCase", "A method based test run whose fixture is reset, not reconstructed" )
+{
+    REQUIRE( m_a == 1 );
+    m_a = 2;
+
+    SECTION( "first", "" )
+    {
+        REQUIRE( m_a == 2 );
+    }
+    SECTION( "second", "" )
+    {
+        REQUIRE( m_a == 2 );
+    }
+    SECTION( "third", "" )
+    {
+        REQUIRE( m_a == 2 );
+    }
+}
+
+// None of these declare a void reset() of their own
+struct ResetMemberFixture
+{
+    int reset;
+};
+
+struct ResetWithArgumentFixture
+{
+    void reset( int ) {}
+};
+
+struct InheritedResetFixture : ResettableFixture
+{
+};
+
+struct SmartPointerFixture : std::auto_ptr<int>
+{
+};
+
+TEST_CASE( "./succeeding/Fixture/hasReset", "Only fixture classes that declare a void reset() are reset" )
+{
+    bool resettableHasReset = Catch::HasReset<ResettableFixture>::value;
+    bool fixtureHasReset = Catch::HasReset<Fixture>::value;
+    bool memberHasReset = Catch::HasReset<ResetMemberFixture>::value;
+    bool argumentHasReset = Catch::HasReset<ResetWithArgumentFixture>::value;
+    bool inheritedHasReset = Catch::HasReset<InheritedResetFixture>::value;
+    bool smartPointerHasReset = Catch::HasReset<SmartPointerFixture>::value;
+    REQUIRE( resettableHasReset );
+    REQUIRE_FALSE( fixtureHasReset );
+    REQUIRE_FALSE( memberHasReset );
+    REQUIRE_FALSE( argumentHasReset );
+    REQUIRE_FALSE( inheritedHasReset );
+    REQUIRE_FALSE( smartPointerHasReset );
+}
@@ -27,3 +27,154 @@ TEST_CASE( "./succeeding/generators/1", "Generators over two ranges" )
     REQUIRE( multiply( i, 2 ) == i*2 );
     REQUIRE( multiply( j, 2 ) == j*2 );
 }
+
+TEST_CASE( "./succeeding/generators/range", "Strided ranges are computed on demand" )
+{
+    using namespace Catch::Generators;
+    
+    int i = GENERATE( range( 0, 100, 25 ) );
+    double d = GENERATE( range( 1.0, 0.0, -0.25 ) );
+    
+    REQUIRE( ( i % 25 ) == 0 );
+    REQUIRE( i <= 100 );
+    REQUIRE( d >= 0.0 );
+    REQUIRE( d <= 1.0 );
+}
+
+TEST_CASE( "./succeeding/generators/random", "Seeded random values stay within their bounds" )
+{
+    using namespace Catch::Generators;
+    
+    int i = GENERATE( random( -10, 10, 20, 1234 ) );
+    
+    REQUIRE( i >= -10 );
+    REQUIRE( i <= 10 );
+}
+
+TEST_CASE( "./succeeding/generators/bounds", "Ranges that span most of their type, and fractional steps, keep their ends" )
+{
+    const int intMin = (std::numeric_limits<int>::min)();
+    const int intMax = (std::numeric_limits<int>::max)();
+
+    Catch::RangeGenerator<int> wide( intMin, intMax, 1 << 30 );
+    REQUIRE( wide.size() == 4 );
+    CHECK( wide.getValue( 0 ) == intMin );
+    CHECK( wide.getValue( 1 ) == -( 1 << 30 ) );
+    CHECK( wide.getValue( 2 ) == 0 );
+    CHECK( wide.getValue( 3 ) == 1 << 30 );
+
+    Catch::RangeGenerator<int> down( intMax, intMin, -( 1 << 30 ) );
+    REQUIRE( down.size() == 4 );
+    CHECK( down.getValue( 3 ) == -( 1 << 30 ) - 1 );
+
+    Catch::RangeGenerator<double> tenths( 0.0, 0.3, 0.1 );
+    REQUIRE( tenths.size() == 4 );
+    CHECK( tenths.getValue( 1 ) == Approx( 0.1 ) );
+    CHECK( tenths.getValue( 2 ) == Approx( 0.2 ) );
+    CHECK( tenths.getValue( 3 ) == 0.3 );
+
+    Catch::RangeGenerator<double> pastTheEnd( 0.0, 0.35, 0.1 );
+    CHECK( pastTheEnd.size() == 4 );
+
+    // Nearly a whole step short of the end, which is too far to round up
+    Catch::RangeGenerator<float> justShort( 0.0f, 100000.9f, 1.0f );
+    REQUIRE( justShort.size() == 100001 );
+    CHECK( justShort.getValue( 100000 ) == 100000.0f );
+
+    CHECK_THROWS_AS( Catch::RangeGenerator<double>( 0.0, 1e30, 1e-30 ), std::domain_error );
+
+    typedef Catch::ProductGenerator<int, int> IntPairs;
+    CHECK_THROWS_AS( IntPairs( new Catch::RangeGenerator<int>( intMin, intMax, 1 ), new Catch::RangeGenerator<int>( intMin, intMax, 1 ) ), std::domain_error );
+
+    Catch::RandomGenerator<int> random( -2000000000, 2000000000, 100, 1234 );
+    REQUIRE( random.size() == 100 );
+    int outOfRange = 0;
+    int negatives = 0;
+    for( std::size_t i = 0; i < random.size(); ++i )
+    {
+        int value = random.getValue( i );
+        if( value < -2000000000 || value > 2000000000 )
+            ++outOfRange;
+        if( value < 0 )
+            ++negatives;
+    }
+    CHECK( outOfRange == 0 );
+    CHECK( negatives > 0 );
+    CHECK( negatives < 100 );
+}
+
+namespace
+{
+    bool isEven( int i )
+    {
+        return i % 2 == 0;
+    }
+    int square( int i )
+    {
+        return i*i;
+    }
+}
+
+TEST_CASE( "./succeeding/generators/combinations", "Cartesian products, zips, maps and filters of generators" )
+{
+    using namespace Catch::Generators;
+    
+    std::pair<int, int> p = GENERATE( product( between( 1, 3 ), values( 10, 20 ) ) );
+    std::pair<int, int> z = GENERATE( zip( between( 1, 4 ), map( between( 1, 10 ), &square ) ) );
+    int even = GENERATE( filter( between( 1, 10 ), &isEven ) );
+    
+    REQUIRE( p.first >= 1 );
+    REQUIRE( p.first <= 3 );
+    REQUIRE( ( p.second % 10 ) == 0 );
+    REQUIRE( z.second == z.first*z.first );
+    REQUIRE( isEven( even ) );
+}
+
+PROPERTY( "./succeeding/property/string reverse", "Reversing a string twice gives the original", std::string, s )
+{
+    std::string reversed( s.rbegin(), s.rend() );
+    REQUIRE( std::string( reversed.rbegin(), reversed.rend() ) == s );
+}
+
+PROPERTY( "./succeeding/property/vector size", "Appending to a vector grows it by one", std::vector<int>, v )
+{
+    std::vector<int> appended( v );
+    appended.push_back( 42 );
+    REQUIRE( appended.size() == v.size() + 1 );
+}
+
+PROPERTY( "./failing/property/int", "Shrinks to the smallest int that breaks the property", int, i )
+{
+    REQUIRE( i < 100 );
+}
+
+PROPERTY( "./failing/property/vector", "Shrinks to the shortest vector that breaks the property", std::vector<int>, v )
+{
+    CHECK( v.size() < 3 );
+}
+
+// Only run by meta/Misc/PropertySections
+PROPERTY( "./sections/property/int", "Has a SECTION, which a property can't", int, i )
+{
+    SECTION( "non-negative", "" )
+    {
+        REQUIRE( i >= 0 );
+    }
+}
+
+TEST_CASE( "./succeeding/property/shrinking doubles", "Doubles shrink towards zero, dropping any fraction, even when too big for a long" )
+{
+    std::vector<double> candidates;
+    Catch::Arbitrary<double>::shrink( 2.5, candidates );
+    REQUIRE( candidates.size() == 3 );
+    CHECK( candidates[0] == 0.0 );
+    CHECK( candidates[1] == 2.0 );
+    CHECK( candidates[2] == 1.25 );
+
+    candidates.clear();
+    Catch::Arbitrary<double>::shrink( -1e300, candidates );
+    REQUIRE( candidates.size() == 3 );
+    CHECK( candidates[0] == 0.0 );
+    CHECK( candidates[1] == -5e299 );
+    CHECK( candidates[2] == 1e300 );
+}
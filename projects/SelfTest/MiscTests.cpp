@@ -11,7 +11,11 @@
  */
 
 #include "catch.hpp"
+#include <cstdio>
 #include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <vector>
 
 TEST_CASE( "./succeeding/Misc/Sections", "random SECTION tests" )
 {
@@ -103,6 +107,485 @@ TEST_CASE( "./succeeding/Misc/stdout,stderr", "Sends stuff to stdout and stderr"
     std::cerr << "An error";
 }
 
+// Only run (by meta/Misc/DescriptorCapture) with --capture fd
+TEST_CASE( "./captured/Misc/printf,fputs", "Sends stuff to stdout and stderr through C stdio" )
+{
+    std::printf( "Some information from printf" );
+    std::fputs( "An error from fputs", stderr );
+}
+
+// Only run by meta/Misc/Allocations, with allocations counted
+TEST_CASE( "./allocations/Misc/Sections", "Frees in one section what the test case allocated, allocates in another, and leaks in a third" )
+{
+    std::auto_ptr<int> outer( new int( 1 ) );
+    SECTION( "frees", "" )
+    {
+        outer.reset();
+    }
+    SECTION( "allocates", "" )
+    {
+        std::vector<char> v( 10 );
+        REQUIRE( v.size() == 10 );
+    }
+    SECTION( "leaks", "" )
+    {
+        static std::auto_ptr<int> leaked;
+        leaked.reset( new int( 42 ) );
+    }
+}
+
+namespace
+{
+    class Deleter : public Catch::IRunnable
+    {
+    public:
+        explicit Deleter( int* block ) : m_block( block ) {}
+
+        virtual void run()
+        {
+            delete m_block;
+        }
+
+    private:
+        int* m_block;
+    };
+}
+
+// Only run by meta/Misc/Allocations, with allocations counted
+TEST_CASE( "./allocations/Misc/freed elsewhere", "Frees an allocation on another thread, then throws an exception whose message is freed as it ends the test case" )
+{
+    Deleter deleter( new int( 1 ) );
+    Catch::Thread thread;
+    REQUIRE( thread.start( deleter ) );
+    thread.join();
+    throw std::runtime_error( "a message that is allocated, and freed with the exception" );
+}
+
+namespace
+{
+    // Seen by the optimiser as used, so a new and delete pair through it
+    // can't be elided
+    int* volatile allocationSink = NULL;
+}
+
+TEST_CASE( "./succeeding/Misc/allocation assertions", "Counts the allocations made in a block" )
+{
+    int total = 0;
+    CHECK_NO_ALLOC
+    {
+        for( int i = 0; i < 10; ++i )
+            total += i;
+    }
+    REQUIRE( total == 45 );
+
+    REQUIRE_ALLOCATIONS( <=, 1 )
+    {
+        std::vector<char> v( 10 );
+    }
+    CHECK_ALLOCATIONS( ==, 2 )
+    {
+        std::auto_ptr<int> p1( allocationSink = new int( 1 ) );
+        std::auto_ptr<int> p2( allocationSink = new int( 2 ) );
+    }
+}
+
+TEST_CASE( "./failing/Misc/allocation assertions", "Allocates where it shouldn't" )
+{
+    CHECK_NO_ALLOC
+    {
+        std::vector<char> v( 10 );
+    }
+    REQUIRE_ALLOCATIONS( <, 2 )
+    {
+        std::vector<char> v1( 10 );
+        std::vector<char> v2( 10 );
+    }
+    FAIL( "Not reached" );
+}
+
+// Only run by meta/Misc/Resources, with process usage recorded
+TEST_CASE( "./resources/Misc/descriptors", "Leaves a file open" )
+{
+    static std::FILE* leaked = std::tmpfile();
+    REQUIRE( leaked != NULL );
+}
+
+// Only run by meta/Misc/Timeout. Each of these would hang for a minute
+TEST_CASE_TIMEOUT( "./timeout/Misc/own timeout", "Outlives a timeout of its own", 0.2 )
+{
+    Catch::sleepFor( 60000 );
+}
+
+TEST_CASE( "./timeout/Misc/command line timeout", "Outlives the timeout from the command line" )
+{
+    Catch::sleepFor( 60000 );
+}
+
+TEST_CASE( "./timeout/Misc/generators", "One combination outlives the timeout from the command line" )
+{
+    using namespace Catch::Generators;
+    int i = GENERATE( between( 1, 4 ) );
+    if( i == 3 )
+        Catch::sleepFor( 60000 );
+    REQUIRE( i != 3 );
+}
+
+TEST_CASE_TIMEOUT( "./timeout/Misc/in time", "Finishes within its timeout", 10 )
+{
+    REQUIRE( true );
+}
+
+// Only run by meta/Misc/TimeoutUnstoppable. Spinning, it never reaches a point
+// where it could be cancelled, so it runs on until the meta test releases it
+volatile bool unstoppableReleased = false;
+
+TEST_CASE( "./unstoppable/Misc/spins", "Outlives the timeout from the command line, and can't be stopped" )
+{
+    while( !unstoppableReleased )
+    {
+    }
+}
+
+TEST_CASE( "./unstoppable/Misc/not run", "Would run after a test whose thread is still running" )
+{
+    REQUIRE( true );
+}
+
+// Only run by meta/Misc/Abort
+TEST_CASE( "./abort/Misc/checks", "Fails three CHECKs" )
+{
+    CHECK( false );
+    CHECK( false );
+    CHECK( false );
+}
+
+TEST_CASE( "./abort/Misc/after", "Fails a CHECK" )
+{
+    CHECK( false );
+}
+
+TEST_CASE( "./abort/Misc/generators", "Fails in most combinations" )
+{
+    using namespace Catch::Generators;
+    int i = GENERATE( between( 1, 20 ) );
+    CHECK( i < 4 );
+}
+
+TEST_CASE( "./repeat/Misc/flaky", "Fails every third time it is run" )
+{
+    static int runs = 0;
+    CHECK( ( ++runs % 3 ) != 0 );
+}
+
+namespace
+{
+    Catch::Mutex stressMutex;
+    std::size_t stressCounter = 0;
+}
+
+STRESS_TEST_CASE( "./stress/Misc/counter", "Threads increment a shared counter under a lock", 4, 250 )
+{
+    std::size_t before = 0;
+    std::size_t after = 0;
+    {
+        Catch::ScopedLock lock( stressMutex );
+        before = stressCounter++;
+        after = stressCounter;
+    }
+    CHECK( after == before + 1 );
+}
+
+STRESS_TEST_CASE( "./stress/Misc/failing", "Every iteration on every thread fails", 4, 10 )
+{
+    int zero = 0;
+    CHECK( zero == 1 );
+}
+
+STRESS_TEST_CASE( "./stress/Misc/require", "The first failed REQUIRE stops every thread", 4, 1000000 )
+{
+    int zero = 0;
+    REQUIRE( zero == 1 );
+}
+
+STRESS_TEST_CASE_FOR( "./stress/Misc/timed", "Threads run until the time is up", 2, 0.05 )
+{
+    int zero = 0;
+    CHECK( zero == 0 );
+}
+
+namespace
+{
+    struct UnsafeIncrement : Catch::IRunnable
+    {
+        explicit UnsafeIncrement( Catch::Interleaved<int>& value_ ) : value( value_ ) {}
+
+        virtual void run()
+        {
+            int read = value.load();
+            value.store( read + 1 );
+        }
+
+        Catch::Interleaved<int>& value;
+    };
+
+    struct AtomicIncrement : Catch::IRunnable
+    {
+        explicit AtomicIncrement( Catch::Interleaved<int>& value_ ) : value( value_ ) {}
+
+        virtual void run()
+        {
+            value.fetchAdd( 1 );
+        }
+
+        Catch::Interleaved<int>& value;
+    };
+
+    struct LockedIncrement : Catch::IRunnable
+    {
+        LockedIncrement( Catch::InterleavedMutex& mutex_, int& value_ ) : mutex( mutex_ ), value( value_ ) {}
+
+        virtual void run()
+        {
+            Catch::InterleavedMutex::Lock lock( mutex );
+            int read = value;
+            CATCH_YIELD();
+            value = read + 1;
+        }
+
+        Catch::InterleavedMutex& mutex;
+        int& value;
+    };
+
+    struct LockBoth : Catch::IRunnable
+    {
+        LockBoth( Catch::InterleavedMutex& first_, Catch::InterleavedMutex& second_ ) : first( first_ ), second( second_ ) {}
+
+        virtual void run()
+        {
+            Catch::InterleavedMutex::Lock firstLock( first );
+            Catch::InterleavedMutex::Lock secondLock( second );
+        }
+
+        Catch::InterleavedMutex& first;
+        Catch::InterleavedMutex& second;
+    };
+}
+
+INTERLEAVING_TEST_CASE( "./interleaving/Misc/lost update", "A read-modify-write that isn't atomic can lose an update", 100 )
+{
+    Catch::Interleaved<int> value( 0 );
+    UnsafeIncrement first( value );
+    UnsafeIncrement second( value );
+    Catch::Interleaving::run( first, second );
+    CHECK( value.load() == 2 );
+}
+
+INTERLEAVING_TEST_CASE( "./interleaving/Misc/atomic", "An atomic increment never loses an update", 100 )
+{
+    Catch::Interleaved<int> value( 0 );
+    AtomicIncrement first( value );
+    AtomicIncrement second( value );
+    AtomicIncrement third( value );
+    Catch::Interleaving::run( first, second, third );
+    CHECK( value.load() == 3 );
+}
+
+INTERLEAVING_TEST_CASE( "./interleaving/Misc/locked", "An increment under a lock never loses an update", 100 )
+{
+    Catch::InterleavedMutex mutex;
+    int value = 0;
+    LockedIncrement first( mutex, value );
+    LockedIncrement second( mutex, value );
+    Catch::Interleaving::run( first, second );
+    CHECK( value == 2 );
+}
+
+INTERLEAVING_TEST_CASE( "./interleaving/Misc/deadlock", "Locking two mutexes in opposite orders can deadlock", 100 )
+{
+    Catch::InterleavedMutex a;
+    Catch::InterleavedMutex b;
+    LockBoth first( a, b );
+    LockBoth second( b, a );
+    Catch::Interleaving::run( first, second );
+}
+
+namespace
+{
+    struct AppendTo
+    {
+        void operator()() const { log->push_back( value ); }
+
+        std::vector<int>* log;
+        int value;
+    };
+
+    struct CheckOrder
+    {
+        void operator()() const
+        {
+            REQUIRE( log->size() == 3 );
+            CHECK( (*log)[0] == 1 );
+            CHECK( (*log)[1] == 2 );
+            CHECK( (*log)[2] == 3 );
+        }
+
+        const std::vector<int>* log;
+    };
+
+    // How many tests have started waiting and not finished yet, which is
+    // reported as a warning as each wait ends
+    int waiting = 0;
+
+    struct CheckEqual
+    {
+        void operator()() const
+        {
+            WARN( waiting );
+            --waiting;
+            CHECK( actual == expected );
+        }
+
+        int actual;
+        int expected;
+    };
+
+    struct Throw
+    {
+        void operator()() const { throw std::domain_error( "thrown from a callback" ); }
+    };
+
+    struct Unreachable
+    {
+        void operator()() const { FAIL( "still ran after the test had failed" ); }
+    };
+}
+
+// Only run by meta/Misc/Async
+ASYNC_TEST_CASE( "./async/Misc/timers", "Callbacks run in the order they're due", test )
+{
+    static std::vector<int> log;
+    log.clear();
+    AppendTo third = { &log, 3 };
+    AppendTo first = { &log, 1 };
+    AppendTo second = { &log, 2 };
+    CheckOrder check = { &log };
+    test.after( 30, third );
+    test.post( first );
+    test.after( 10, second );
+    test.after( 40, check );
+}
+
+ASYNC_TEST_CASE( "./async/Misc/passing", "Waits alongside ./async/Misc/failing", test )
+{
+    CheckEqual check = { 1, 1 };
+    ++waiting;
+    test.after( 200, check );
+}
+
+ASYNC_TEST_CASE( "./async/Misc/failing", "Waits alongside ./async/Misc/passing", test )
+{
+    CheckEqual check = { 1, 2 };
+    ++waiting;
+    test.after( 200, check );
+}
+
+ASYNC_TEST_CASE( "./async/Misc/throws", "Ends once a callback throws", test )
+{
+    test.post( Throw() );
+    test.after( 10, Unreachable() );
+}
+
+namespace
+{
+    // Counts how many times it's been stringified
+    struct Polled
+    {
+        explicit Polled( int value_ ) : value( value_ ) {}
+        bool operator == ( const Polled& other ) const { return value == other.value; }
+
+        int value;
+        static int streamed;
+    };
+    int Polled::streamed = 0;
+
+    std::ostream& operator << ( std::ostream& os, const Polled& polled )
+    {
+        ++Polled::streamed;
+        return os << polled.value;
+    }
+}
+
+// Only run by meta/Misc/Eventually
+TEST_CASE( "./eventually/Misc/passing", "Passes on the third evaluation" )
+{
+    int polls = 0;
+    CHECK_WITHIN( ++polls == 3, 1 );
+    REQUIRE( polls == 3 );
+}
+
+TEST_CASE( "./eventually/Misc/failing", "Never passes, and is only stringified once" )
+{
+    Polled::streamed = 0;
+    Polled polled( 1 );
+    CHECK_WITHIN( polled == Polled( 2 ), 0.05 );
+    CHECK( Polled::streamed == 2 );
+}
+
+TEST_CASE( "./eventually/Misc/require", "Stops the test case once the deadline passes" )
+{
+    int polls = 0;
+    REQUIRE_WITHIN( polls++ < 0, 0 );
+    FAIL( "not reached" );
+}
+
+namespace
+{
+    template<int Id>
+    struct CountedFixture
+    {
+        CountedFixture() : value( 42 ) { ++constructed; }
+        ~CountedFixture() { ++destroyed; }
+
+        int value;
+        static int constructed;
+        static int destroyed;
+    };
+    template<int Id> int CountedFixture<Id>::constructed = 0;
+    template<int Id> int CountedFixture<Id>::destroyed = 0;
+
+    Catch::SharedFixture<CountedFixture<1> > runFixture( Catch::FixtureScope::Run );
+    Catch::SharedFixture<CountedFixture<2> > groupFixture( Catch::FixtureScope::Group );
+}
+
+// Only run by meta/Misc/SharedFixtures
+TEST_CASE( "./fixtures/Misc/first", "Uses the shared fixtures" )
+{
+    CHECK( runFixture.get().value == 42 );
+    CHECK( groupFixture->value == 42 );
+}
+
+TEST_CASE( "./fixtures/Misc/second", "Uses the same shared fixtures, without setting them up again" )
+{
+    CHECK( runFixture.get().value == 42 );
+    CHECK( groupFixture->value == 42 );
+    CHECK( ( CountedFixture<1>::constructed - CountedFixture<1>::destroyed ) == 1 );
+    CHECK( ( CountedFixture<2>::constructed - CountedFixture<2>::destroyed ) == 1 );
+}
+
+// Only run by meta/Misc/SectionOutput
+TEST_CASE( "./captured/Misc/Sections", "Writes to stdout in and out of sections" )
+{
+    std::cout << "before ";
+    SECTION( "s1", "" )
+    {
+        std::cout << "in s1";
+    }
+    SECTION( "s2", "" )
+    {
+        std::cout << "in s2";
+    }
+}
+
 const char* makeString( bool makeNull ) 
 {
     return makeNull ? NULL : "valid string";
@@ -11,10 +11,14 @@
  */
 
 #define CATCH_CONFIG_MAIN
+#define CATCH_CONFIG_COUNT_ALLOCATIONS
 #include "catch.hpp"
 
 
 #include "catch_self_test.hpp"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
 
 TEST_CASE( "selftest/main", "Runs all Catch self tests and checks their results" )
 {
@@ -47,7 +51,7 @@ TEST_CASE( "selftest/main", "Runs all Catch self tests and checks their results"
                     "Number of 'succeeding' tests is fixed" )
         {
             runner.runMatching( "./succeeding/*" );
-            CHECK( runner.getSuccessCount() == 231 );
+            CHECK( runner.getSuccessCount() == 1025 );
             CHECK( runner.getFailureCount() == 0 );
         }
 
@@ -56,7 +60,7 @@ TEST_CASE( "selftest/main", "Runs all Catch self tests and checks their results"
         {
             runner.runMatching( "./failing/*" );        
             CHECK( runner.getSuccessCount() == 0 );
-            CHECK( runner.getFailureCount() == 60 );
+            CHECK( runner.getFailureCount() == 61 );
         }
     }
 }
@@ -70,3 +74,968 @@ TEST_CASE( "meta/Misc/Sections", "looped tests" )
     CHECK( runner.getFailureCount() == 1 );
     
 }
+
+TEST_CASE( "meta/Misc/Async", "asynchronous tests wait alongside each other, and are reported one by one" )
+{
+    Catch::JsonlRunner runner;
+    runner.runMatching( "./async/Misc/*" );
+    CHECK( runner.getFailureCount() == 2 );
+
+    Catch::ReportedEvent timers = runner.find( "testCaseEnded", "./async/Misc/timers" );
+    CHECK( timers["succeeded"] == "4" );
+    CHECK( timers["failed"] == "0" );
+    Catch::ReportedEvent passing = runner.find( "testCaseEnded", "./async/Misc/passing" );
+    CHECK( passing["succeeded"] == "1" );
+    CHECK( passing["failed"] == "0" );
+    Catch::ReportedEvent failing = runner.find( "testCaseEnded", "./async/Misc/failing" );
+    CHECK( failing["succeeded"] == "0" );
+    CHECK( failing["failed"] == "1" );
+    Catch::ReportedEvent throws = runner.find( "testCaseEnded", "./async/Misc/throws" );
+    CHECK( throws["succeeded"] == "0" );
+    CHECK( throws["failed"] == "1" );
+    CHECK( runner.findMessage( "thrown from a callback" ) != "" );
+
+    // Both 200ms waits had started before the first of them ended
+    CHECK( runner.find( "result", "message", "2" )["macro"] == "WARN" );
+}
+
+TEST_CASE( "meta/Misc/Eventually", "polling assertions report the evaluations they took" )
+{
+    SECTION( "passing", "" )
+    {
+        Catch::EmbeddedRunner runner;
+        runner.runMatching( "./eventually/Misc/passing" );
+        CHECK( runner.getSuccessCount() == 2 );
+        CHECK( runner.getFailureCount() == 0 );
+    }
+    SECTION( "failing", "" )
+    {
+        Catch::JsonlRunner runner;
+        runner.config().setIncludeWhat( Catch::Config::Include::SuccessfulResults );
+        runner.runMatching( "./eventually/Misc/*" );
+        CHECK( runner.getFailureCount() == 2 );
+        CHECK( runner.findMessage( "passed after 3 evaluation(s)" ) != "" );
+        CHECK( runner.find( "result", "expression", "polls++ < 0" )["message"] == "still failing after 1 evaluation(s) in 0 ms" );
+
+        Catch::ReportedEvent polled = runner.find( "result", "expression", "polled == Polled( 2 )" );
+        CHECK( polled["expanded"] == "1 == 2" );
+        std::size_t evaluations = 0;
+        std::istringstream( polled["message"].substr( std::strlen( "still failing after " ) ) ) >> evaluations;
+        CHECK( evaluations > 2 );
+    }
+}
+
+TEST_CASE( "meta/Misc/Stress", "assertions from every thread of a stress test are counted" )
+{
+    SECTION( "counter", "" )
+    {
+        Catch::EmbeddedRunner runner;
+        runner.runMatching( "./stress/Misc/counter" );
+        CHECK( runner.getSuccessCount() == 4*250 + 1 );
+        CHECK( runner.getFailureCount() == 0 );
+    }
+    SECTION( "failing", "" )
+    {
+        Catch::JsonlRunner runner;
+        runner.runMatching( "./stress/Misc/failing" );
+        CHECK( runner.getFailureCount() == 4*10 );
+        CHECK( runner.find( "result", "message", "(on thread 4 of 4)" )["expanded"] == "0 == 1" );
+
+        std::string summary = runner.findMessage( "4 thread(s) ran 40 iteration(s)" );
+        CHECK( summary != "" );
+        CHECK( summary.find( "iterations per thread: 10, 10, 10, 10" ) != std::string::npos );
+    }
+    SECTION( "require", "" )
+    {
+        Catch::EmbeddedRunner runner;
+        runner.runMatching( "./stress/Misc/require" );
+        CHECK( runner.getFailureCount() >= 1 );
+        CHECK( runner.getFailureCount() <= 4 );
+        CHECK( runner.getOutput().find( "4 thread(s) ran 0 iteration(s)" ) != std::string::npos );
+    }
+    SECTION( "timed", "" )
+    {
+        Catch::EmbeddedRunner runner;
+        runner.runMatching( "./stress/Misc/timed" );
+        CHECK( runner.getSuccessCount() > 2 );
+        CHECK( runner.getFailureCount() == 0 );
+    }
+}
+
+namespace
+{
+    // The message a property's falsification was reported with, which ends
+    // with the counterexample
+    std::string runProperty
+    (
+        const std::string& property,
+        const std::string& counterExample,
+        unsigned int rngSeed,
+        unsigned int propertySeed
+    )
+    {
+        Catch::JsonlRunner runner;
+        if( rngSeed != 0 )
+        {
+            runner.config().setOrder( Catch::Config::Order::Randomised );
+            runner.config().setRngSeed( rngSeed );
+        }
+        runner.config().setPropertySeed( propertySeed );
+        runner.runMatching( property );
+        return runner.findMessage( "counterexample: " + counterExample + "\"" );
+    }
+}
+
+TEST_CASE( "meta/Misc/Property", "failing properties shrink to the smallest counterexample, and their seed replays them" )
+{
+    Catch::JsonlRunner runner;
+    runner.runMatching( "./failing/property/int" );
+    runner.runMatching( "./failing/property/vector" );
+    CHECK( runner.findMessage( "counterexample: 100\"" ) != "" );
+    CHECK( runner.find( "result", "expression", "i < 100" )["expanded"] == "100 < 100" );
+    CHECK( runner.findMessage( "counterexample: { 0, 0, 0 }\"" ) != "" );
+    CHECK( runner.find( "result", "expression", "v.size() < 3" )["expanded"] == "3 < 3" );
+
+    // Shuffled by a random order, then replayed from the seed it reported
+    std::string failure = runProperty( "./failing/property/int", "100", 1234, 0 );
+    std::string::size_type pos = failure.find( "replay it with --property-seed " );
+    REQUIRE( pos != std::string::npos );
+    unsigned int seed = 0;
+    std::istringstream( failure.substr( pos + std::strlen( "replay it with --property-seed " ) ) ) >> seed;
+    REQUIRE( seed != 0 );
+
+    CHECK( runProperty( "./failing/property/int", "100", 0, seed ) == failure );
+}
+
+TEST_CASE( "meta/Misc/PropertySections", "a property with a SECTION fails, rather than running one of them each time" )
+{
+    Catch::JsonlRunner runner;
+    runner.runMatching( "./sections/property/int" );
+    CHECK( runner.getSuccessCount() == 0 );
+    CHECK( runner.getFailureCount() == 1 );
+    CHECK( runner.findMessage( "a PROPERTY can't have SECTIONs" ) != "" );
+    CHECK( runner.find( "sectionStarted", "non-negative" ).empty() );
+}
+
+TEST_CASE( "meta/Misc/Interleaving", "schedules are explored until one fails, which can then be replayed" )
+{
+    using namespace Catch;
+
+    SECTION( "lost update", "" )
+    {
+        JsonlRunner runner;
+        runner.runMatching( "./interleaving/Misc/lost update" );
+        CHECK( runner.getFailureCount() == 1 );
+
+        std::string failure = runner.findMessage( "replay it with --schedule " );
+        std::string::size_type pos = failure.find( "replay it with --schedule " );
+        REQUIRE( pos != std::string::npos );
+        unsigned int seed = 0;
+        std::istringstream( failure.substr( pos + std::strlen( "replay it with --schedule " ) ) ) >> seed;
+        REQUIRE( seed != 0 );
+
+        JsonlRunner replayed;
+        replayed.config().setScheduleSeed( seed );
+        replayed.runMatching( "./interleaving/Misc/lost update" );
+        CHECK( replayed.getFailureCount() == 1 );
+        CHECK( replayed.find( "result", "expression", "value.load() == 2" )["expanded"] == "1 == 2" );
+        CHECK( replayed.findMessage( "replay it with" ) == "" );
+    }
+    SECTION( "atomic and locked", "" )
+    {
+        EmbeddedRunner runner;
+        runner.runMatching( "./interleaving/Misc/atomic" );
+        runner.runMatching( "./interleaving/Misc/locked" );
+        CHECK( runner.getFailureCount() == 0 );
+    }
+    SECTION( "deadlock", "" )
+    {
+        EmbeddedRunner runner;
+        runner.runMatching( "./interleaving/Misc/deadlock" );
+        CHECK( runner.getFailureCount() == 1 );
+        CHECK( runner.getOutput().find( "Deadlock" ) != std::string::npos );
+    }
+}
+
+namespace
+{
+    struct Outer
+    {
+        Outer() { trace().push_back( "+outer" ); }
+        ~Outer() { trace().push_back( "-outer" ); }
+
+        static std::vector<std::string>& trace()
+        {
+            static std::vector<std::string> t;
+            return t;
+        }
+    };
+    struct Inner
+    {
+        Inner() { Outer::trace().push_back( "+inner" ); }
+        ~Inner() { Outer::trace().push_back( "-inner" ); }
+    };
+    struct PerWorker
+    {
+        PerWorker() { Outer::trace().push_back( "+worker" ); }
+        ~PerWorker() { Outer::trace().push_back( "-worker" ); }
+    };
+}
+
+TEST_CASE( "meta/Misc/SharedFixtures", "shared fixtures are set up once, and torn down as their scope ends" )
+{
+    using namespace Catch;
+
+    Catch::EmbeddedRunner runner;
+    runner.runMatching( "./fixtures/Misc/*" );
+    CHECK( runner.getSuccessCount() == 6 );
+    CHECK( runner.getFailureCount() == 0 );
+
+    std::vector<std::string>& trace = Outer::trace();
+    trace.clear();
+    SharedFixture<Outer> outer( FixtureScope::Run );
+    SharedFixture<Inner> inner( FixtureScope::Group );
+    SharedFixture<PerWorker> perWorker( FixtureScope::Worker );
+
+    outer.get();
+    inner.get();
+    inner.get();
+    REQUIRE( trace.size() == 2 );
+
+    SharedFixtures::endScope( FixtureScope::Group );
+    REQUIRE( trace.size() == 3 );
+    CHECK( trace[2] == "-inner" );
+    CHECK_FALSE( inner.isSetUp() );
+    CHECK( outer.isSetUp() );
+
+    perWorker.get();
+    {
+        // As a worker process starts: it sets up its own worker scoped
+        // fixture, and leaves the parent's run scoped one alone
+        SharedFixtures::WorkerScope workerScope;
+        CHECK_FALSE( perWorker.isSetUp() );
+        CHECK( outer.isSetUp() );
+        perWorker.get();
+        inner.get();
+    }
+    REQUIRE( trace.size() == 8 );
+    CHECK( trace[4] == "+worker" );
+    CHECK( trace[6] == "-inner" );
+    CHECK( trace[7] == "-worker" );
+    CHECK( outer.isSetUp() );
+
+    SharedFixtures::endAll();
+    REQUIRE( trace.size() == 9 );
+    CHECK( trace[8] == "-outer" );
+    CHECK_FALSE( outer.isSetUp() );
+}
+
+// Counted by ./succeeding/Fixture/resetCase's fixture, in ClassTests.cpp
+extern int resettableFixtureConstructions;
+extern int resettableFixtureResets;
+
+TEST_CASE( "meta/Misc/FixturePool", "a fixture with a reset() is constructed once, then reset for each later invocation, outside of any allocation count" )
+{
+    using namespace Catch;
+
+    // Starts from an empty pool
+    SharedFixtures::endScope( FixtureScope::Worker );
+    resettableFixtureConstructions = 0;
+    resettableFixtureResets = 0;
+
+    JsonlRunner runner;
+    runner.config().setCountAllocations( true );
+    runner.runMatching( "./succeeding/Fixture/resetCase" );
+    CHECK( runner.getSuccessCount() == 6 );
+    CHECK( runner.getFailureCount() == 0 );
+    CHECK( runner.findMessage( "leaked" ) == "" );
+    CHECK( resettableFixtureConstructions == 1 );
+    CHECK( resettableFixtureResets == 2 );
+
+    runner.runMatching( "./succeeding/Fixture/resetCase" );
+    CHECK( runner.getFailureCount() == 0 );
+    CHECK( resettableFixtureConstructions == 1 );
+    CHECK( resettableFixtureResets == 5 );
+
+    // Torn down with the pool, then constructed again
+    SharedFixtures::endScope( FixtureScope::Worker );
+    runner.runMatching( "./succeeding/Fixture/resetCase" );
+    CHECK( runner.getFailureCount() == 0 );
+    CHECK( resettableFixtureConstructions == 2 );
+    CHECK( resettableFixtureResets == 7 );
+}
+
+namespace
+{
+    // Collects what's written to it, but can't seek - like a pipe
+    class UnseekableBuffer : public std::streambuf
+    {
+    public:
+        std::string str() const { return m_str; }
+
+    private:
+        virtual int overflow( int c )
+        {
+            if( c != EOF )
+                m_str += static_cast<char>( c );
+            return c;
+        }
+
+        std::string m_str;
+    };
+
+    std::string runStreamingJunit
+    (
+        std::streambuf* buffer,
+        const std::ostringstream* oss
+    )
+    {
+        Catch::Config config;
+        config.setStreamBuf( buffer );
+        config.setReporter( "junit-streaming" );
+        {
+            // A group per test spec, as Catch::Main does
+            const char* specs[] = { "./mixed/*", "./failing/exceptions/implicit" };
+            Catch::Runner runner( config );
+            for( std::size_t i = 0; i < 2; ++i )
+            {
+                std::size_t prevSuccesses = runner.getSuccessCount();
+                std::size_t prevFailures = runner.getFailureCount();
+                config.getReporter()->StartGroup( specs[i] );
+                runner.runMatching( specs[i] );
+                config.getReporter()->EndGroup( specs[i], runner.getSuccessCount() - prevSuccesses, runner.getFailureCount() - prevFailures );
+            }
+        }
+        return oss ? oss->str() : static_cast<UnseekableBuffer*>( buffer )->str();
+    }
+}
+
+TEST_CASE( "meta/Misc/JunitStreaming", "each testsuite's counts are filled in if the output can seek, and summarised after it if not" )
+{
+    SECTION( "seekable", "" )
+    {
+        std::ostringstream oss;
+        std::string report = runStreamingJunit( oss.rdbuf(), &oss );
+        CHECK( report.find( "<testsuite name=\"./mixed/*\" errors=\"0000000000\" failures=\"0000000010\" tests=\"0000000016\" hostname=" ) != std::string::npos );
+        CHECK( report.find( "<testsuite name=\"./failing/exceptions/implicit\" errors=\"0000000001\" failures=\"0000000000\" tests=\"0000000001\" hostname=" ) != std::string::npos );
+        CHECK( report.find( "testsuite-summary" ) == std::string::npos );
+        CHECK( report.find( "</testsuites>" ) != std::string::npos );
+    }
+    SECTION( "unseekable", "" )
+    {
+        UnseekableBuffer buffer;
+        std::string report = runStreamingJunit( &buffer, NULL );
+        CHECK( report.find( "<testsuite name=\"./mixed/*\" hostname=" ) != std::string::npos );
+        CHECK( report.find( "<testsuite-summary errors=\"0\" failures=\"10\" tests=\"16\"/>" ) != std::string::npos );
+        CHECK( report.find( "<testsuite-summary errors=\"1\" failures=\"0\" tests=\"1\"/>" ) != std::string::npos );
+        CHECK( report.find( "</testsuites>" ) != std::string::npos );
+    }
+    SECTION( "outside a test case", "" )
+    {
+        // Nowhere to write them, so they aren't counted either
+        std::ostringstream oss;
+        Catch::Config config;
+        config.setStreamBuf( oss.rdbuf() );
+        config.setReporter( "junit-streaming" );
+        Catch::IReporter& reporter = *config.getReporter();
+        reporter.StartTesting();
+        reporter.StartGroup( "group" );
+        reporter.Result( Catch::ResultInfo( "", Catch::ResultWas::ExplicitFailure, false, "file", 1, "FAIL", "not in a test case" ) );
+        reporter.Result( Catch::ResultInfo( "", Catch::ResultWas::ThrewException, false, "file", 2, "", "not in a test case" ) );
+        reporter.EndGroup( "group", 0, 2 );
+        reporter.EndTesting( 0, 2 );
+        CHECK( oss.str().find( "errors=\"0000000000\" failures=\"0000000000\"" ) != std::string::npos );
+        CHECK( oss.str().find( "not in a test case" ) == std::string::npos );
+    }
+}
+
+TEST_CASE( "meta/Misc/RandomOrder", "a seed reproduces the same order, and runs the same tests" )
+{
+    Catch::EmbeddedRunner declared;
+    Catch::EmbeddedRunner shuffled( 42 );
+    Catch::EmbeddedRunner reshuffled( 42 );
+
+    declared.runMatching( "./succeeding/generators/*" );
+    shuffled.runMatching( "./succeeding/generators/*" );
+    reshuffled.runMatching( "./succeeding/generators/*" );
+
+    CHECK( shuffled.getSuccessCount() == declared.getSuccessCount() );
+    CHECK( shuffled.getFailureCount() == declared.getFailureCount() );
+    CHECK( shuffled.getOutput() == reshuffled.getOutput() );
+    CHECK( shuffled.getOutput().find( "--rng-seed 42" ) != std::string::npos );
+}
+
+TEST_CASE( "meta/Misc/SeedWithOrder", "--rng-seed implies a random order, unless --order is given" )
+{
+    using namespace Catch;
+
+    char exe[] = "selftest", order[] = "--order", decl[] = "decl", rngSeed[] = "--rng-seed", seed[] = "42";
+    {
+        char* argv[] = { exe, rngSeed, seed };
+        Config config;
+        ArgParser( 3, argv, config );
+        CHECK( config.getOrder() == Config::Order::Randomised );
+        CHECK( config.getRngSeed() == 42 );
+    }
+    {
+        char* argv[] = { exe, order, decl, rngSeed, seed };
+        Config config;
+        ArgParser( 5, argv, config );
+        CHECK( config.getOrder() == Config::Order::Declared );
+    }
+    {
+        char* argv[] = { exe, rngSeed, seed, order, decl };
+        Config config;
+        ArgParser( 5, argv, config );
+        CHECK( config.getOrder() == Config::Order::Declared );
+    }
+}
+
+TEST_CASE( "meta/Misc/XmlEncoding", "markup and control characters are encoded" )
+{
+    std::ostringstream oss;
+    {
+        Catch::XmlWriter xml( oss );
+        xml.scopedElement( "Text" )
+            .writeAttribute( "attr", "\"quoted\" & <tagged>" )
+            .writeText( std::string( "bell\a, nul" ) + '\0' + ", tab\t" );
+    }
+    CHECK( oss.str() == "<Text attr=\"&quot;quoted&quot; &amp; &lt;tagged&gt;\">\n"
+                        "  bell\\x07, nul\\x00, tab\t\n"
+                        "</Text>\n" );
+}
+
+TEST_CASE( "meta/Misc/JsonEscaping", "quotes, control characters and invalid UTF-8 are escaped" )
+{
+    std::ostringstream oss;
+    Catch::JsonLineWriter json( oss );
+    json.startObject()
+        .writeField( "text", std::string( "\"q\" \\ line\n, nul" ) + '\0' + ", caf\xc3\xa9, bad\xe9" )
+        .writeField( "count", static_cast<std::size_t>( 3 ) )
+        .writeField( "ok", true )
+        .endObject();
+    CHECK( oss.str() == "{\"text\":\"\\\"q\\\" \\\\ line\\n, nul\\u0000, caf\xc3\xa9, bad\\u00e9\",\"count\":3,\"ok\":true}\n" );
+}
+
+TEST_CASE( "meta/Misc/AsyncReporter", "reporting on a separate thread produces the same report" )
+{
+    using namespace Catch;
+
+    std::string reports[2];
+    for( int async = 0; async < 2; ++async )
+    {
+        std::ostringstream oss;
+        Config config;
+        config.setStreamBuf( oss.rdbuf() );
+        config.setIncludeWhat( Config::Include::SuccessfulResults );
+        config.setReporter( "basic" );
+        if( async )
+            config.setReporter( new AsyncReporter( config, config.releaseReporter(), 256 ) );
+        {
+            Runner runner( config );
+            runner.runMatching( "./mixed/Misc/Sections/*" );
+            runner.runMatching( "./succeeding/conditions/*equality" );
+        }
+        reports[async] = oss.str();
+    }
+    CHECK( reports[1] == reports[0] );
+
+    // Queued events are assigned, so must keep the test case's location
+    JsonlRunner runner;
+    runner.config().setReporter( new AsyncReporter( runner.config(), runner.config().releaseReporter(), 256 ) );
+    runner.runMatching( "./succeeding/Misc/Sections" );
+    CHECK( runner.find( "testCaseStarted", "./succeeding/Misc/Sections" )["filename"] == "MiscTests.cpp" );
+}
+
+TEST_CASE( "meta/Misc/MultipleReporters", "each reporter writes its own report" )
+{
+    using namespace Catch;
+
+    std::ostringstream oss;
+    Config config;
+    config.setStreamBuf( oss.rdbuf() );
+    config.setIncludeWhat( Config::Include::SuccessfulResults );
+    config.setReporter( "basic" );
+    config.setReporter( "xml" );
+    REQUIRE( config.getMessage().empty() );
+    config.setReporter( "xml::foo=bar" );
+    CHECK_FALSE( config.getMessage().empty() );
+    {
+        Runner runner( config );
+        runner.runMatching( "./succeeding/Misc/Sections" );
+    }
+    CHECK( oss.str().find( "[Running: ./succeeding/Misc/Sections]" ) != std::string::npos );
+    CHECK( oss.str().find( "<TestCase name=\"./succeeding/Misc/Sections\">" ) != std::string::npos );
+}
+
+TEST_CASE( "meta/Misc/BinaryLog", "a converted binary log gives the same report as the run" )
+{
+    using namespace Catch;
+
+    std::string reports[2];
+    std::string log;
+    for( int binary = 0; binary < 2; ++binary )
+    {
+        std::ostringstream oss;
+        Config config;
+        config.setStreamBuf( oss.rdbuf() );
+        config.setIncludeWhat( Config::Include::SuccessfulResults );
+        config.setReporter( binary ? "binary" : "basic" );
+        {
+            Runner runner( config );
+            runner.runMatching( "./mixed/Misc/Sections/*" );
+            runner.runMatching( "./succeeding/conditions/*equality" );
+        }
+        if( binary )
+            log = oss.str();
+        else
+            reports[0] = oss.str();
+    }
+
+    std::ostringstream oss;
+    Config config;
+    config.setStreamBuf( oss.rdbuf() );
+    config.setIncludeWhat( Config::Include::SuccessfulResults );
+    config.setReporter( "basic" );
+    BinaryLogReader reader( log );
+    REQUIRE( reader.getError() == "" );
+    reader.replay( *config.getReporter() );
+    CHECK( reader.isComplete() );
+    reports[1] = oss.str();
+
+    CHECK( reports[1] == reports[0] );
+}
+
+TEST_CASE( "meta/Misc/DescriptorCapture", "output written through C stdio is captured too" )
+{
+    Catch::JsonlRunner runner;
+    runner.config().setCapture( Catch::Config::Capture::Descriptors );
+    runner.runMatching( "./captured/Misc/printf,fputs" );
+    Catch::ReportedEvent ended = runner.find( "testCaseEnded", "./captured/Misc/printf,fputs" );
+    CHECK( ended["stdout"] == "Some information from printf" );
+    CHECK( ended["stderr"] == "An error from fputs" );
+}
+
+namespace
+{
+    // Reads back, then removes, the file named in a note about output past
+    // the limit
+    std::string readSpilledOutput
+    (
+        const std::string& output
+    )
+    {
+        std::string::size_type start = output.find( "written to: " );
+        std::string::size_type end = output.find( ']', start );
+        if( start == std::string::npos || end == std::string::npos )
+            return "";
+        std::string filename = output.substr( start + 12, end - start - 12 );
+        std::ifstream file( filename.c_str() );
+        std::ostringstream oss;
+        oss << file.rdbuf();
+        std::remove( filename.c_str() );
+        return oss.str();
+    }
+}
+
+TEST_CASE( "meta/Misc/DescriptorSpill", "output past the limit is kept in its capture file, and the next run captures into a new one" )
+{
+    Catch::JsonlRunner runner;
+    runner.config().setCapture( Catch::Config::Capture::Descriptors );
+    runner.config().setOutputLimit( 10 );
+    runner.runMatching( "./captured/Misc/printf,fputs" );
+    runner.runMatching( "./captured/Misc/printf,fputs" );
+    std::vector<Catch::ReportedEvent> ended = runner.findAll( "testCaseEnded" );
+    REQUIRE( ended.size() == 2 );
+    for( std::size_t i = 0; i < ended.size(); ++i )
+    {
+        CHECK( ended[i]["stdout"].find( "all 28 bytes of this run's output were written to: " ) != std::string::npos );
+        CHECK( readSpilledOutput( ended[i]["stdout"] ) == "Some information from printf" );
+        CHECK( readSpilledOutput( ended[i]["stderr"] ) == "An error from fputs" );
+    }
+}
+
+TEST_CASE( "meta/Misc/SectionOutput", "sections get their own output, the test case gets all of it" )
+{
+    Catch::JsonlRunner runner;
+    runner.runMatching( "./captured/Misc/Sections" );
+    Catch::ReportedEvent s1 = runner.find( "sectionEnded", "s1" );
+    CHECK( s1["succeeded"] == "0" );
+    CHECK( s1["failed"] == "0" );
+    CHECK( s1["stdout"] == "in s1" );
+    CHECK( runner.find( "sectionEnded", "s2" )["stdout"] == "in s2" );
+    CHECK( runner.find( "testCaseEnded", "./captured/Misc/Sections" )["stdout"] == "before in s1before in s2" );
+}
+
+TEST_CASE( "meta/Misc/CapturedOutput", "only the head and tail of long output are kept" )
+{
+    Catch::CapturedOutput unlimited;
+    unlimited.append( "0123456789" );
+    CHECK( unlimited.str() == "0123456789" );
+
+    Catch::CapturedOutput fits( 10 );
+    fits.append( "012" );
+    fits.append( "3456789" );
+    CHECK( fits.str() == "0123456789" );
+
+    Catch::CapturedOutput output( 10 );
+    output.append( "012" );
+    output.append( "3456789ab" );
+    output.append( "c" );
+    output.append( "def" );
+    CHECK( output.str() == "01234\n[... 6 bytes of output omitted ...]\nbcdef" );
+
+    Catch::CapturedOutput big( 10 );
+    big.append( "0123456789abcdefghij" );
+    CHECK( big.str() == "01234\n[... 10 bytes of output omitted ...]\nfghij" );
+}
+
+TEST_CASE( "meta/Misc/Allocations", "allocations are counted per section, and leaks fail the test case" )
+{
+    Catch::JsonlRunner runner;
+    runner.config().setCountAllocations( true );
+    runner.runMatching( "./allocations/Misc/Sections" );
+    CHECK( runner.getFailureCount() == 1 );
+
+    Catch::ReportedEvent allocates = runner.find( "sectionEnded", "allocates" );
+    CHECK( allocates["allocations"] == "1" );
+    CHECK( allocates["deallocations"] == "1" );
+    CHECK( allocates["bytesAllocated"] == "10" );
+    CHECK( allocates["bytesFreed"] == "10" );
+    CHECK( allocates["peakBytes"] == "10" );
+
+    Catch::ReportedEvent frees = runner.find( "sectionEnded", "frees" );
+    CHECK( frees["allocations"] == "0" );
+    CHECK( frees["deallocations"] == "0" );
+    CHECK( frees["bytesAllocated"] == "0" );
+    CHECK( frees["bytesFreed"] == "0" );
+    CHECK( frees["peakBytes"] == "0" );
+
+    CHECK( runner.findMessage( "Test case leaked 1 of its" ) != "" );
+}
+
+TEST_CASE( "meta/Misc/AllocationsFreedElsewhere", "frees made on another thread, or as an exception ends the test case, aren't taken for leaks" )
+{
+    Catch::JsonlRunner runner;
+    runner.config().setCountAllocations( true );
+    runner.runMatching( "./allocations/Misc/freed elsewhere" );
+    runner.runMatching( "./failing/exceptions/*" );
+    CHECK( runner.findMessage( "leaked" ) == "" );
+
+    Catch::ReportedEvent ended = runner.find( "testCaseEnded", "./allocations/Misc/freed elsewhere" );
+    CHECK( ended["succeeded"] == "1" );
+    CHECK( ended["failed"] == "1" );
+    CHECK( ended["allocations"] == ended["deallocations"] );
+    CHECK( ended["bytesAllocated"] == ended["bytesFreed"] );
+}
+
+TEST_CASE( "meta/Misc/Resources", "process resource usage is recorded per test case, and leaked descriptors fail it" )
+{
+    if( !Catch::ProcessUsage::canRecord() )
+        return;
+
+    Catch::JsonlRunner runner;
+    runner.config().setRecordProcessUsage( true );
+    runner.runMatching( "./resources/Misc/descriptors" );
+    CHECK( runner.getFailureCount() == 1 );
+
+    Catch::ReportedEvent ended = runner.find( "testCaseEnded", "./resources/Misc/descriptors" );
+    CHECK( ended.has( "minorFaults" ) );
+    CHECK( ended["descriptorsLeaked"] == "1" );
+    CHECK( runner.findMessage( "Test case left 1 more file descriptor(s) open" ) != "" );
+}
+
+namespace
+{
+    // The events of a trace, one to a line after the opening bracket, each
+    // but the first with a leading comma
+    std::vector<Catch::ReportedEvent> parseTrace
+    (
+        const std::string& report
+    )
+    {
+        std::vector<Catch::ReportedEvent> events;
+        std::istringstream iss( report );
+        std::string line;
+        while( std::getline( iss, line ) )
+        {
+            if( !line.empty() && line[0] == ',' )
+                line = line.substr( 1 );
+            Catch::ReportedEvent event( line );
+            if( !event.empty() )
+                events.push_back( event );
+        }
+        return events;
+    }
+
+    Catch::ReportedEvent findTraceEvent
+    (
+        const std::vector<Catch::ReportedEvent>& events,
+        const std::string& name,
+        const std::string& category
+    )
+    {
+        for( std::size_t i = 0; i < events.size(); ++i )
+        {
+            if( events[i]["name"] == name && events[i]["cat"] == category )
+                return events[i];
+        }
+        return Catch::ReportedEvent();
+    }
+}
+
+TEST_CASE( "meta/Misc/Trace", "the trace reporter writes a span for each test case, section and generator combination" )
+{
+    using namespace Catch;
+
+    std::ostringstream oss;
+    Config config;
+    config.setStreamBuf( oss.rdbuf() );
+    config.setReporter( "trace" );
+    config.setOrder( Config::Order::Randomised );
+    config.setRngSeed( 1234 );
+    {
+        Runner runner( config );
+        runner.runMatching( "./succeeding/Misc/Sections" );
+        runner.runMatching( "./succeeding/generators/1" );
+    }
+    std::string report = oss.str();
+    CHECK( report.substr( 0, 2 ) == "[\n" );
+    CHECK( report.substr( report.size() - 2 ) == "]\n" );
+
+    std::vector<ReportedEvent> events = parseTrace( report );
+    REQUIRE( !events.empty() );
+    CHECK( events[0]["name"] == "process_name" );
+    CHECK( events[0]["ph"] == "M" );
+    CHECK( events[0]["args.name"] == "Catch" );
+    CHECK( events[0]["args.rngSeed"] == "1234" );
+
+    ReportedEvent testCase = findTraceEvent( events, "./succeeding/Misc/Sections", "testCase" );
+    CHECK( testCase["ph"] == "X" );
+    CHECK( testCase["pid"] == "1" );
+    CHECK( testCase["tid"] == "0" );
+    ReportedEvent section = findTraceEvent( events, "s1", "section" );
+    CHECK( section["ph"] == "X" );
+    CHECK( section["tid"] == "0" );
+    ReportedEvent combination = findTraceEvent( events, "combination 1", "generator" );
+    CHECK( combination["ph"] == "X" );
+    CHECK( combination["tid"] == "0" );
+}
+
+TEST_CASE( "meta/Misc/ThreadFailure", "a REQUIRE that fails on a test's own thread is reported once" )
+{
+    using namespace Catch;
+
+    std::ostringstream oss;
+    Config config;
+    config.setStreamBuf( oss.rdbuf() );
+    config.setReporter( "jsonl" );
+    std::size_t failures = 0;
+    {
+        Runner runner( config );
+        runner.runMatching( "./failing/message/info/1" );
+        failures = runner.getFailureCount();
+    }
+    CHECK( failures == 1 );
+    CHECK( oss.str().find( "unhandled exception" ) == std::string::npos );
+}
+
+TEST_CASE( "meta/Misc/Timeout", "test cases that outlive their timeout fail, and the rest carry on" )
+{
+    Catch::JsonlRunner runner;
+    runner.config().setTimeout( 100 );
+    Catch::Timer timer;
+    runner.runMatching( "./timeout/Misc/own timeout" );
+    runner.runMatching( "./timeout/Misc/command line timeout" );
+    runner.runMatching( "./timeout/Misc/in time" );
+    CHECK( timer.getElapsedMicroseconds() < 10000000 );
+    CHECK( runner.getSuccessCount() == 1 );
+    CHECK( runner.getFailureCount() == 2 );
+    CHECK( runner.findMessage( "Test case timed out after 0.2 s" ) != "" );
+    CHECK( runner.findMessage( "Test case timed out after 0.1 s" ) != "" );
+    CHECK( runner.findMessage( "left running" ) == "" );
+#if defined( __GLIBC__ ) || defined( __APPLE__ )
+    CHECK( runner.findMessage( "Backtrace of the test's thread:" ) != "" );
+#endif
+}
+
+extern volatile bool unstoppableReleased;
+
+TEST_CASE( "meta/Misc/TimeoutUnstoppable", "once a timed out test's thread can't be stopped, no more tests are run" )
+{
+    Catch::JsonlRunner runner;
+    runner.config().setTimeout( 100 );
+    runner.runMatching( "./unstoppable/*" );
+    unstoppableReleased = true;
+    CHECK( runner.getTestsRun() == 1 );
+    CHECK( runner.getSuccessCount() == 0 );
+    CHECK( runner.getFailureCount() == 1 );
+    CHECK( runner.findMessage( "Test case timed out after 0.1 s - its thread couldn't be stopped, so no more tests are run in this process" ) != "" );
+    CHECK( runner.find( "testCaseStarted", "./unstoppable/Misc/not run" ).empty() );
+}
+
+namespace
+{
+    // Each test case's name and totals, from its testCaseEnded event
+    std::vector<std::string> runInWorkers
+    (
+        std::size_t workerCount,
+        std::size_t& successes,
+        std::size_t& failures
+    )
+    {
+        Catch::JsonlRunner runner;
+        runner.config().setWorkerCount( workerCount );
+        runner.runMatching( "./succeeding/generators/*" );
+        runner.runMatching( "./abort/Misc/generators" );
+        successes = runner.getSuccessCount();
+        failures = runner.getFailureCount();
+
+        std::vector<std::string> totals;
+        std::vector<Catch::ReportedEvent> ended = runner.findAll( "testCaseEnded" );
+        for( std::size_t i = 0; i < ended.size(); ++i )
+        {
+            totals.push_back( ended[i]["name"] + ": " + ended[i]["succeeded"] + "/" + ended[i]["failed"] );
+        }
+        return totals;
+    }
+}
+
+TEST_CASE( "meta/Misc/Workers", "splitting generator combinations across workers gives the same totals as running them serially" )
+{
+    if( !Catch::canRunWorkers() )
+        return;
+
+    std::size_t serialSuccesses = 0, serialFailures = 0;
+    std::vector<std::string> serial = runInWorkers( 1, serialSuccesses, serialFailures );
+    std::size_t successes = 0, failures = 0;
+    std::vector<std::string> split = runInWorkers( 3, successes, failures );
+
+    CHECK( serialFailures == 17 );
+    CHECK( successes == serialSuccesses );
+    CHECK( failures == serialFailures );
+    REQUIRE( split.size() == 6 );
+    REQUIRE( serial.size() == 6 );
+    for( std::size_t i = 0; i < serial.size(); ++i )
+    {
+        CHECK( split[i] == serial[i] );
+    }
+}
+
+TEST_CASE( "meta/Misc/WorkerTimeout", "a worker process's test case times out in the worker, and the rest of its combinations are skipped" )
+{
+    if( !Catch::canRunWorkers() )
+        return;
+
+    Catch::JsonlRunner runner;
+    runner.config().setTimeout( 100 );
+    runner.config().setWorkerCount( 2 );
+    runner.runMatching( "./timeout/Misc/generators" );
+    CHECK( runner.getFailureCount() == 1 );
+    CHECK( runner.findMessage( "Test case timed out after 0.1 s" ) != "" );
+}
+
+TEST_CASE( "meta/Misc/Abort", "the run stops once enough assertions have failed" )
+{
+    Catch::JsonlRunner runner;
+    runner.config().setAbortAfter( 2 );
+    CHECK( runner.runMatching( "./abort/Misc/*" ) == 1 );
+    CHECK( runner.aborted() );
+    CHECK( runner.getFailureCount() == 2 );
+    CHECK( runner.findAll( "testCaseEnded" ).size() == 1 );
+    CHECK( runner.findAll( "testingEnded" ).size() == 1 );
+}
+
+TEST_CASE( "meta/Misc/AbortWorkers", "aborting cancels the workers, and the report is still well formed" )
+{
+    using namespace Catch;
+    if( !canRunWorkers() )
+        return;
+
+    std::ostringstream oss;
+    Config config;
+    config.setStreamBuf( oss.rdbuf() );
+    config.setAbortAfter( 1 );
+    config.setWorkerCount( 2 );
+    config.setReporter( "xml" );
+    std::size_t failures = 0;
+    {
+        Runner runner( config );
+        runner.runMatching( "./abort/Misc/generators" );
+        failures = runner.getFailureCount();
+    }
+    std::string report = oss.str();
+    CHECK( failures >= 1 );
+    CHECK( failures <= 2 );
+    CHECK( report.find( "did not complete" ) == std::string::npos );
+    CHECK( report.find( "</TestCase>" ) != std::string::npos );
+    CHECK( report.find( "</Catch>" ) != std::string::npos );
+}
+
+TEST_CASE( "meta/Misc/Repeat", "each test case's runs are summarised once the tests have been repeated" )
+{
+    using namespace Catch;
+
+    JsonlRunner runner;
+    runner.config().setRepeat( 6 );
+    runner.config().setOrder( Config::Order::Randomised );
+    runner.config().setRngSeed( 1234 );
+    runner.config().addTestSpec( "./repeat/Misc/flaky" );
+    runner.runRepeatedly();
+    CHECK( runner.getFailureCount() == 2 );
+
+    std::vector<ReportedEvent> groups = runner.findAll( "groupStarted" );
+    REQUIRE( groups.size() == 6 );
+    CHECK( groups[0]["name"] == "Repetition 1 of 6 (--rng-seed 1234)" );
+    CHECK( groups[5]["name"].find( "Repetition 6 of 6 (--rng-seed " ) == 0 );
+
+    ReportedEvent repeated = runner.find( "testCaseRepeated", "./repeat/Misc/flaky" );
+    CHECK( repeated["runs"] == "6" );
+    CHECK( repeated["failedRuns"] == "2" );
+    CHECK( repeated["failedRngSeeds"] != "[]" );
+    CHECK( repeated["failedRngSeeds"].find( "[0" ) != 0 );
+}
+
+TEST_CASE( "meta/Misc/RepeatUntilFail", "repeating until a test case fails stops at the first failure" )
+{
+    Catch::JsonlRunner runner;
+    runner.config().setRepeat( 10 );
+    runner.config().setRepeatUntilFail( true );
+    runner.config().addTestSpec( "./repeat/Misc/flaky" );
+    runner.runRepeatedly();
+    CHECK( runner.getFailureCount() == 1 );
+    CHECK( runner.find( "testCaseRepeated", "./repeat/Misc/flaky" )["failedRuns"] == "1" );
+    CHECK( runner.findAll( "groupStarted" ).size() == 3 );
+}
+
+TEST_CASE( "meta/Misc/RepeatWorkers", "repetitions run in workers are reported in order" )
+{
+    using namespace Catch;
+    if( !canRunWorkers() )
+        return;
+
+    std::ostringstream oss;
+    Config config;
+    config.setStreamBuf( oss.rdbuf() );
+    config.setRepeat( 6 );
+    config.setWorkerCount( 2 );
+    config.addTestSpec( "./repeat/Misc/flaky" );
+    config.setReporter( "xml" );
+    std::size_t failures = 0;
+    {
+        Runner runner( config );
+        runner.runRepeatedly();
+        failures = runner.getFailureCount();
+    }
+    std::string report = oss.str();
+
+    // Each worker runs the test three times, so fails once
+    CHECK( failures == 2 );
+    std::size_t fifth = report.find( "Repetition 5 of 6" );
+    std::size_t sixth = report.find( "Repetition 6 of 6" );
+    CHECK( fifth != std::string::npos );
+    CHECK( sixth != std::string::npos );
+    CHECK( fifth < sixth );
+    CHECK( report.find( "<RepeatedTestCase name=\"./repeat/Misc/flaky\" runs=\"6\" failures=\"2\"" ) != std::string::npos );
+    CHECK( report.find( "</Catch>" ) != std::string::npos );
+}
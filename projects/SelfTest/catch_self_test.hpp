@@ -14,6 +14,11 @@
 
 #include "catch.hpp"
 
+#include <cctype>
+#include <map>
+#include <sstream>
+#include <vector>
+
 namespace Catch
 {
 
@@ -21,8 +26,11 @@ namespace Catch
     {
     public:
         ///////////////////////////////////////////////////////////////////////////
-        EmbeddedRunner
-        ()
+        explicit EmbeddedRunner
+        (
+            unsigned int rngSeed = 0
+        )
+        :   m_rngSeed( rngSeed )
         {
         }
         
@@ -36,6 +44,11 @@ namespace Catch
             Config config;
             config.setStreamBuf( oss.rdbuf() );
             config.setReporter( "basic" );
+            if( m_rngSeed != 0 )
+            {
+                config.setOrder( Config::Order::Randomised );
+                config.setRngSeed( m_rngSeed );
+            }
 
             std::size_t result;
             
@@ -74,11 +87,419 @@ namespace Catch
         }
 
     private:
+        unsigned int m_rngSeed;
         std::size_t m_successes;
         std::size_t m_failures;
         std::string m_output;
     };
 
+    // An event from a JSON Lines report, with each of its fields as text.
+    // A nested object's fields are named after it, as "args.name", and an
+    // array is kept as it was written
+    class ReportedEvent
+    {
+    public:
+        ///////////////////////////////////////////////////////////////////////////
+        ReportedEvent
+        ()
+        {
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        // A line that isn't an object gives an empty event
+        explicit ReportedEvent
+        (
+            const std::string& line
+        )
+        {
+            std::size_t pos = 0;
+            if( !parseObject( line, pos, "" ) )
+                m_fields.clear();
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        bool empty
+        ()
+        const
+        {
+            return m_fields.empty();
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        bool has
+        (
+            const std::string& field
+        )
+        const
+        {
+            return m_fields.find( field ) != m_fields.end();
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        // Empty if the event doesn't have the field
+        std::string operator[]
+        (
+            const std::string& field
+        )
+        const
+        {
+            std::map<std::string, std::string>::const_iterator it = m_fields.find( field );
+            return it == m_fields.end() ? "" : it->second;
+        }
+
+    private:
+        ///////////////////////////////////////////////////////////////////////////
+        static void skipSpace
+        (
+            const std::string& text,
+            std::size_t& pos
+        )
+        {
+            while( pos < text.size() && std::isspace( static_cast<unsigned char>( text[pos] ) ) )
+                ++pos;
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        bool parseObject
+        (
+            const std::string& text,
+            std::size_t& pos,
+            const std::string& prefix
+        )
+        {
+            skipSpace( text, pos );
+            if( pos == text.size() || text[pos] != '{' )
+                return false;
+            ++pos;
+            skipSpace( text, pos );
+            if( pos < text.size() && text[pos] == '}' )
+            {
+                ++pos;
+                return true;
+            }
+            for(;;)
+            {
+                std::string name;
+                skipSpace( text, pos );
+                if( !parseString( text, pos, name ) )
+                    return false;
+                skipSpace( text, pos );
+                if( pos == text.size() || text[pos++] != ':' )
+                    return false;
+                if( !parseValue( text, pos, prefix + name ) )
+                    return false;
+                skipSpace( text, pos );
+                if( pos == text.size() )
+                    return false;
+                if( text[pos++] == '}' )
+                    return true;
+                if( text[pos-1] != ',' )
+                    return false;
+            }
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        bool parseValue
+        (
+            const std::string& text,
+            std::size_t& pos,
+            const std::string& name
+        )
+        {
+            skipSpace( text, pos );
+            if( pos == text.size() )
+                return false;
+            if( text[pos] == '{' )
+                return parseObject( text, pos, name + "." );
+            if( text[pos] == '"' )
+                return parseString( text, pos, m_fields[name] );
+
+            // Numbers, literals and arrays are kept as written
+            std::size_t start = pos;
+            int depth = 0;
+            for( ; pos < text.size(); ++pos )
+            {
+                char c = text[pos];
+                if( c == '"' )
+                {
+                    std::string ignored;
+                    if( !parseString( text, pos, ignored ) )
+                        return false;
+                    --pos;
+                }
+                else if( c == '[' || c == '{' )
+                    ++depth;
+                else if( c == ']' || c == '}' )
+                {
+                    if( depth == 0 )
+                        break;
+                    --depth;
+                }
+                else if( c == ',' && depth == 0 )
+                    break;
+            }
+            std::size_t end = pos;
+            while( end > start && std::isspace( static_cast<unsigned char>( text[end-1] ) ) )
+                --end;
+            m_fields[name] = text.substr( start, end - start );
+            return end > start;
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        static bool parseString
+        (
+            const std::string& text,
+            std::size_t& pos,
+            std::string& value
+        )
+        {
+            if( pos == text.size() || text[pos] != '"' )
+                return false;
+            value.clear();
+            for( ++pos; pos < text.size(); ++pos )
+            {
+                char c = text[pos];
+                if( c == '"' )
+                {
+                    ++pos;
+                    return true;
+                }
+                if( c != '\\' )
+                {
+                    value += c;
+                    continue;
+                }
+                if( ++pos == text.size() )
+                    return false;
+                switch( text[pos] )
+                {
+                    case 'b': value += '\b'; break;
+                    case 'f': value += '\f'; break;
+                    case 'n': value += '\n'; break;
+                    case 'r': value += '\r'; break;
+                    case 't': value += '\t'; break;
+                    case 'u':
+                    {
+                        unsigned int code = 0;
+                        if( pos + 4 >= text.size() || !( std::istringstream( text.substr( pos+1, 4 ) ) >> std::hex >> code ) )
+                            return false;
+                        pos += 4;
+                        if( code < 0x80 )
+                            value += static_cast<char>( code );
+                        else if( code < 0x800 )
+                        {
+                            value += static_cast<char>( 0xc0 | ( code >> 6 ) );
+                            value += static_cast<char>( 0x80 | ( code & 0x3f ) );
+                        }
+                        else
+                        {
+                            value += static_cast<char>( 0xe0 | ( code >> 12 ) );
+                            value += static_cast<char>( 0x80 | ( ( code >> 6 ) & 0x3f ) );
+                            value += static_cast<char>( 0x80 | ( code & 0x3f ) );
+                        }
+                        break;
+                    }
+                    default: value += text[pos]; break;
+                }
+            }
+            return false;
+        }
+
+        std::map<std::string, std::string> m_fields;
+    };
+
+    // Runs tests with the jsonl reporter, and keeps the events it reported.
+    // Each runMatching() has a Runner of its own, so its report is complete
+    // when it returns
+    class JsonlRunner : NonCopyable
+    {
+    public:
+        ///////////////////////////////////////////////////////////////////////////
+        JsonlRunner
+        ()
+        :   m_testsRun( 0 ),
+            m_successes( 0 ),
+            m_failures( 0 ),
+            m_aborting( false )
+        {
+            m_config.setStreamBuf( m_oss.rdbuf() );
+            m_config.setReporter( "jsonl" );
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        // For setting the run's options before it starts
+        Config& config
+        ()
+        {
+            return m_config;
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        std::size_t runMatching
+        (
+            const std::string& rawTestSpec
+        )
+        {
+            std::size_t testsRun = 0;
+            {
+                Runner runner( m_config );
+                testsRun = runner.runMatching( rawTestSpec );
+                finished( runner );
+            }
+            m_testsRun += testsRun;
+            parseReport();
+            return testsRun;
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        // Repeats the config's test specs, as --repeat does
+        void runRepeatedly
+        ()
+        {
+            {
+                Runner runner( m_config );
+                runner.runRepeatedly();
+                finished( runner );
+            }
+            parseReport();
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        std::size_t getTestsRun
+        ()
+        const
+        {
+            return m_testsRun;
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        std::size_t getSuccessCount
+        ()
+        const
+        {
+            return m_successes;
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        std::size_t getFailureCount
+        ()
+        const
+        {
+            return m_failures;
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        // Whether the last run stopped early, as --abort does
+        bool aborted
+        ()
+        const
+        {
+            return m_aborting;
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        const std::vector<ReportedEvent>& getEvents
+        ()
+        const
+        {
+            return m_events;
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        // The first of the events whose field has the value - or an empty one
+        ReportedEvent find
+        (
+            const std::string& event,
+            const std::string& field,
+            const std::string& value
+        )
+        const
+        {
+            for( std::size_t i = 0; i < m_events.size(); ++i )
+            {
+                if( m_events[i]["event"] == event && m_events[i][field] == value )
+                    return m_events[i];
+            }
+            return ReportedEvent();
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        ReportedEvent find
+        (
+            const std::string& event,
+            const std::string& name
+        )
+        const
+        {
+            return find( event, "name", name );
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        std::vector<ReportedEvent> findAll
+        (
+            const std::string& event
+        )
+        const
+        {
+            std::vector<ReportedEvent> events;
+            for( std::size_t i = 0; i < m_events.size(); ++i )
+            {
+                if( m_events[i]["event"] == event )
+                    events.push_back( m_events[i] );
+            }
+            return events;
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        // The first result message that contains the text - or an empty one
+        std::string findMessage
+        (
+            const std::string& text
+        )
+        const
+        {
+            for( std::size_t i = 0; i < m_events.size(); ++i )
+            {
+                std::string message = m_events[i]["message"];
+                if( m_events[i]["event"] == "result" && message.find( text ) != std::string::npos )
+                    return message;
+            }
+            return "";
+        }
+
+    private:
+        ///////////////////////////////////////////////////////////////////////////
+        void finished
+        (
+            const Runner& runner
+        )
+        {
+            m_successes += runner.getSuccessCount();
+            m_failures += runner.getFailureCount();
+            m_aborting = runner.aborting();
+        }
+
+        ///////////////////////////////////////////////////////////////////////////
+        void parseReport
+        ()
+        {
+            std::istringstream lines( m_oss.str() );
+            m_oss.str( "" );
+            for( std::string line; std::getline( lines, line ); )
+            {
+                m_events.push_back( ReportedEvent( line ) );
+            }
+        }
+
+        std::ostringstream m_oss;
+        Config m_config;
+        std::size_t m_testsRun;
+        std::size_t m_successes;
+        std::size_t m_failures;
+        bool m_aborting;
+        std::vector<ReportedEvent> m_events;
+    };
+
     class MetaTestRunner
     {
     public:
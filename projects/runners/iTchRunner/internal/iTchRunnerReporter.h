@@ -93,8 +93,10 @@ namespace Catch
         virtual void EndGroup( const std::string&, std::size_t, std::size_t ){}
         virtual void StartTestCase( const TestCaseInfo& ){}
         virtual void StartSection( const std::string&, const std::string ){}
-        virtual void EndSection( const std::string&, std::size_t, std::size_t ){}
-        virtual void EndTestCase( const TestCaseInfo&, std::size_t, std::size_t, const std::string&, const std::string& ){}
+        virtual void EndSection( const std::string&, std::size_t, std::size_t, const std::string&, const std::string&, const ResourceUsage& ){}
+        virtual void EndGeneratorCombination( std::size_t, std::size_t, std::size_t, const ResourceUsage& ){}
+        virtual void EndTestCase( const TestCaseInfo&, std::size_t, std::size_t, const std::string&, const std::string&, const ResourceUsage& ){}
+        virtual void TestCaseRepeated( const RepeatStats& ){}
         
     private:
         size_t m_succeeded;